@@ -10,13 +10,20 @@
 //################################################################################
 //##    Includes
 //################################################################################
+#include <condition_variable>
+#include <cstdio>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include "../src/3rd_party/handmade_math.h"
 #include "../src/3rd_party/stb/stb_image.h"
+#include "../src/budget.h"
 #include "../src/compare.h"
 #include "../src/imaging.h"
+#include "../src/instrument.h"
 #include "../src/mesh.h"
 #include "../src/types/bitmap.h"
+#include "../src/types/bitmap_view.h"
 #include "../src/types/color.h"
 #include "../src/types/image.h"
 #include "../src/types/rect.h"
@@ -46,6 +53,31 @@
 //##    Local Structs / Defines
 //################################################################################
 #define MAX_FILE_SIZE (2048 * 2048)
+#define MIN_BUFFER_SIZE (64 * 1024)
+
+// Level of Detail
+const float c_field_of_view =       52.5f;          // Vertical field of view, in degrees
+const float c_outline_detail =      0.075f;         // Ramer-Douglas-Peucker epsilon used to outline image, highest quality
+const int   c_extrude_quality =     8;              // Quality used to extrude meshes, highest quality
+const int   c_level_count =         9;              // Number of levels in level of detail chains
+const float c_level_pixel_error =   1.0f;           // Max screen space error (in pixels) allowed when picking level automatically
+const int   c_tile_threshold =      2048;           // Images wider / taller than this are outlined in tiles
+const int   c_tile_size =           512;            // Tile size used to outline large images, in pixels
+
+// Background Builds, every side profile / smooth normals combination (variant) of an image is built in background,
+// variant on screen first, then the rest speculatively so switching is instant. Without threads (emscripten built
+// without pthreads) only the variant on screen is built, at start of frame
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    const bool c_mesh_thread =      false;
+#else
+    const bool c_mesh_thread =      true;
+#endif
+const int   c_variant_count =       6;              // Side_Profile (3) * smooth normals (2)
+
+// Depth
+const float c_min_depth =           0.1f;           // Smallest depth multiplier, keeps depth scale (and normal matrix) invertible
+const float c_profile_size =        0.02f;          // Outward size of bevel / round side profiles, relative to image size
+const float c_crease_angle =        40.f;           // Smooth normals are split across edges sharper than this (in degrees)
 
 enum loadstate_t {
     LOADSTATE_UNKNOWN = 0,
@@ -54,15 +86,62 @@ enum loadstate_t {
     LOADSTATE_FILE_TOO_BIG,
 };
 
+// Gpu buffer that is only recreated when it needs to grow, contents are replaced with sg_update_buffer
+struct gpu_buffer_t {
+    sg_buffer buffer { SG_INVALID_ID };
+    size_t    capacity { 0 };                   // Bytes
+};
+
 struct item_t {
     sapp_event event = { };
 };
 
+// Level of detail chain, one per object
+typedef std::vector<std::vector<DrMeshLevel>> mesh_levels_t;
+
+// Finished background build, handed to frame() through mesh_worker_t::finished
+struct mesh_result_t {
+    long                            image_id        { 0 };      // Image load this result belongs to
+    int                             variant         { 0 };      // Side_Profile * 2 + smooth normals
+    std::shared_ptr<mesh_levels_t>  levels          { };        // Empty for image results (first result of each load)
+    DrPipelineStats                 stats           { };        // Stage timings / counters of build, empty without EXTRUDE_INSTRUMENT
+    long                            image_size      { 0 };
+    std::shared_ptr<stbi_uc>        pixels          { };        // Decoded image for texture, image results only
+    int                             width           { 0 };
+    int                             height          { 0 };
+    std::string                     load_status     { "" };     // Error of a failed load
+};
+
+// Background build thread, the only owner of outlined image
+struct mesh_worker_t {
+    std::thread                     thread;
+    std::mutex                      mutex;                      // Guards members up to 'finished'
+    std::condition_variable         wake;
+    bool                            quit            { false };
+    std::vector<unsigned char>      pending_file    { };        // Image file waiting to be loaded, a newer drop replaces it
+    int                             max_image_size  { 0 };
+    int                             wanted_variant  { 0 };      // Variant on screen, built before anything else
+    bool                            built[c_variant_count] { }; // Variants of current image already finished
+    std::vector<mesh_result_t>      finished        { };        // Back buffer, swapped out by collectMeshes()
+    DrBudget                       *budget          { nullptr };// Work running now, cancelled by a newer image, a variant change or quit
+    int                             running_variant { -1 };     // Variant built under 'budget', -1 while loading an image
+    bool                            running_speculative { false };
+
+    // Worker thread only
+    std::shared_ptr<DrImage>        image           { };
+    long                            image_id        { 0 };
+    bool                            fresh_image     { false };  // Next build keeps outline stage stats of load
+};
+
 struct state_t {
     // Gfx
     sg_pass_action pass_action;
-    sg_pipeline pip;
+    sg_pipeline pip;                    // 16 bit indices
+    sg_pipeline pip_long;               // 32 bit indices
     sg_bindings bind;
+    gpu_buffer_t vertices;
+    gpu_buffer_t short_indices;
+    gpu_buffer_t long_indices;
 
     // Fetch / Drop
     uint8_t file_buffer[MAX_FILE_SIZE];
@@ -88,16 +167,21 @@ sapp_desc   sokol_app;
 state_t     state;
 
 // Holds generated meshes
-std::vector<DrMesh> meshes { };
+DrMeshPack                              mesh_pack       { };        // Meshes currently copied into gpu buffers, one draw per batch
+bool                                    upload_pending  { false };  // Mesh pack changed, copy into gpu buffers at start of next frame
+std::shared_ptr<mesh_levels_t>          mesh_levels     { std::make_shared<mesh_levels_t>() };  // Variant on screen
+std::shared_ptr<mesh_levels_t>          mesh_variants[c_variant_count] { };                     // Finished variants of current image
+std::vector<int>                        selected_levels { };        // Level currently used, one per object
+mesh_worker_t                           mesh_worker     { };
+long                                    mesh_image_id   { 0 };      // Image load meshes belong to, older results are dropped
+mesh_result_t                           mesh_new_image  { };        // Loaded image waiting for its first meshes, texture is swapped with them
 
 // Image Variables
-DrBitmap    bitmap              { };
-DrImage     image               { "None", bitmap };
 long        image_size          { 0 };
 bool        initialized_image   { false };
-bool        recalculate         { false };
 std::string load_status         { "" };
 int         triangles           { 0 };
+DrPipelineStats pipeline_stats  { };                // Stage timings / counters of last rebuild, empty without EXTRUDE_INSTRUMENT
 
 // FPS Variables
 uint64_t time_start     { 0 };
@@ -105,9 +189,9 @@ long ticks              { 0 };
 long fps                { 0 };
 
 // Model Rotation
-int         mesh_quality        { 5 };
-float       level_of_detail     { 100.f };
-float       depth_multiplier    { 1.f };
+int         mesh_quality        { 8 };
+bool        auto_quality        { true };
+float       depth_multiplier    { 1.f };            // Meshes are extruded at depth 1.0, depth is applied as z scale of model matrix
 DrVec2      total_rotation      { 0.f,  0.f };
 DrVec2      add_rotation        { 25.f, 25.f };
 hmm_mat4    model               { Dr::IdentityMatrix() };
@@ -116,12 +200,15 @@ float       rotate_speed        { 1.f };
 bool        is_mouse_down       { false };
 float       zoom                { 1.5f };
 bool        wireframe           { true };
+Side_Profile side_profile       { Side_Profile::Flat };
+bool        smooth_normals      { false };
 
 
 //################################################################################
 //##    Sokol-fetch load callbacks 
 //################################################################################
 static void image_loaded(const sfetch_response_t*);
+static void meshWorkerLoop();
 static void font_normal_loaded(const sfetch_response_t* response) {
     if (response->fetched) {
         state.font_normal = fonsAddFontMem(state.fons, "sans", (unsigned char*)response->buffer_ptr, (int)response->fetched_size,  false);
@@ -153,6 +240,9 @@ void init(void) {
         sokol_fetch.num_lanes =     2;
     sfetch_setup(&sokol_fetch);
 
+    // ***** Background builds
+    if (c_mesh_thread) mesh_worker.thread = std::thread(meshWorkerLoop);
+
     // ***** Font Setup, make sure the fontstash atlas width/height is pow-2 
     state.dpi_scale = sapp_dpi_scale();
     const int atlas_dim = Dr::RoundPowerOf2(512.0f * state.dpi_scale);
@@ -178,7 +268,8 @@ void init(void) {
     sg_buffer_desc sokol_buffer_vertex { };
         sokol_buffer_vertex.data = SG_RANGE(vertices);
         sokol_buffer_vertex.label = "temp-vertices";
-    state.bind.vertex_buffers[0] = sg_make_buffer(&sokol_buffer_vertex);
+    state.vertices.buffer = sg_make_buffer(&sokol_buffer_vertex);
+    state.bind.vertex_buffers[0] = state.vertices.buffer;
 
     // Index buffer
     const uint16_t indices[] = { 0, 1, 2, 0, 2, 3 };
@@ -186,7 +277,8 @@ void init(void) {
         sokol_buffer_index.type = SG_BUFFERTYPE_INDEXBUFFER;
         sokol_buffer_index.data = SG_RANGE(indices);
         sokol_buffer_index.label = "temp-indices";
-    state.bind.index_buffer = sg_make_buffer(&(sokol_buffer_index));
+    state.short_indices.buffer = sg_make_buffer(&(sokol_buffer_index));
+    state.bind.index_buffer = state.short_indices.buffer;
 
     // ***** Blend mode
     sg_blend_state sokol_blend_alpha { };
@@ -215,6 +307,9 @@ void init(void) {
         sokol_pipleine.label = "extrude-pipeline";
         sokol_pipleine.colors[0].blend = sokol_blend_alpha;
     state.pip = sg_make_pipeline(&sokol_pipleine);
+        sokol_pipleine.index_type =     SG_INDEXTYPE_UINT32;
+        sokol_pipleine.label = "extrude-pipeline-long";
+    state.pip_long = sg_make_pipeline(&sokol_pipleine);
 
 
     // ***** Allocate an image handle, 
@@ -271,153 +366,340 @@ void init(void) {
 }
 
 //################################################################################
-//##    Create 3D extrusion
-//################################################################################
-void calculateMesh(bool reset_position) {
-    //##    Level of Detail:
-    //##        0.075 = Detailed
-    //##        0.250 = Nice
-    //##        1.000 = Low poly
-    //##       10.000 = Really low poly
-    float quality_check = level_of_detail;
-    switch (mesh_quality) {
-        case 0: level_of_detail = 19.200f;  break;
-        case 1: level_of_detail =  9.600f;  break;
-        case 2: level_of_detail =  4.800f;  break;
-        case 3: level_of_detail =  2.400f;  break;
-        case 4: level_of_detail =  1.200f;  break;
-        case 5: level_of_detail =  0.600f;  break;
-        case 6: level_of_detail =  0.300f;  break;
-        case 7: level_of_detail =  0.150f;  break;
-        case 8: level_of_detail =  0.075f;  break;
+//##    Copy data into dynamic gpu buffer, buffer is only recreated (with geometric growth) when data doesn't fit
+//##        Sokol allows one update per buffer per frame, only call from uploadMeshes()
+//################################################################################
+static void updateBuffer(gpu_buffer_t &gpu, sg_buffer_type type, const void *data, size_t size, const char *label) {
+    if (size == 0) return;
+    if (size > gpu.capacity) {
+        size_t capacity = Dr::Max(static_cast<size_t>(MIN_BUFFER_SIZE), gpu.capacity);
+        while (capacity < size) capacity *= 2;
+        sg_buffer_desc sokol_buffer { };
+            sokol_buffer.type =  type;
+            sokol_buffer.usage = SG_USAGE_DYNAMIC;
+            sokol_buffer.size =  capacity;
+            sokol_buffer.label = label;
+        sg_destroy_buffer(gpu.buffer);
+        gpu.buffer =   sg_make_buffer(&sokol_buffer);
+        gpu.capacity = capacity;
     }
+    sg_update_buffer(gpu.buffer, sg_range{ data, size });
+}
 
-    // Recalculate image polygons if necessary
-    if (level_of_detail != quality_check) {
-        image.outlinePoints(level_of_detail);
+//################################################################################
+//##    Copy mesh pack into gpu buffers, called once per frame at most
+//################################################################################
+void uploadMeshes() {
+    if (upload_pending == false) return;
+    upload_pending = false;
+    updateBuffer(state.vertices,      SG_BUFFERTYPE_VERTEXBUFFER, mesh_pack.vertices.data(),      mesh_pack.vertices.size()      * sizeof(Vertex),   "extruded-vertices");
+    updateBuffer(state.short_indices, SG_BUFFERTYPE_INDEXBUFFER,  mesh_pack.short_indices.data(), mesh_pack.short_indices.size() * sizeof(uint16_t), "extruded-indices");
+    updateBuffer(state.long_indices,  SG_BUFFERTYPE_INDEXBUFFER,  mesh_pack.long_indices.data(),  mesh_pack.long_indices.size()  * sizeof(uint32_t), "extruded-indices-long");
+    state.bind.vertex_buffers[0] = state.vertices.buffer;
+}
+
+//################################################################################
+//##    Pack meshes of selected levels, draw ranges are cached in mesh_pack.batches
+//##        Packed into 16 bit batches, meshes too big for 16 bit indices get 32 bit batches,
+//##        or are split when backend can't use 32 bit indices (GLES2)
+//################################################################################
+void packMeshes() {
+    bool allow_long_indices = (sg_query_backend() != SG_BACKEND_GLES2);
+    mesh_pack.clear();
+    for (size_t object = 0; object < mesh_levels->size(); object++) {
+        if (selected_levels[object] < 0) continue;
+        mesh_pack.addMesh((*mesh_levels)[object][selected_levels[object]].mesh, allow_long_indices);
     }
+    mesh_pack.finish();
+    triangles = mesh_pack.triangleCount();
+    upload_pending = true;
+}
+
+//################################################################################
+//##    Pick level of detail for each object, packs meshes if selection changed
+//##        Automatic:  coarsest level whose error projects to less than c_level_pixel_error pixels
+//##        Manual:     quality keys 1 - 9, quality 9 is level 0
+//################################################################################
+void selectLevels() {
+    float distance = static_cast<float>(image_size) * zoom;
+    float pixels_per_unit = sapp_heightf() / (2.f * distance * tanf(HMM_ToRadians(c_field_of_view / 2.f)));
+    float depth_scale = Dr::Max(depth_multiplier, 1.f);                         // Deeper than extruded, z error grows with it
+
+    bool changed = (selected_levels.size() != mesh_levels->size());
+    selected_levels.resize(mesh_levels->size(), -1);
+    for (size_t object = 0; object < mesh_levels->size(); object++) {
+        const std::vector<DrMeshLevel> &levels = (*mesh_levels)[object];
+        int level = -1;
+        if (levels.size() > 0) {
+            if (auto_quality) {
+                level = 0;
+                for (int l = 1; l < static_cast<int>(levels.size()); l++) {
+                    if (levels[l].absolute_error * depth_scale * pixels_per_unit <= c_level_pixel_error) level = l;
+                }
+            } else {
+                level = Dr::Min((c_level_count - 1) - mesh_quality, static_cast<int>(levels.size()) - 1);
+            }
+        }
+        if (level != selected_levels[object]) changed = true;
+        selected_levels[object] = level;
+    }
+    if (changed) packMeshes();
+}
+
+//################################################################################
+//##    Background Builds
+//##        Worker thread loads dropped images and extrudes meshes, frame() never waits on it. Superseded work (an
+//##        older image, a variant no longer on screen, speculation while a request waits) is cancelled through its budget.
+//################################################################################
+static int variantIndex(Side_Profile profile, bool smooth) {
+    return static_cast<int>(profile) * 2 + ((smooth) ? 1 : 0);
+}
+
+// True when a build of 'variant' no longer serves the variant on screen, mesh_worker.mutex must be held
+static bool variantSuperseded(int variant, bool speculative) {
+    if (speculative) return (mesh_worker.built[mesh_worker.wanted_variant] == false);
+    return (mesh_worker.wanted_variant != variant);
+}
+
+// Worker side, true when work on 'variant' should stop
+static bool buildSuperseded(int variant, bool speculative) {
+    std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+    if (mesh_worker.quit || mesh_worker.pending_file.size() > 0) return true;
+    return variantSuperseded(variant, speculative);
+}
+
+// Worker side, hands result to frame()
+static void finishResult(mesh_result_t &&result) {
+    std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+    if (result.levels) mesh_worker.built[result.variant] = true;
+    mesh_worker.finished.push_back(std::move(result));
+}
+
+// Worker side, decodes and outlines image file
+static void loadImage(std::vector<unsigned char> &file, int max_size) {
+    Dr::InstrumentReset();
+    mesh_result_t result;
+    int png_width, png_height, num_channels;
+    const int desired_channels = 4;
+    std::shared_ptr<stbi_uc> pixels(stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &png_width, &png_height,
+                                                          &num_channels, desired_channels), stbi_image_free);
+    if (pixels == nullptr) {
+        result.load_status = "Error loading image!";
+        finishResult(std::move(result));
+        return;
+    } else if (png_width > max_size || png_height > max_size) {
+        result.load_status = "Image size too big! Maximum width and height of " + std::to_string(max_size) + " pixels!";
+        finishResult(std::move(result));
+        return;
+    }
+
+    // ********** View decoded pixels in place, image is created and outline traced at native size straight from
+    //            stb buffer (outlining only searches alpha bounds, see DrImage::outlinePoints()), large images in
+    //            tiles. Image keeps no copy of the pixels, texture is made from stb buffer by frame()
+    DrBitmapView decoded(pixels.get(), png_width, png_height);
+    int tile_size = (Dr::Max(png_width, png_height) > c_tile_threshold) ? c_tile_size : 0;
+    std::shared_ptr<DrImage> image = std::make_shared<DrImage>("shapes", decoded, c_outline_detail, true, tile_size);
+
+    // ********** New image replaces old one, all variants have to be built again
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        if (mesh_worker.quit || mesh_worker.pending_file.size() > 0) return;
+        for (auto &built : mesh_worker.built) built = false;
+    }
+    mesh_worker.image = image;
+    mesh_worker.image_id++;
+    mesh_worker.fresh_image = true;
+    result.image_id =   mesh_worker.image_id;
+    result.image_size = Dr::Max(png_width, png_height);
+    result.pixels =     pixels;
+    result.width =      png_width;
+    result.height =     png_height;
+    finishResult(std::move(result));
+}
+
+//################################################################################
+//##    Create 3D extrusion, extrudes each object once at highest quality and depth 1.0,
+//##    then builds a level of detail chain from it. Returns false if build was superseded
+//################################################################################
+static bool buildVariant(int variant, bool speculative) {
+    if (mesh_worker.fresh_image == false) Dr::InstrumentReset();
+    mesh_worker.fresh_image = false;
+    DrImage     &image = *mesh_worker.image;
+    Side_Profile profile = static_cast<Side_Profile>(variant / 2);
+    bool         smooth = (variant % 2) == 1;
 
     // Get max image dimension
-    image_size = Dr::Max(image.getBitmap().width, image.getBitmap().height);
+    mesh_result_t result;
+    result.image_id =   mesh_worker.image_id;
+    result.variant =    variant;
+    result.image_size = Dr::Max(image.getBitmap().width, image.getBitmap().height);
+    result.levels =     std::make_shared<mesh_levels_t>();
 
     // Form new meshes
-    meshes.clear();
-    unsigned int total_vertices = 0;
-    unsigned int total_indices =  0;
-    for (int object = 0; object < image.m_poly_list.size(); object++) {
+    for (int object = 0; object < static_cast<int>(image.m_poly_list.size()); object++) {
+        if (buildSuperseded(variant, speculative)) return false;
         DrMesh mesh {};    
-        mesh.extrudeObjectFromPolygon(&image, object, mesh_quality, (static_cast<float>(image_size) * depth_multiplier));
+        mesh.extrudeObjectFromPolygon(&image, object, c_extrude_quality, static_cast<float>(result.image_size),
+                                      profile, static_cast<float>(result.image_size) * c_profile_size);
+        if (smooth) mesh.generateNormals(c_crease_angle);
         //mesh->initializeTextureQuad(image_size);
         //mesh->initializeTextureCube(image_size);   
-        total_vertices += mesh.vertices.size();
-        total_indices  += mesh.indices.size();
-        meshes.push_back(mesh);
+        result.levels->push_back(mesh.buildLevelsOfDetail(c_level_count));
     }
-    triangles = total_vertices / 3;
-             
-    // ***** Copy vertex data and set into state buffer
-    if (meshes.size() > 0) {
-        std::vector<Vertex>     vertices(total_vertices);
-        std::vector<uint16_t>   indices(total_indices);
-                
-        // ***** Vertex Buffer
-        unsigned long vertex_count = 0;
-        for (int m = 0; m < meshes.size(); m++) {
-            for (unsigned long i = 0; i < meshes[m].vertices.size(); i++) {
-                vertices[vertex_count] = meshes[m].vertices[i];
-                ++vertex_count;
-            }
-        }        
-        sg_buffer_desc sokol_buffer_vertex { };
-            sokol_buffer_vertex.data = sg_range{ &vertices[0], vertices.size() * sizeof(Vertex) };
-            sokol_buffer_vertex.label = "extruded-vertices";
-        sg_destroy_buffer(state.bind.vertex_buffers[0]);
-        state.bind.vertex_buffers[0] = sg_make_buffer(&sokol_buffer_vertex);
-
-        // ***** Index Buffer
-        unsigned long index_count = 0;
-        unsigned long index_offset = 0;
-        for (int m = 0; m < meshes.size(); m++) {
-            for (unsigned long i = 0; i < meshes[m].indices.size(); i++) {
-                indices[index_count] = index_offset + meshes[m].indices[i];
-                ++index_count;
+    if (buildSuperseded(variant, speculative)) return false;           // Last object may have been cut short by cancel
+    result.stats = Dr::InstrumentStats();
+    finishResult(std::move(result));
+    return true;
+}
+
+// Does one piece of work (a load or a build), returns false when there is nothing to do
+static bool meshWorkerStep(bool speculate) {
+    std::vector<unsigned char> file;
+    int  max_size = 0;
+    int  variant = -1;
+    bool speculative = false;
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        if (mesh_worker.quit) return false;
+        if (mesh_worker.pending_file.size() > 0) {
+            file.swap(mesh_worker.pending_file);
+            max_size = mesh_worker.max_image_size;
+        } else if (mesh_worker.image) {
+            if (mesh_worker.built[mesh_worker.wanted_variant] == false) {
+                variant = mesh_worker.wanted_variant;
+            } else if (speculate) {
+                for (int v = 0; v < c_variant_count; v++) {
+                    if (mesh_worker.built[v] == false) { variant = v; speculative = true; break; }
+                }
             }
-            index_offset += meshes[m].vertices.size();
         }
-        sg_buffer_desc sokol_buffer_index { };
-            sokol_buffer_index.type = SG_BUFFERTYPE_INDEXBUFFER;
-            sokol_buffer_index.data = sg_range{ &indices[0], indices.size() * sizeof(uint16_t) };
-            sokol_buffer_index.label = "extruded-indices";
-        sg_destroy_buffer(state.bind.index_buffer);
-        state.bind.index_buffer = sg_make_buffer(&(sokol_buffer_index));
-
+    }
+    if (file.size() == 0 && variant < 0) return false;
+
+    // Newer image or quit cancels this step, outlining / triangulation stop early and result is dropped as superseded
+    DrBudget budget;
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        if (mesh_worker.quit) return false;
+        mesh_worker.budget = &budget;
+        mesh_worker.running_variant = variant;
+        mesh_worker.running_speculative = speculative;
+    }
+    {
+        DrBudgetScope budget_scope(&budget);
+        if (file.size() > 0) loadImage(file, max_size);
+        else                 buildVariant(variant, speculative);
+    }
+    std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+    mesh_worker.budget = nullptr;
+    mesh_worker.running_variant = -1;
+    return true;
+}
 
-        // ***** Reset rotation
-        if (reset_position) {
-            total_rotation.set(0.f, 0.f);
-            add_rotation.set(25.f, 25.f);
-            model = Dr::IdentityMatrix();
+static void meshWorkerLoop() {
+    while (true) {
+        if (meshWorkerStep(true)) continue;
+        std::unique_lock<std::mutex> lock(mesh_worker.mutex);
+        if (mesh_worker.quit) return;
+        bool waiting = (mesh_worker.pending_file.size() > 0);
+        if (mesh_worker.image) {
+            for (auto &built : mesh_worker.built) waiting = waiting || (built == false);
         }
+        if (waiting == false) mesh_worker.wake.wait(lock);
     }
 }
 
+// Main thread, asks worker to load an image file (data is copied, fetch buffer is reused by next load)
+static void requestImage(const void *file_data, size_t file_size) {
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        const unsigned char *bytes = static_cast<const unsigned char*>(file_data);
+        mesh_worker.pending_file.assign(bytes, bytes + file_size);
+        mesh_worker.max_image_size = sg_query_limits().max_image_size_2d;
+        if (mesh_worker.budget) mesh_worker.budget->cancel();
+    }
+    mesh_worker.wake.notify_one();
+}
+
+// Main thread, shows variant of current side profile / normals, from finished variants or once worker has built it
+static void requestMesh() {
+    int variant = variantIndex(side_profile, smooth_normals);
+    if (mesh_variants[variant] && mesh_variants[variant] != mesh_levels) {
+        mesh_levels = mesh_variants[variant];
+        selected_levels.clear();
+        selectLevels();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        mesh_worker.wanted_variant = variant;
+        if (mesh_worker.budget && mesh_worker.running_variant >= 0 &&
+            variantSuperseded(mesh_worker.running_variant, mesh_worker.running_speculative)) mesh_worker.budget->cancel();
+    }
+    mesh_worker.wake.notify_one();
+}
+
 //################################################################################
-//##    Load Image
+//##    Swaps finished builds in, called at start of each frame. Only tries the lock, a busy worker never stalls a frame
 //################################################################################
-static void load_image(stbi_uc *buffer_ptr, int fetched_size) {
-    int png_width, png_height, num_channels;
-    const int desired_channels = 4;
-    stbi_uc* pixels = stbi_load_from_memory(buffer_ptr, fetched_size, &png_width, &png_height, &num_channels, desired_channels);
-
-    // Stb Load Succeeded
-    if (pixels && (png_width <= 2048) && (png_height <= 2048)) {
+static void collectMeshes() {
+    if (c_mesh_thread == false) meshWorkerStep(false);
+
+    std::vector<mesh_result_t> finished;
+    {
+        std::unique_lock<std::mutex> lock(mesh_worker.mutex, std::try_to_lock);
+        if (lock.owns_lock() == false) return;
+        finished.swap(mesh_worker.finished);
+    }
 
-        // ********** Copy data into our custom bitmap class, create image and trace outline
-        DrBitmap bitmap = DrBitmap(pixels, static_cast<int>(png_width * png_height * 4), false, png_width, png_height);
+    for (auto &result : finished) {
+        if (result.load_status != "") { load_status = result.load_status; continue; }
 
-        // ********** Ensure bitmap is power of 2
-        int max_side = Dr::Max(png_width, png_height);
-        int pow2 = 2;
-        int new_size = 2;
-        while (new_size < max_side) {
-            new_size = std::pow(2.0, pow2);
-            pow2++;
+        // ***** New image, old image stays on screen until first meshes of new one are ready
+        if (result.pixels) {
+            mesh_image_id = result.image_id;
+            mesh_new_image = std::move(result);
+            for (auto &variant : mesh_variants) variant.reset();
+            continue;
         }
-        DrBitmap square = DrBitmap(new_size, new_size);
-        for (int x = 0; x < png_width; x++) {
-            for (int y = 0; y < png_height; y++) {
-                square.setPixel(x, y, bitmap.getPixel(x, y));
-            }
-        }
-        //square = Dr::ApplySinglePixelFilter(Image_Filter_Type::Hue, square, Dr::RandomInt(-100, 100));
-        image = DrImage("shapes", square, 0.25f);
 
-        // ********** Calculate 3D Mesh
-        calculateMesh(true);        
+        // ***** Meshes, stored as finished variant and shown if it is the variant on screen
+        if (result.image_id != mesh_image_id) continue;
+        mesh_variants[result.variant] = result.levels;
+        if (result.variant != variantIndex(side_profile, smooth_normals)) continue;
+        image_size =     result.image_size;
+        mesh_levels =    result.levels;
+        pipeline_stats = result.stats;
+        selected_levels.clear();
+        selectLevels();
+        if (mesh_new_image.pixels == nullptr) continue;
 
         // ********** Initialze the sokol-gfx texture
         sg_image_desc sokol_image { };
-            sokol_image.width =  image.getBitmap().width;
-            sokol_image.height = image.getBitmap().height;
+            sokol_image.width =  mesh_new_image.width;
+            sokol_image.height = mesh_new_image.height;
             sokol_image.pixel_format = SG_PIXELFORMAT_RGBA8;
             sokol_image.min_filter = SG_FILTER_LINEAR;
             sokol_image.mag_filter = SG_FILTER_LINEAR;
-            sokol_image.data.subimage[0][0].ptr =  &(image.getBitmap().data[0]);
-            sokol_image.data.subimage[0][0].size = (size_t)image.getBitmap().size();
-    
+            sokol_image.wrap_u = SG_WRAP_CLAMP_TO_EDGE;             // Non power of 2 textures need clamping (and no mipmaps) on GLES2 / WebGL1,
+            sokol_image.wrap_v = SG_WRAP_CLAMP_TO_EDGE;             //      so image is never padded and uvs never need remapping
+            sokol_image.data.subimage[0][0].ptr =  mesh_new_image.pixels.get();
+            sokol_image.data.subimage[0][0].size = (size_t)mesh_new_image.width * (size_t)mesh_new_image.height * 4;
+
         // If we already have an image in the state buffer, uninit before initializing new image
         if (initialized_image == true) { sg_uninit_image(state.bind.fs_images[SLOT_tex]); }
 
         // Initialize new image into state buffer
         sg_init_image(state.bind.fs_images[SLOT_tex], &sokol_image);
         initialized_image = true;
-        stbi_image_free(pixels);
-    
+        mesh_new_image = mesh_result_t();
         load_status = "";
-    } else if (pixels) {
-        load_status = "Image size too big! Maximum width and height of 2048 pixels!";    
-    } else {
-        load_status = "Error loading image!";
+
+        // ***** Reset rotation
+        if (mesh_pack.batches.size() > 0) {
+            total_rotation.set(0.f, 0.f);
+            add_rotation.set(25.f, 25.f);
+            model = Dr::IdentityMatrix();
+        }
     }
 }
 
@@ -430,7 +712,7 @@ static void image_loaded(const sfetch_response_t* response) {
     if (response->fetched) {
         // File data has been fetched
         //  Since we provided a big-enough buffer we can be sure that all data has been loaded here
-        load_image((stbi_uc *)response->buffer_ptr, (int)response->fetched_size);
+        requestImage(response->buffer_ptr, response->fetched_size);
     }
     else if (response->finished) {
         // If loading the file failed, set clear color to signal reason
@@ -458,7 +740,7 @@ static void image_loaded(const sfetch_response_t* response) {
 static void emsc_load_callback(const sapp_html5_fetch_response* response) {
     if (response->succeeded) {
         state.load_state = LOADSTATE_SUCCESS;
-        load_image((stbi_uc *)response->buffer_ptr, (int)response->fetched_size);
+        requestImage(response->buffer_ptr, response->fetched_size);
     } else if (SAPP_HTML5_FETCH_ERROR_BUFFER_TOO_SMALL == response->error_code) {
         state.load_state = LOADSTATE_FILE_TOO_BIG;
     } else {
@@ -470,7 +752,7 @@ static void emsc_load_callback(const sapp_html5_fetch_response* response) {
 static void native_load_callback(const sfetch_response_t* response) {
     if (response->fetched) {
         state.load_state = LOADSTATE_SUCCESS;
-        load_image((stbi_uc *)response->buffer_ptr, (int)response->fetched_size);
+        requestImage(response->buffer_ptr, response->fetched_size);
     } else if (response->error_code == SFETCH_ERROR_BUFFER_TOO_SMALL) {
         state.load_state = LOADSTATE_FILE_TOO_BIG;
     } else {
@@ -498,7 +780,11 @@ static void input(const sapp_event* event) {
             case SAPP_KEYCODE_8:
             case SAPP_KEYCODE_9:
                 mesh_quality = event->key_code - SAPP_KEYCODE_1;
-                recalculate = true;
+                auto_quality = false;
+                selectLevels();
+                break;
+            case SAPP_KEYCODE_0:
+                auto_quality = true;
                 break;
             case SAPP_KEYCODE_R:
                 total_rotation.set(0.f, 0.f);
@@ -508,13 +794,23 @@ static void input(const sapp_event* event) {
             case SAPP_KEYCODE_W:
                 wireframe = !wireframe;
                 break;
+            case SAPP_KEYCODE_P:
+                switch (side_profile) {
+                    case Side_Profile::Flat:    side_profile = Side_Profile::Bevel;     break;
+                    case Side_Profile::Bevel:   side_profile = Side_Profile::Round;     break;
+                    case Side_Profile::Round:   side_profile = Side_Profile::Flat;      break;
+                }
+                requestMesh();
+                break;
+            case SAPP_KEYCODE_N:
+                smooth_normals = !smooth_normals;
+                requestMesh();
+                break;
             case SAPP_KEYCODE_MINUS:
-                depth_multiplier -= 0.1f;
-                recalculate = true;
+                depth_multiplier = Dr::Max(depth_multiplier - 0.1f, c_min_depth);
                 break;
             case SAPP_KEYCODE_EQUAL:
                 depth_multiplier += 0.1f;
-                recalculate = true;
             default: ;
         }
                 
@@ -609,9 +905,10 @@ static void input(const sapp_event* event) {
 static void frame(void) {
     // ***** Pump the sokol-fetch message queues, and invoke response callbacks
     sfetch_dowork();
+    collectMeshes();
 
     // ***** Compute model-view-projection matrix for vertex shader
-    hmm_mat4 proj = HMM_Perspective(52.5f, (float)sapp_width()/(float)sapp_height(), 5.f, 20000.0f);
+    hmm_mat4 proj = HMM_Perspective(c_field_of_view, (float)sapp_width()/(float)sapp_height(), 5.f, 20000.0f);
     hmm_mat4 view = HMM_LookAt(HMM_Vec3(0.0f, 1.5f, static_cast<float>(image_size) * zoom), HMM_Vec3(0.0f, 0.0f, 0.0f), HMM_Vec3(0.0f, 1.0f, 0.0f));
     hmm_mat4 view_proj = HMM_MultiplyMat4(proj, view);
 
@@ -624,36 +921,38 @@ static void frame(void) {
     add_rotation.set(0.f, 0.f);
 
 
-    // Uniforms for vertex shader
+    // Uniforms for vertex shader, depth is z scale applied before rotation
+    //  Model is rotation only, so normal matrix (inverse transpose of rotation * scale) is rotation * inverse scale
+    hmm_mat4 depth_model =  HMM_MultiplyMat4(model, HMM_Scale(HMM_Vec3(1.f, 1.f, depth_multiplier)));
+    hmm_mat4 normal_model = HMM_MultiplyMat4(model, HMM_Scale(HMM_Vec3(1.f, 1.f, 1.f / depth_multiplier)));
     vs_params_t vs_params;
-    vs_params.m =   model;
-    vs_params.mvp = HMM_MultiplyMat4(view_proj, model);
+    vs_params.m =   depth_model;
+    vs_params.nm =  normal_model;
+    vs_params.mvp = HMM_MultiplyMat4(view_proj, depth_model);
     
     // Uniforms for fragment shader
     fs_params_t fs_params;
     fs_params.u_wireframe = (wireframe) ? 1.0f : 0.0f;
 
 
-    // Check if user requested new model quality, if so recalculate
-    if (recalculate) {
-        calculateMesh(false);
-        recalculate = false;
-    }
+    // Pick level of detail from projected screen size
+    if (auto_quality) selectLevels();
+    uploadMeshes();
 
 
     // ***** Render pass
     sg_begin_default_pass(&state.pass_action, sapp_width(), sapp_height());
-    sg_apply_pipeline(state.pip);
-    sg_apply_bindings(&state.bind);
-    sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_params, SG_RANGE(vs_params));
-    sg_apply_uniforms(SG_SHADERSTAGE_FS, SLOT_fs_params, SG_RANGE(fs_params));
-    
-    // Draw Triangles
-    unsigned long index_count = 0;
-    for (auto mesh : meshes) {
-        index_count += mesh.indices.size();
+
+    // Draw Triangles, one draw per batch, base vertex is applied as vertex buffer offset
+    for (const auto &batch : mesh_pack.batches) {
+        state.bind.index_buffer = (batch.long_indices) ? state.long_indices.buffer : state.short_indices.buffer;
+        state.bind.vertex_buffer_offsets[0] = static_cast<int>(batch.base_vertex * sizeof(Vertex));
+        sg_apply_pipeline((batch.long_indices) ? state.pip_long : state.pip);
+        sg_apply_bindings(&state.bind);
+        sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_params, SG_RANGE(vs_params));
+        sg_apply_uniforms(SG_SHADERSTAGE_FS, SLOT_fs_params, SG_RANGE(fs_params));
+        sg_draw(batch.first_index, batch.index_count, 1);
     }
-    sg_draw(0, index_count, 1);
 
     // ***** Text
     fonsClearState(state.fons);    
@@ -672,11 +971,30 @@ static void frame(void) {
         fonsSetBlur(fs, 0);
         fonsSetSpacing(fs, 0.0f); 
         fonsDrawText(fs, 10 * dpis,  20 * dpis, ("FPS: " +  std::to_string(fps)).c_str(), NULL);
-        fonsDrawText(fs, 10 * dpis,  40 * dpis, ("Quality: " + std::to_string(mesh_quality+1)).c_str(), NULL);
+        fonsDrawText(fs, 10 * dpis,  40 * dpis, ("Quality: " + ((auto_quality) ? std::string("Auto") : std::to_string(mesh_quality+1))).c_str(), NULL);
         fonsDrawText(fs, 10 * dpis,  60 * dpis, ("Triangles: " + std::to_string(triangles)).c_str(), NULL);
         fonsDrawText(fs, 10 * dpis,  80 * dpis, ("Depth: " + std::to_string((int)(image_size * depth_multiplier))).c_str(), NULL);
         //fonsDrawText(fs, 10 * dpis, 100 * dpis, ("ZOOM: " + std::to_string(zoom)).c_str(), NULL);
 
+        // Stage breakdown of last rebuild, only when built with EXTRUDE_INSTRUMENT
+        if (c_instrument_enabled) {
+            char line[128];
+            float y = 110.f;
+            fonsSetSize(fs, 14.0f * dpis);
+            for (const auto &stage : pipeline_stats.stages) {
+                snprintf(line, sizeof(line), "%s: %.2f ms (%d)", stage.name.c_str(), stage.total_ms, stage.calls);
+                fonsDrawText(fs, 10 * dpis, y * dpis, line, NULL);
+                y += 16.f;
+            }
+            const Stat_Counter counters[] = { Stat_Counter::Objects_Found, Stat_Counter::Flood_Fills, Stat_Counter::Contour_Points_Traced,
+                                              Stat_Counter::Contour_Points_Simplified, Stat_Counter::Vertices_After_Remap, Stat_Counter::Bytes_Allocated };
+            for (auto counter : counters) {
+                snprintf(line, sizeof(line), "%s: %lld", Dr::CounterName(counter), pipeline_stats.counter(counter));
+                fonsDrawText(fs, 10 * dpis, y * dpis, line, NULL);
+                y += 16.f;
+            }
+        }
+
         if (load_status != "") {
             fonsSetAlign(fs, FONS_ALIGN_CENTER | FONS_ALIGN_MIDDLE);
             fonsSetSize(fs, 22.0f * dpis);
@@ -708,6 +1026,13 @@ static void frame(void) {
 //##    Clean Up
 //################################################################################
 void cleanup(void) {
+    {
+        std::lock_guard<std::mutex> lock(mesh_worker.mutex);
+        mesh_worker.quit = true;
+        if (mesh_worker.budget) mesh_worker.budget->cancel();
+    }
+    mesh_worker.wake.notify_one();
+    if (mesh_worker.thread.joinable()) mesh_worker.thread.join();
     sfetch_shutdown();
     sfons_destroy(state.fons);
     sgl_shutdown();
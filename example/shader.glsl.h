@@ -85,6 +85,7 @@
 SOKOL_SHDC_ALIGN(16) typedef struct vs_params_t {
     hmm_mat4 mvp;
     hmm_mat4 m;
+    hmm_mat4 nm;
 } vs_params_t;
 #pragma pack(pop)
 #define SLOT_fs_params (0)
@@ -97,7 +98,7 @@ SOKOL_SHDC_ALIGN(16) typedef struct fs_params_t {
 /*
     #version 330
     
-    uniform vec4 vs_params[8];
+    uniform vec4 vs_params[12];
     layout(location = 0) in vec4 pos;
     out vec2 uv;
     layout(location = 2) in vec2 texcoord0;
@@ -113,48 +114,52 @@ SOKOL_SHDC_ALIGN(16) typedef struct fs_params_t {
         uv = texcoord0;
         mat4 _42 = mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7]);
         vert = (_42 * vec4(pos.xyz, 1.0)).xyz;
-        vert_normal = (_42 * vec4(norm, 0.0)).xyz;
+        vert_normal = (mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * vec4(norm, 0.0)).xyz;
         vert_bary = bary;
     }
     
 */
-static const char vs_source_glsl330[569] = {
+static const char vs_source_glsl330[629] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
     0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x70,0x61,
-    0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,
-    0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,
-    0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,
-    0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,
-    0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,
-    0x76,0x65,0x63,0x32,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,
-    0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,0x6f,
-    0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,
-    0x6d,0x61,0x6c,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,
-    0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,
-    0x33,0x20,0x6e,0x6f,0x72,0x6d,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,
-    0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x3b,0x0a,0x6c,0x61,0x79,0x6f,
-    0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,
-    0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x0a,
-    0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,
-    0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
-    0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,
-    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,
-    0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,
-    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x70,
-    0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x74,0x65,0x78,
-    0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6d,0x61,0x74,0x34,
-    0x20,0x5f,0x34,0x32,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,
-    0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
-    0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
-    0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,
-    0x37,0x5d,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,
-    0x28,0x5f,0x34,0x32,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x70,0x6f,0x73,0x2e,
-    0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,
-    0x3d,0x20,0x28,0x5f,0x34,0x32,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x6e,0x6f,
-    0x72,0x6d,0x2c,0x20,0x30,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,
-    0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x20,0x3d,0x20,0x62,
-    0x61,0x72,0x79,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+    0x72,0x61,0x6d,0x73,0x5b,0x31,0x32,0x5d,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
+    0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,
+    0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x6f,0x75,0x74,0x20,
+    0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,
+    0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,
+    0x20,0x76,0x65,0x63,0x32,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,
+    0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,
+    0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,
+    0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,
+    0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,
+    0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,
+    0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x3b,0x0a,0x6c,0x61,0x79,
+    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,
+    0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,
+    0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,
+    0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,
+    0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,
+    0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,
+    0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,
+    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,
+    0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x74,0x65,
+    0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6d,0x61,0x74,
+    0x34,0x20,0x5f,0x34,0x32,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
+    0x5b,0x37,0x5d,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x20,0x3d,
+    0x20,0x28,0x5f,0x34,0x32,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x70,0x6f,0x73,
+    0x2e,0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,
+    0x20,0x3d,0x20,0x28,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5b,0x38,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
+    0x5b,0x39,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,
+    0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x31,
+    0x5d,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x6e,0x6f,0x72,0x6d,0x2c,0x20,
+    0x30,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,
+    0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x20,0x3d,0x20,0x62,0x61,0x72,0x79,0x3b,
+    0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #version 330
@@ -297,7 +302,7 @@ static const char fs_source_glsl330[1296] = {
 /*
     #version 100
     
-    uniform vec4 vs_params[8];
+    uniform vec4 vs_params[12];
     attribute vec4 pos;
     varying vec2 uv;
     attribute vec2 texcoord0;
@@ -313,46 +318,49 @@ static const char fs_source_glsl330[1296] = {
         uv = texcoord0;
         mat4 _42 = mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7]);
         vert = (_42 * vec4(pos.xyz, 1.0)).xyz;
-        vert_normal = (_42 * vec4(norm, 0.0)).xyz;
+        vert_normal = (mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * vec4(norm, 0.0)).xyz;
         vert_bary = bary;
     }
     
 */
-static const char vs_source_glsl100[529] = {
+static const char vs_source_glsl100[589] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x31,0x30,0x30,0x0a,0x0a,0x75,0x6e,
     0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x70,0x61,
-    0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,0x75,
-    0x74,0x65,0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x76,0x61,0x72,
-    0x79,0x69,0x6e,0x67,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x61,0x74,
-    0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,0x76,0x65,0x63,0x32,0x20,0x74,0x65,0x78,
-    0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x76,0x61,0x72,0x79,0x69,0x6e,0x67,0x20,
-    0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,0x76,0x61,0x72,0x79,0x69,
-    0x6e,0x67,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,
-    0x6d,0x61,0x6c,0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,0x76,
-    0x65,0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x3b,0x0a,0x76,0x61,0x72,0x79,0x69,0x6e,
-    0x67,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,
-    0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,0x76,0x65,0x63,0x33,
-    0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,
-    0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,
-    0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,
-    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,
-    0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
-    0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
-    0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x75,0x76,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x6d,0x61,0x74,0x34,0x20,0x5f,0x34,0x32,0x20,0x3d,0x20,0x6d,
-    0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,
-    0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,
-    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x37,0x5d,0x29,0x3b,0x0a,0x20,0x20,0x20,
-    0x20,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,0x28,0x5f,0x34,0x32,0x20,0x2a,0x20,0x76,
-    0x65,0x63,0x34,0x28,0x70,0x6f,0x73,0x2e,0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,
-    0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,
-    0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x28,0x5f,0x34,0x32,0x20,0x2a,
-    0x20,0x76,0x65,0x63,0x34,0x28,0x6e,0x6f,0x72,0x6d,0x2c,0x20,0x30,0x2e,0x30,0x29,
-    0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,
-    0x62,0x61,0x72,0x79,0x20,0x3d,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x7d,0x0a,0x0a,
-    0x00,
+    0x72,0x61,0x6d,0x73,0x5b,0x31,0x32,0x5d,0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,
+    0x75,0x74,0x65,0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x76,0x61,
+    0x72,0x79,0x69,0x6e,0x67,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x61,
+    0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,0x76,0x65,0x63,0x32,0x20,0x74,0x65,
+    0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x76,0x61,0x72,0x79,0x69,0x6e,0x67,
+    0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,0x76,0x61,0x72,0x79,
+    0x69,0x6e,0x67,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,
+    0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,
+    0x76,0x65,0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x3b,0x0a,0x76,0x61,0x72,0x79,0x69,
+    0x6e,0x67,0x20,0x76,0x65,0x63,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,
+    0x79,0x3b,0x0a,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x20,0x76,0x65,0x63,
+    0x33,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,
+    0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,
+    0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x75,0x76,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x6d,0x61,0x74,0x34,0x20,0x5f,0x34,0x32,0x20,0x3d,0x20,
+    0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,
+    0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,
+    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x37,0x5d,0x29,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,0x28,0x5f,0x34,0x32,0x20,0x2a,0x20,
+    0x76,0x65,0x63,0x34,0x28,0x70,0x6f,0x73,0x2e,0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,
+    0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,
+    0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x28,0x6d,0x61,0x74,0x34,
+    0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x2c,0x20,0x76,
+    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x39,0x5d,0x2c,0x20,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x31,0x5d,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,
+    0x34,0x28,0x6e,0x6f,0x72,0x6d,0x2c,0x20,0x30,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,
+    0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,
+    0x20,0x3d,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #version 100
@@ -508,6 +516,7 @@ static const char fs_source_glsl100[1453] = {
     {
         row_major float4x4 _21_mvp : packoffset(c0);
         row_major float4x4 _21_m : packoffset(c4);
+        row_major float4x4 _21_nm : packoffset(c8);
     };
     
     
@@ -538,17 +547,17 @@ static const char fs_source_glsl100[1453] = {
         float4 gl_Position : SV_Position;
     };
     
-    #line 22 "shader.glsl"
+    #line 23 "shader.glsl"
     void vert_main()
     {
-    #line 22 "shader.glsl"
-        gl_Position = mul(pos, _21_mvp);
     #line 23 "shader.glsl"
-        uv = texcoord0;
+        gl_Position = mul(pos, _21_mvp);
     #line 24 "shader.glsl"
+        uv = texcoord0;
+    #line 25 "shader.glsl"
         vert = mul(float4(pos.xyz, 1.0f), _21_m).xyz;
-        vert_normal = mul(float4(norm, 0.0f), _21_m).xyz;
-    #line 26 "shader.glsl"
+        vert_normal = mul(float4(norm, 0.0f), _21_nm).xyz;
+    #line 27 "shader.glsl"
         vert_bary = bary;
     }
     
@@ -568,7 +577,7 @@ static const char fs_source_glsl100[1453] = {
         return stage_output;
     }
 */
-static const char vs_source_hlsl4[1452] = {
+static const char vs_source_hlsl4[1501] = {
     0x63,0x62,0x75,0x66,0x66,0x65,0x72,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
     0x73,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,0x72,0x28,0x62,0x30,0x29,
     0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x72,0x6f,0x77,0x5f,0x6d,0x61,0x6a,0x6f,0x72,
@@ -577,6 +586,9 @@ static const char vs_source_hlsl4[1452] = {
     0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x6f,0x77,0x5f,0x6d,0x61,0x6a,0x6f,
     0x72,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x5f,0x32,0x31,0x5f,0x6d,
     0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x34,
+    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x6f,0x77,0x5f,0x6d,0x61,0x6a,0x6f,0x72,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x5f,0x32,0x31,0x5f,0x6e,0x6d,
+    0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x38,
     0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
     0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
     0x6e,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,
@@ -612,54 +624,54 @@ static const char vs_source_hlsl4[1452] = {
     0x33,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,
     0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x53,0x56,0x5f,0x50,
     0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,0x69,
-    0x6e,0x65,0x20,0x32,0x32,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,
+    0x6e,0x65,0x20,0x32,0x33,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,
     0x73,0x6c,0x22,0x0a,0x76,0x6f,0x69,0x64,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,
-    0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x32,0x20,
+    0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x33,0x20,
     0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,
     0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
     0x6d,0x75,0x6c,0x28,0x70,0x6f,0x73,0x2c,0x20,0x5f,0x32,0x31,0x5f,0x6d,0x76,0x70,
-    0x29,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x33,0x20,0x22,0x73,0x68,0x61,
+    0x29,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x34,0x20,0x22,0x73,0x68,0x61,
     0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,
     0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x23,0x6c,
-    0x69,0x6e,0x65,0x20,0x32,0x34,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
+    0x69,0x6e,0x65,0x20,0x32,0x35,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
     0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,
     0x6d,0x75,0x6c,0x28,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x70,0x6f,0x73,0x2e,0x78,
     0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,0x5f,0x32,0x31,0x5f,0x6d,
     0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,
     0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x6d,0x75,0x6c,0x28,0x66,0x6c,0x6f,
     0x61,0x74,0x34,0x28,0x6e,0x6f,0x72,0x6d,0x2c,0x20,0x30,0x2e,0x30,0x66,0x29,0x2c,
-    0x20,0x5f,0x32,0x31,0x5f,0x6d,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x23,0x6c,0x69,
-    0x6e,0x65,0x20,0x32,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,
-    0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,
-    0x79,0x20,0x3d,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,
-    0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,
-    0x6d,0x61,0x69,0x6e,0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,
-    0x5f,0x49,0x6e,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,
-    0x75,0x74,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x70,0x6f,0x73,0x20,0x3d,0x20,
-    0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x70,0x6f,0x73,0x3b,
-    0x0a,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x20,0x3d,
-    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x74,0x65,0x78,
-    0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6e,0x6f,0x72,0x6d,
-    0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x6e,
-    0x6f,0x72,0x6d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x62,0x61,0x72,0x79,0x20,0x3d,0x20,
-    0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x62,0x61,0x72,0x79,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,
-    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,
-    0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,
-    0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,
-    0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,
-    0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
-    0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,
-    0x74,0x70,0x75,0x74,0x2e,0x75,0x76,0x20,0x3d,0x20,0x75,0x76,0x3b,0x0a,0x20,0x20,
-    0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,
-    0x65,0x72,0x74,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,0x65,0x72,
-    0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,0x5f,
-    0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,
-    0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,
-    0x72,0x79,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,0x65,
-    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
+    0x20,0x5f,0x32,0x31,0x5f,0x6e,0x6d,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x23,0x6c,
+    0x69,0x6e,0x65,0x20,0x32,0x37,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
+    0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,
+    0x72,0x79,0x20,0x3d,0x20,0x62,0x61,0x72,0x79,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,
+    0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,
+    0x20,0x6d,0x61,0x69,0x6e,0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,
+    0x73,0x5f,0x49,0x6e,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,
+    0x70,0x75,0x74,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x70,0x6f,0x73,0x20,0x3d,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x70,0x6f,0x73,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x20,
+    0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x74,0x65,
+    0x78,0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6e,0x6f,0x72,
+    0x6d,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,
+    0x6e,0x6f,0x72,0x6d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x62,0x61,0x72,0x79,0x20,0x3d,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x62,0x61,0x72,
+    0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,
+    0x28,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,
+    0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,
+    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,
+    0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,
+    0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,
+    0x69,0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,
+    0x75,0x74,0x70,0x75,0x74,0x2e,0x75,0x76,0x20,0x3d,0x20,0x75,0x76,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,
+    0x76,0x65,0x72,0x74,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,0x65,
+    0x72,0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,
+    0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,
+    0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x76,0x65,0x72,0x74,0x5f,0x62,
+    0x61,0x72,0x79,0x20,0x3d,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,
+    0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
 };
 /*
     cbuffer fs_params : register(b0)
@@ -689,19 +701,19 @@ static const char vs_source_hlsl4[1452] = {
         float4 frag_color : SV_Target0;
     };
     
-    #line 25 "shader.glsl"
+    #line 26 "shader.glsl"
     void frag_main()
     {
-    #line 25 "shader.glsl"
+    #line 26 "shader.glsl"
         float4 _40 = tex.Sample(_tex_sampler, uv);
         float3 _44 = _40.xyz;
         float3 rgb_out = _44;
-    #line 29 "shader.glsl"
+    #line 30 "shader.glsl"
         float alpha_out = 1.0f;
-    #line 33 "shader.glsl"
+    #line 34 "shader.glsl"
         if (_53_u_wireframe == 1.0f)
         {
-    #line 36 "shader.glsl"
+    #line 37 "shader.glsl"
             float3 _66 = fwidth(vert_bary);
             float3 _73 = smoothstep(0.0f.xxx, _66 * 1.0f, vert_bary);
             float3 _90 = _44 * (1.0f - min(min(_73.x, _73.y), _73.z));
@@ -731,10 +743,10 @@ static const char vs_source_hlsl4[1452] = {
                 alpha_out = 0.800000011920928955078125f;
             }
         }
-    #line 55 "shader.glsl"
-    #line 57 "shader.glsl"
+    #line 56 "shader.glsl"
+    #line 58 "shader.glsl"
         rgb_out = lerp(0.0f.xxx, rgb_out, clamp(dot(normalize(vert_normal), normalize(vert - float3(0.0f, 1.5f, 500.0f))) + 0.1500000059604644775390625f, 0.0f, 1.0f).xxx);
-    #line 62 "shader.glsl"
+    #line 63 "shader.glsl"
         frag_color = float4(rgb_out, alpha_out);
     }
     
@@ -783,9 +795,9 @@ static const char fs_source_hlsl4[2174] = {
     0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x66,0x72,0x61,
     0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x53,0x56,0x5f,0x54,0x61,0x72,
     0x67,0x65,0x74,0x30,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,
-    0x32,0x35,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,
+    0x32,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,
     0x0a,0x76,0x6f,0x69,0x64,0x20,0x66,0x72,0x61,0x67,0x5f,0x6d,0x61,0x69,0x6e,0x28,
-    0x29,0x0a,0x7b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x35,0x20,0x22,0x73,0x68,
+    0x29,0x0a,0x7b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x36,0x20,0x22,0x73,0x68,
     0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x66,
     0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x34,0x30,0x20,0x3d,0x20,0x74,0x65,0x78,0x2e,
     0x53,0x61,0x6d,0x70,0x6c,0x65,0x28,0x5f,0x74,0x65,0x78,0x5f,0x73,0x61,0x6d,0x70,
@@ -793,14 +805,14 @@ static const char fs_source_hlsl4[2174] = {
     0x6f,0x61,0x74,0x33,0x20,0x5f,0x34,0x34,0x20,0x3d,0x20,0x5f,0x34,0x30,0x2e,0x78,
     0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x72,
     0x67,0x62,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x5f,0x34,0x34,0x3b,0x0a,0x23,0x6c,
-    0x69,0x6e,0x65,0x20,0x32,0x39,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
+    0x69,0x6e,0x65,0x20,0x33,0x30,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
     0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x61,
     0x6c,0x70,0x68,0x61,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x31,0x2e,0x30,0x66,0x3b,
-    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x33,0x33,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
+    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x33,0x34,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
     0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,
     0x5f,0x35,0x33,0x5f,0x75,0x5f,0x77,0x69,0x72,0x65,0x66,0x72,0x61,0x6d,0x65,0x20,
     0x3d,0x3d,0x20,0x31,0x2e,0x30,0x66,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x23,
-    0x6c,0x69,0x6e,0x65,0x20,0x33,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,
+    0x6c,0x69,0x6e,0x65,0x20,0x33,0x37,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,
     0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,
     0x6f,0x61,0x74,0x33,0x20,0x5f,0x36,0x36,0x20,0x3d,0x20,0x66,0x77,0x69,0x64,0x74,
     0x68,0x28,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x29,0x3b,0x0a,0x20,0x20,
@@ -849,9 +861,9 @@ static const char fs_source_hlsl4[2174] = {
     0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x30,0x2e,0x38,0x30,0x30,0x30,0x30,0x30,0x30,
     0x31,0x31,0x39,0x32,0x30,0x39,0x32,0x38,0x39,0x35,0x35,0x30,0x37,0x38,0x31,0x32,
     0x35,0x66,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,
-    0x20,0x20,0x7d,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x35,0x20,0x22,0x73,0x68,
+    0x20,0x20,0x7d,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x36,0x20,0x22,0x73,0x68,
     0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x23,0x6c,0x69,0x6e,0x65,
-    0x20,0x35,0x37,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,
+    0x20,0x35,0x38,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,
     0x22,0x0a,0x20,0x20,0x20,0x20,0x72,0x67,0x62,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,
     0x6c,0x65,0x72,0x70,0x28,0x30,0x2e,0x30,0x66,0x2e,0x78,0x78,0x78,0x2c,0x20,0x72,
     0x67,0x62,0x5f,0x6f,0x75,0x74,0x2c,0x20,0x63,0x6c,0x61,0x6d,0x70,0x28,0x64,0x6f,
@@ -863,7 +875,7 @@ static const char fs_source_hlsl4[2174] = {
     0x30,0x30,0x30,0x30,0x35,0x39,0x36,0x30,0x34,0x36,0x34,0x34,0x37,0x37,0x35,0x33,
     0x39,0x30,0x36,0x32,0x35,0x66,0x2c,0x20,0x30,0x2e,0x30,0x66,0x2c,0x20,0x31,0x2e,
     0x30,0x66,0x29,0x2e,0x78,0x78,0x78,0x29,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,
-    0x36,0x32,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,
+    0x36,0x33,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,
     0x0a,0x20,0x20,0x20,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,
     0x3d,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x72,0x67,0x62,0x5f,0x6f,0x75,0x74,
     0x2c,0x20,0x61,0x6c,0x70,0x68,0x61,0x5f,0x6f,0x75,0x74,0x29,0x3b,0x0a,0x7d,0x0a,
@@ -898,6 +910,7 @@ static const char fs_source_hlsl4[2174] = {
     {
         float4x4 mvp;
         float4x4 m;
+        float4x4 nm;
     };
     
     struct main0_out
@@ -917,24 +930,24 @@ static const char fs_source_hlsl4[2174] = {
         float3 bary [[attribute(3)]];
     };
     
-    #line 22 "shader.glsl"
+    #line 23 "shader.glsl"
     vertex main0_out main0(main0_in in [[stage_in]], constant vs_params& _21 [[buffer(0)]])
     {
         main0_out out = {};
-    #line 22 "shader.glsl"
-        out.gl_Position = _21.mvp * in.pos;
     #line 23 "shader.glsl"
-        out.uv = in.texcoord0;
+        out.gl_Position = _21.mvp * in.pos;
     #line 24 "shader.glsl"
+        out.uv = in.texcoord0;
+    #line 25 "shader.glsl"
         out.vert = (_21.m * float4(in.pos.xyz, 1.0)).xyz;
-        out.vert_normal = (_21.m * float4(in.norm, 0.0)).xyz;
-    #line 26 "shader.glsl"
+        out.vert_normal = (_21.nm * float4(in.norm, 0.0)).xyz;
+    #line 27 "shader.glsl"
         out.vert_bary = in.bary;
         return out;
     }
     
 */
-static const char vs_source_metal_macos[950] = {
+static const char vs_source_metal_macos[968] = {
     0x23,0x69,0x6e,0x63,0x6c,0x75,0x64,0x65,0x20,0x3c,0x6d,0x65,0x74,0x61,0x6c,0x5f,
     0x73,0x74,0x64,0x6c,0x69,0x62,0x3e,0x0a,0x23,0x69,0x6e,0x63,0x6c,0x75,0x64,0x65,
     0x20,0x3c,0x73,0x69,0x6d,0x64,0x2f,0x73,0x69,0x6d,0x64,0x2e,0x68,0x3e,0x0a,0x0a,
@@ -942,59 +955,60 @@ static const char vs_source_metal_macos[950] = {
     0x6d,0x65,0x74,0x61,0x6c,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x76,
     0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,
     0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x6d,0x76,0x70,0x3b,0x0a,0x20,0x20,0x20,
-    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x6d,0x3b,0x0a,0x7d,0x3b,0x0a,
-    0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,0x75,
-    0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x75,
-    0x76,0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x30,0x29,0x5d,
-    0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x65,
-    0x72,0x74,0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x31,0x29,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x6d,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x78,0x34,0x20,0x6e,0x6d,0x3b,0x0a,0x7d,0x3b,
+    0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,
+    0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,
+    0x75,0x76,0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x30,0x29,
     0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,
-    0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x5b,0x5b,0x75,0x73,0x65,
-    0x72,0x28,0x6c,0x6f,0x63,0x6e,0x32,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,
-    0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x33,0x29,0x5d,0x5d,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,
-    0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x5b,0x5b,0x70,0x6f,0x73,0x69,0x74,
-    0x69,0x6f,0x6e,0x5d,0x5d,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,
-    0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x69,0x6e,0x0a,0x7b,0x0a,0x20,0x20,0x20,
-    0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x70,0x6f,0x73,0x20,0x5b,0x5b,0x61,0x74,
-    0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x28,0x30,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,
-    0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x20,0x5b,0x5b,
-    0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x28,0x31,0x29,0x5d,0x5d,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x74,0x65,0x78,0x63,0x6f,
-    0x6f,0x72,0x64,0x30,0x20,0x5b,0x5b,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,
-    0x28,0x32,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,
-    0x33,0x20,0x62,0x61,0x72,0x79,0x20,0x5b,0x5b,0x61,0x74,0x74,0x72,0x69,0x62,0x75,
-    0x74,0x65,0x28,0x33,0x29,0x5d,0x5d,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,0x69,
-    0x6e,0x65,0x20,0x32,0x32,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,
-    0x73,0x6c,0x22,0x0a,0x76,0x65,0x72,0x74,0x65,0x78,0x20,0x6d,0x61,0x69,0x6e,0x30,
-    0x5f,0x6f,0x75,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x28,0x6d,0x61,0x69,0x6e,0x30,
-    0x5f,0x69,0x6e,0x20,0x69,0x6e,0x20,0x5b,0x5b,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,
-    0x6e,0x5d,0x5d,0x2c,0x20,0x63,0x6f,0x6e,0x73,0x74,0x61,0x6e,0x74,0x20,0x76,0x73,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x26,0x20,0x5f,0x32,0x31,0x20,0x5b,0x5b,0x62,
-    0x75,0x66,0x66,0x65,0x72,0x28,0x30,0x29,0x5d,0x5d,0x29,0x0a,0x7b,0x0a,0x20,0x20,
-    0x20,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,0x75,0x74,0x20,0x6f,0x75,0x74,0x20,
-    0x3d,0x20,0x7b,0x7d,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x32,0x20,0x22,
-    0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,
-    0x20,0x6f,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,
-    0x20,0x3d,0x20,0x5f,0x32,0x31,0x2e,0x6d,0x76,0x70,0x20,0x2a,0x20,0x69,0x6e,0x2e,
-    0x70,0x6f,0x73,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x33,0x20,0x22,0x73,
-    0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,
-    0x6f,0x75,0x74,0x2e,0x75,0x76,0x20,0x3d,0x20,0x69,0x6e,0x2e,0x74,0x65,0x78,0x63,
-    0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x34,0x20,
+    0x65,0x72,0x74,0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x31,
+    0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
+    0x76,0x65,0x72,0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x5b,0x5b,0x75,0x73,
+    0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x32,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,
+    0x79,0x20,0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x33,0x29,0x5d,
+    0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,
+    0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x5b,0x5b,0x70,0x6f,0x73,0x69,
+    0x74,0x69,0x6f,0x6e,0x5d,0x5d,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,
+    0x63,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x69,0x6e,0x0a,0x7b,0x0a,0x20,0x20,
+    0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x70,0x6f,0x73,0x20,0x5b,0x5b,0x61,
+    0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x28,0x30,0x29,0x5d,0x5d,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x20,0x5b,
+    0x5b,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x28,0x31,0x29,0x5d,0x5d,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x74,0x65,0x78,0x63,
+    0x6f,0x6f,0x72,0x64,0x30,0x20,0x5b,0x5b,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,
+    0x65,0x28,0x32,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x33,0x20,0x62,0x61,0x72,0x79,0x20,0x5b,0x5b,0x61,0x74,0x74,0x72,0x69,0x62,
+    0x75,0x74,0x65,0x28,0x33,0x29,0x5d,0x5d,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,
+    0x69,0x6e,0x65,0x20,0x32,0x33,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
+    0x6c,0x73,0x6c,0x22,0x0a,0x76,0x65,0x72,0x74,0x65,0x78,0x20,0x6d,0x61,0x69,0x6e,
+    0x30,0x5f,0x6f,0x75,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x28,0x6d,0x61,0x69,0x6e,
+    0x30,0x5f,0x69,0x6e,0x20,0x69,0x6e,0x20,0x5b,0x5b,0x73,0x74,0x61,0x67,0x65,0x5f,
+    0x69,0x6e,0x5d,0x5d,0x2c,0x20,0x63,0x6f,0x6e,0x73,0x74,0x61,0x6e,0x74,0x20,0x76,
+    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x26,0x20,0x5f,0x32,0x31,0x20,0x5b,0x5b,
+    0x62,0x75,0x66,0x66,0x65,0x72,0x28,0x30,0x29,0x5d,0x5d,0x29,0x0a,0x7b,0x0a,0x20,
+    0x20,0x20,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,0x75,0x74,0x20,0x6f,0x75,0x74,
+    0x20,0x3d,0x20,0x7b,0x7d,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x33,0x20,
     0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,
-    0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,0x28,0x5f,0x32,
-    0x31,0x2e,0x6d,0x20,0x2a,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x69,0x6e,0x2e,
-    0x70,0x6f,0x73,0x2e,0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x2e,0x78,
-    0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,0x65,0x72,0x74,
-    0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x28,0x5f,0x32,0x31,0x2e,0x6d,
-    0x20,0x2a,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x69,0x6e,0x2e,0x6e,0x6f,0x72,
-    0x6d,0x2c,0x20,0x30,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,0x23,0x6c,
-    0x69,0x6e,0x65,0x20,0x32,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
-    0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,0x65,0x72,
-    0x74,0x5f,0x62,0x61,0x72,0x79,0x20,0x3d,0x20,0x69,0x6e,0x2e,0x62,0x61,0x72,0x79,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x6f,0x75,0x74,
-    0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+    0x20,0x20,0x6f,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x5f,0x32,0x31,0x2e,0x6d,0x76,0x70,0x20,0x2a,0x20,0x69,0x6e,
+    0x2e,0x70,0x6f,0x73,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x34,0x20,0x22,
+    0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,
+    0x20,0x6f,0x75,0x74,0x2e,0x75,0x76,0x20,0x3d,0x20,0x69,0x6e,0x2e,0x74,0x65,0x78,
+    0x63,0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x35,
+    0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,
+    0x20,0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,0x65,0x72,0x74,0x20,0x3d,0x20,0x28,0x5f,
+    0x32,0x31,0x2e,0x6d,0x20,0x2a,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x69,0x6e,
+    0x2e,0x70,0x6f,0x73,0x2e,0x78,0x79,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,0x2e,
+    0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,0x65,0x72,
+    0x74,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x28,0x5f,0x32,0x31,0x2e,
+    0x6e,0x6d,0x20,0x2a,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x69,0x6e,0x2e,0x6e,
+    0x6f,0x72,0x6d,0x2c,0x20,0x30,0x2e,0x30,0x29,0x29,0x2e,0x78,0x79,0x7a,0x3b,0x0a,
+    0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x37,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,
+    0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x6f,0x75,0x74,0x2e,0x76,
+    0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x20,0x3d,0x20,0x69,0x6e,0x2e,0x62,0x61,
+    0x72,0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x6f,
+    0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #include <metal_stdlib>
@@ -1020,20 +1034,20 @@ static const char vs_source_metal_macos[950] = {
         float3 vert_bary [[user(locn3)]];
     };
     
-    #line 25 "shader.glsl"
+    #line 26 "shader.glsl"
     fragment main0_out main0(main0_in in [[stage_in]], constant fs_params& _53 [[buffer(0)]], texture2d<float> tex [[texture(0)]], sampler texSmplr [[sampler(0)]])
     {
         main0_out out = {};
-    #line 25 "shader.glsl"
+    #line 26 "shader.glsl"
         float4 _40 = tex.sample(texSmplr, in.uv);
         float3 _44 = _40.xyz;
         float3 rgb_out = _44;
-    #line 29 "shader.glsl"
+    #line 30 "shader.glsl"
         float alpha_out = 1.0;
-    #line 33 "shader.glsl"
+    #line 34 "shader.glsl"
         if (_53.u_wireframe == 1.0)
         {
-    #line 36 "shader.glsl"
+    #line 37 "shader.glsl"
             float3 _66 = fwidth(in.vert_bary);
             float3 _73 = smoothstep(float3(0.0), _66 * 1.0, in.vert_bary);
             float3 _90 = _44 * (1.0 - fast::min(fast::min(_73.x, _73.y), _73.z));
@@ -1063,10 +1077,10 @@ static const char vs_source_metal_macos[950] = {
                 alpha_out = 0.800000011920928955078125;
             }
         }
-    #line 55 "shader.glsl"
-    #line 57 "shader.glsl"
+    #line 56 "shader.glsl"
+    #line 58 "shader.glsl"
         rgb_out = mix(float3(0.0), rgb_out, float3(fast::clamp(dot(normalize(in.vert_normal), normalize(in.vert - float3(0.0, 1.5, 500.0))) + 0.1500000059604644775390625, 0.0, 1.0)));
-    #line 62 "shader.glsl"
+    #line 63 "shader.glsl"
         out.frag_color = float4(rgb_out, alpha_out);
         return out;
     }
@@ -1094,7 +1108,7 @@ static const char fs_source_metal_macos[1903] = {
     0x28,0x6c,0x6f,0x63,0x6e,0x32,0x29,0x5d,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
     0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x20,
     0x5b,0x5b,0x75,0x73,0x65,0x72,0x28,0x6c,0x6f,0x63,0x6e,0x33,0x29,0x5d,0x5d,0x3b,
-    0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x35,0x20,0x22,0x73,
+    0x0a,0x7d,0x3b,0x0a,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x36,0x20,0x22,0x73,
     0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x66,0x72,0x61,0x67,
     0x6d,0x65,0x6e,0x74,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,0x75,0x74,0x20,0x6d,
     0x61,0x69,0x6e,0x30,0x28,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x69,0x6e,0x20,0x69,0x6e,
@@ -1107,7 +1121,7 @@ static const char fs_source_metal_macos[1903] = {
     0x65,0x72,0x20,0x74,0x65,0x78,0x53,0x6d,0x70,0x6c,0x72,0x20,0x5b,0x5b,0x73,0x61,
     0x6d,0x70,0x6c,0x65,0x72,0x28,0x30,0x29,0x5d,0x5d,0x29,0x0a,0x7b,0x0a,0x20,0x20,
     0x20,0x20,0x6d,0x61,0x69,0x6e,0x30,0x5f,0x6f,0x75,0x74,0x20,0x6f,0x75,0x74,0x20,
-    0x3d,0x20,0x7b,0x7d,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x35,0x20,0x22,
+    0x3d,0x20,0x7b,0x7d,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x32,0x36,0x20,0x22,
     0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,
     0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x5f,0x34,0x30,0x20,0x3d,0x20,0x74,0x65,
     0x78,0x2e,0x73,0x61,0x6d,0x70,0x6c,0x65,0x28,0x74,0x65,0x78,0x53,0x6d,0x70,0x6c,
@@ -1115,14 +1129,14 @@ static const char fs_source_metal_macos[1903] = {
     0x6c,0x6f,0x61,0x74,0x33,0x20,0x5f,0x34,0x34,0x20,0x3d,0x20,0x5f,0x34,0x30,0x2e,
     0x78,0x79,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,
     0x72,0x67,0x62,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x5f,0x34,0x34,0x3b,0x0a,0x23,
-    0x6c,0x69,0x6e,0x65,0x20,0x32,0x39,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,
+    0x6c,0x69,0x6e,0x65,0x20,0x33,0x30,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,
     0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,
     0x61,0x6c,0x70,0x68,0x61,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x31,0x2e,0x30,0x3b,
-    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x33,0x33,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
+    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x33,0x34,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
     0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,
     0x5f,0x35,0x33,0x2e,0x75,0x5f,0x77,0x69,0x72,0x65,0x66,0x72,0x61,0x6d,0x65,0x20,
     0x3d,0x3d,0x20,0x31,0x2e,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x23,0x6c,
-    0x69,0x6e,0x65,0x20,0x33,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
+    0x69,0x6e,0x65,0x20,0x33,0x37,0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,
     0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
     0x61,0x74,0x33,0x20,0x5f,0x36,0x36,0x20,0x3d,0x20,0x66,0x77,0x69,0x64,0x74,0x68,
     0x28,0x69,0x6e,0x2e,0x76,0x65,0x72,0x74,0x5f,0x62,0x61,0x72,0x79,0x29,0x3b,0x0a,
@@ -1172,8 +1186,8 @@ static const char fs_source_metal_macos[1903] = {
     0x75,0x74,0x20,0x3d,0x20,0x30,0x2e,0x38,0x30,0x30,0x30,0x30,0x30,0x30,0x31,0x31,
     0x39,0x32,0x30,0x39,0x32,0x38,0x39,0x35,0x35,0x30,0x37,0x38,0x31,0x32,0x35,0x3b,
     0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x7d,
-    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x35,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
-    0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x37,
+    0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x36,0x20,0x22,0x73,0x68,0x61,0x64,0x65,
+    0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x35,0x38,
     0x20,0x22,0x73,0x68,0x61,0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,
     0x20,0x20,0x20,0x72,0x67,0x62,0x5f,0x6f,0x75,0x74,0x20,0x3d,0x20,0x6d,0x69,0x78,
     0x28,0x66,0x6c,0x6f,0x61,0x74,0x33,0x28,0x30,0x2e,0x30,0x29,0x2c,0x20,0x72,0x67,
@@ -1186,7 +1200,7 @@ static const char fs_source_metal_macos[1903] = {
     0x30,0x2e,0x30,0x29,0x29,0x29,0x20,0x2b,0x20,0x30,0x2e,0x31,0x35,0x30,0x30,0x30,
     0x30,0x30,0x30,0x35,0x39,0x36,0x30,0x34,0x36,0x34,0x34,0x37,0x37,0x35,0x33,0x39,
     0x30,0x36,0x32,0x35,0x2c,0x20,0x30,0x2e,0x30,0x2c,0x20,0x31,0x2e,0x30,0x29,0x29,
-    0x29,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x36,0x32,0x20,0x22,0x73,0x68,0x61,
+    0x29,0x3b,0x0a,0x23,0x6c,0x69,0x6e,0x65,0x20,0x36,0x33,0x20,0x22,0x73,0x68,0x61,
     0x64,0x65,0x72,0x2e,0x67,0x6c,0x73,0x6c,0x22,0x0a,0x20,0x20,0x20,0x20,0x6f,0x75,
     0x74,0x2e,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x66,
     0x6c,0x6f,0x61,0x74,0x34,0x28,0x72,0x67,0x62,0x5f,0x6f,0x75,0x74,0x2c,0x20,0x61,
@@ -1208,10 +1222,10 @@ static inline const sg_shader_desc* extrude3D_shader_desc(sg_backend backend) {
       desc.attrs[3].name = "bary";
       desc.vs.source = vs_source_glsl330;
       desc.vs.entry = "main";
-      desc.vs.uniform_blocks[0].size = 128;
+      desc.vs.uniform_blocks[0].size = 192;
       desc.vs.uniform_blocks[0].uniforms[0].name = "vs_params";
       desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
-      desc.vs.uniform_blocks[0].uniforms[0].array_count = 8;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 12;
       desc.fs.source = fs_source_glsl330;
       desc.fs.entry = "main";
       desc.fs.uniform_blocks[0].size = 16;
@@ -1236,10 +1250,10 @@ static inline const sg_shader_desc* extrude3D_shader_desc(sg_backend backend) {
       desc.attrs[3].name = "bary";
       desc.vs.source = vs_source_glsl100;
       desc.vs.entry = "main";
-      desc.vs.uniform_blocks[0].size = 128;
+      desc.vs.uniform_blocks[0].size = 192;
       desc.vs.uniform_blocks[0].uniforms[0].name = "vs_params";
       desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
-      desc.vs.uniform_blocks[0].uniforms[0].array_count = 8;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 12;
       desc.fs.source = fs_source_glsl100;
       desc.fs.entry = "main";
       desc.fs.uniform_blocks[0].size = 16;
@@ -1269,7 +1283,7 @@ static inline const sg_shader_desc* extrude3D_shader_desc(sg_backend backend) {
       desc.vs.source = vs_source_hlsl4;
       desc.vs.d3d11_target = "vs_4_0";
       desc.vs.entry = "main";
-      desc.vs.uniform_blocks[0].size = 128;
+      desc.vs.uniform_blocks[0].size = 192;
       desc.fs.source = fs_source_hlsl4;
       desc.fs.d3d11_target = "ps_4_0";
       desc.fs.entry = "main";
@@ -1288,7 +1302,7 @@ static inline const sg_shader_desc* extrude3D_shader_desc(sg_backend backend) {
       valid = true;
       desc.vs.source = vs_source_metal_macos;
       desc.vs.entry = "main0";
-      desc.vs.uniform_blocks[0].size = 128;
+      desc.vs.uniform_blocks[0].size = 192;
       desc.fs.source = fs_source_metal_macos;
       desc.fs.entry = "main0";
       desc.fs.uniform_blocks[0].size = 16;
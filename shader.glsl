@@ -9,6 +9,7 @@
 uniform vs_params {
     mat4 mvp;
     mat4 m;
+    mat4 nm;                // Normal matrix, inverse transpose of m
 };
 
 in vec4 pos;
@@ -25,7 +26,7 @@ void main() {
     gl_Position = mvp * pos;
     uv = texcoord0;
     vert =          (m * vec4(pos.xyz, 1.0)).xyz;
-    vert_normal =   (m * vec4(norm, 0.0)).xyz;
+    vert_normal =   (nm * vec4(norm, 0.0)).xyz;
     vert_bary = bary;
 }
 @end
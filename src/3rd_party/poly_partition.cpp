@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "poly_partition.h"
+#include "../budget.h"
 
 
 using namespace std;
@@ -204,6 +205,7 @@ int TPPLPartition::RemoveHoles(TPPLPolyList *inpolys, TPPLPolyList *outpolys) {
 	}
 
 	polys = *inpolys;
+	DrBudget *budget = Dr::ActiveBudget();							// Gives up (returns 0) once active budget runs out
 
 	while(1) {
 		//find the hole point with the largest x
@@ -243,6 +245,7 @@ int TPPLPartition::RemoveHoles(TPPLPolyList *inpolys, TPPLPolyList *outpolys) {
 					v2 = Normalize(bestpolypoint-holepoint);
 					if(v2.x > v1.x) continue;				
 				}
+				if(budget && budget->check()) return 0;
 				pointvisible = true;
 				for(iter2 = polys.begin(); iter2!=polys.end(); iter2++) {
 					if(iter2->IsHole()) continue;
@@ -600,6 +603,7 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, TPPLPolyList *triangles) {
 	for(i=1;i<n;i++) {
 		dpstates[i] = new DPState[i];
 	}
+	DrBudget *budget = Dr::ActiveBudget();							// Gives up (returns 0) once active budget runs out
 
 	//init states and visibility
 	for(i=0;i<(n-1);i++) {
@@ -630,7 +634,8 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, TPPLPolyList *triangles) {
 					continue;
 				}
 
-				for(k=0;k<n;k++) {
+				if(budget && budget->check()) ret = 0;
+				for(k=0;(k<n)&&ret;k++) {
 					p3 = poly->GetPoint(k);
 					if(k==(n-1)) p4 = poly->GetPoint(0);
 					else p4 = poly->GetPoint(k+1);
@@ -646,8 +651,9 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, TPPLPolyList *triangles) {
 	dpstates[n-1][0].weight = 0;
 	dpstates[n-1][0].bestvertex = -1;
 
-	for(gap = 2; gap<n; gap++) {
-		for(i=0; i<(n-gap); i++) {
+	for(gap = 2; (gap<n)&&ret; gap++) {
+		for(i=0; (i<(n-gap))&&ret; i++) {
+			if(budget && budget->check()) { ret = 0; break; }
 			j = i+gap;
 			if(!dpstates[j][i].visible) continue; 
 			bestvertex = -1;
@@ -683,7 +689,7 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, TPPLPolyList *triangles) {
 
 	newdiagonal.index1 = 0;
 	newdiagonal.index2 = n-1;
-	diagonals.push_back(newdiagonal);
+	if(ret) diagonals.push_back(newdiagonal);
 	while(!diagonals.empty()) {
 		diagonal = *(diagonals.begin());
 		diagonals.pop_front();
@@ -1164,6 +1170,7 @@ int TPPLPartition::MonotonePartition(TPPLPolyList *inpolys, TPPLPolyList *monoto
 				newedge.p2 = vertices[v->next].p;
 				newedge.index = vindex;
 				edgeTreeRet = edgeTree.insert(newedge);
+				if (!edgeTreeRet.second) { error = true; break; }         // equal edge already in tree (overlapping edges)
 				edgeTreeIterators[vindex] = edgeTreeRet.first;
 				helpers[vindex] = vindex;
 				break;
@@ -1205,6 +1212,7 @@ int TPPLPartition::MonotonePartition(TPPLPolyList *inpolys, TPPLPolyList *monoto
 				newedge.p2 = vertices[v2->next].p;
 				newedge.index = vindex2;
 				edgeTreeRet = edgeTree.insert(newedge);
+				if (!edgeTreeRet.second) { error = true; break; }         // equal edge already in tree (overlapping edges)
 				edgeTreeIterators[vindex2] = edgeTreeRet.first;
 				helpers[vindex2] = vindex2;
 				break;
@@ -1265,6 +1273,7 @@ int TPPLPartition::MonotonePartition(TPPLPolyList *inpolys, TPPLPolyList *monoto
 					newedge.p2 = vertices[v2->next].p;
 					newedge.index = vindex2;
 					edgeTreeRet = edgeTree.insert(newedge);
+					if (!edgeTreeRet.second) { error = true; break; }         // equal edge already in tree (overlapping edges)
 					edgeTreeIterators[vindex2] = edgeTreeRet.first;
 					helpers[vindex2] = vindex;
 				} else {
@@ -0,0 +1,81 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include "budget.h"
+
+// Active budget of each thread, see DrBudgetScope
+static thread_local DrBudget   *g_active_budget = nullptr;
+
+
+//####################################################################################
+//##    DrBudget
+//####################################################################################
+DrBudget::DrBudget(double milliseconds) {
+    m_start = std::chrono::steady_clock::now();
+    m_has_deadline = (milliseconds > 0.0);
+    m_deadline = m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(milliseconds));
+}
+
+double DrBudget::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+bool DrBudget::check() {
+    if (m_expired) return true;
+    if (--m_countdown > 0) return false;
+    return expired();
+}
+
+bool DrBudget::expired() {
+    if (m_expired) return true;
+    m_countdown = c_budget_check_interval;
+    if (m_cancelled.load(std::memory_order_relaxed) || (m_has_deadline && std::chrono::steady_clock::now() >= m_deadline)) {
+        m_expired = true;
+        expired_in = stage;
+    }
+    return m_expired;
+}
+
+
+//####################################################################################
+//##    DrBudgetScope
+//####################################################################################
+DrBudgetScope::DrBudgetScope(DrBudget *budget) : m_previous(g_active_budget) {
+    g_active_budget = budget;
+}
+
+DrBudgetScope::~DrBudgetScope() {
+    g_active_budget = m_previous;
+}
+
+
+namespace Dr
+{
+
+//####################################################################################
+//##    Active budget checks
+//####################################################################################
+DrBudget* ActiveBudget() {
+    return g_active_budget;
+}
+
+bool BudgetCheck() {
+    return (g_active_budget != nullptr) && g_active_budget->check();
+}
+
+bool BudgetExpired() {
+    return (g_active_budget != nullptr) && g_active_budget->expired();
+}
+
+void BudgetStage(Budget_Stage stage) {
+    if (g_active_budget != nullptr) g_active_budget->stage = stage;
+}
+
+
+}   // End namespace Dr
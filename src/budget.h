@@ -0,0 +1,98 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef ENGINE_BUDGET_H
+#define ENGINE_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+
+// Constants
+const int   c_budget_check_interval =   4096;       // Hot loop checks between reads of the clock, see DrBudget::check()
+
+// Stage a budget ran out in
+enum class Budget_Stage {
+    None,                                   // Didn't run out
+    Finding_Objects,                        // Labeling / flood fills, image falls back to one box (DrImage::setSimpleBox())
+    Tracing,                                // Outlines, objects not traced yet fall back to boxes of their bounds
+    Triangulating,                          // Faces not triangulated yet fall back to monotone triangulation
+};
+
+
+//####################################################################################
+//##    DrBudget
+//##        Cancellation token and deadline for the work of one image. Install it on the thread doing the work with
+//##        DrBudgetScope, long loops (flood fills, labeling, tracing, triangulation) check it cooperatively and the
+//##        pipeline falls back to cheaper output once it runs out. cancel() can be called from any thread, checks and
+//##        progress counters belong to the thread running the work (one at a time).
+//##
+//##        Usage:  DrBudget budget(50.0);                  // 50 ms, 0 for no deadline (cancel() only)
+//##                { DrBudgetScope scope(&budget);  DrImage image("name", bitmap, lod);  ...extrude... }
+//##                if (budget.expired_in != Budget_Stage::None) ...report budget.objects_boxed, ...
+//############################
+class DrBudget
+{
+private:
+    std::atomic<bool>                       m_cancelled         { false };
+    bool                                    m_expired           { false };          // Sticky, once out of budget stays out
+    bool                                    m_has_deadline      { false };
+    int                                     m_countdown         { c_budget_check_interval };
+    std::chrono::steady_clock::time_point   m_start;
+    std::chrono::steady_clock::time_point   m_deadline;
+
+public:
+    // Progress, filled in by stages run under this budget
+    Budget_Stage    stage               { Budget_Stage::None };                     // Stage running now
+    Budget_Stage    expired_in          { Budget_Stage::None };                     // Stage running when budget ran out
+    int             objects_found       { 0 };
+    int             objects_traced      { 0 };                                      // Objects with a traced outline
+    int             objects_boxed       { 0 };                                      // Objects that fell back to a box
+    int             faces_triangulated  { 0 };                                      // Faces triangulated as asked
+    int             faces_fallback      { 0 };                                      // Faces that fell back to monotone triangulation
+
+public:
+    explicit DrBudget(double milliseconds = 0.0);
+
+    void            cancel()                { m_cancelled.store(true); }
+    bool            cancelled() const       { return m_cancelled.load(); }
+    double          elapsedMs() const;
+
+    bool            check();                                                        // Hot loops, reads clock every c_budget_check_interval calls
+    bool            expired();                                                      // Stage boundaries, always reads clock
+};
+
+
+//####################################################################################
+//##    DrBudgetScope
+//##        Makes a budget the active budget of the current thread for the life of the scope (scopes nest)
+//############################
+class DrBudgetScope
+{
+private:
+    DrBudget       *m_previous;
+
+public:
+    explicit DrBudgetScope(DrBudget *budget);
+    ~DrBudgetScope();
+    DrBudgetScope(const DrBudgetScope&) = delete;
+    DrBudgetScope& operator=(const DrBudgetScope&) = delete;
+};
+
+
+//####################################################################################
+//##    Checks of active budget, all return false (and do nothing) when no budget is active on this thread
+//############################
+namespace Dr {
+    DrBudget*   ActiveBudget();
+    bool        BudgetCheck();                                                      // Inside long loops
+    bool        BudgetExpired();                                                    // Between stages / objects
+    void        BudgetStage(Budget_Stage stage);
+}
+
+#endif // ENGINE_BUDGET_H
@@ -0,0 +1,423 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Content addressed cache of outlines / meshes (.extc)
+//
+//  Layout (native byte order, a file from a host of the other byte order fails the version check):
+//      Header          magic "EXTC", version, key, payload size / hash, object count, level count
+//      Outlines        per object: point count, points (x, y as doubles), hole count, holes (point count, points)
+//      Levels          per level: byte count, mesh file data (.extm)
+//
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <process.h>
+    #include <sys/stat.h>
+    #include <sys/utime.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+#include "extrude_cache.h"
+#include "instrument.h"
+
+// Local Constants
+const char      c_cache_magic[4] =      { 'E', 'X', 'T', 'C' };
+const uint32_t  c_cache_file_version =  1;
+const char     *c_cache_extension =     ".extc";
+const char     *c_temp_extension =      ".tmp";
+const int64_t   c_temp_file_age =       600;        // Seconds, younger temporary files may still be written by another process
+
+// File Structures
+struct CacheFileHeader {
+    char        magic[4];
+    uint32_t    version;
+    uint64_t    key;
+    uint64_t    payload_bytes;                                      // Bytes after header
+    uint64_t    payload_hash;
+    uint32_t    object_count;
+    uint32_t    level_count;
+};
+
+// Temporary file names need to be unique across threads and processes sharing a cache directory
+static std::atomic<unsigned int> g_temp_count { 0 };
+
+
+//####################################################################################
+//##    Hashing, 64 bit, 8 bytes at a time (MurmurHash3 style mixing and finalizer)
+//####################################################################################
+class CacheHash
+{
+private:
+    uint64_t    m_hash;
+    uint64_t    m_length    { 0 };
+
+    static uint64_t rotate(uint64_t value, int bits)    { return (value << bits) | (value >> (64 - bits)); }
+    void mixWord(uint64_t word) {
+        word *= 0x87c37b91114253d5ull;
+        word =  rotate(word, 31);
+        word *= 0x4cf5ad432745937full;
+        m_hash ^= word;
+        m_hash =  rotate(m_hash, 27) * 5 + 0x52dce729;
+    }
+
+public:
+    CacheHash(uint64_t seed = 0) : m_hash(seed) { }
+
+    void add(const void *data, size_t bytes) {
+        const unsigned char *input = static_cast<const unsigned char*>(data);
+        size_t words = bytes / 8;
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t word;
+            memcpy(&word, input + w * 8, 8);
+            mixWord(word);
+        }
+        uint64_t tail = 0;
+        if (bytes % 8 > 0) {
+            memcpy(&tail, input + words * 8, bytes % 8);
+            mixWord(tail);
+        }
+        m_length += bytes;
+    }
+    template <class T> void addValue(const T &value) { add(&value, sizeof(T)); }
+
+    uint64_t result() const {
+        uint64_t hash = m_hash ^ m_length;
+        hash ^= hash >> 33;     hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;     hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+};
+
+
+//####################################################################################
+//##    File Helpers
+//####################################################################################
+static bool isCacheFile(const std::string &name) {
+    return name.find(c_cache_extension) != std::string::npos;                      // Includes temporary files, see store()
+}
+
+struct CacheFileInfo {
+    std::string     path;
+    uint64_t        bytes;
+    int64_t         time;                                                           // Last modified, seconds
+    bool            temporary;                                                      // Being written, or left by a crash
+};
+
+static std::vector<CacheFileInfo> listCacheFiles(const std::string &directory) {
+    std::vector<std::string> names;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA found;
+    HANDLE handle = FindFirstFileA((directory + "/*").c_str(), &found);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            if ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0 && isCacheFile(found.cFileName)) names.push_back(found.cFileName);
+        } while (FindNextFileA(handle, &found));
+        FindClose(handle);
+    }
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir != nullptr) {
+        while (struct dirent *entry = readdir(dir)) {
+            if (isCacheFile(entry->d_name)) names.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+#endif
+
+    std::vector<CacheFileInfo> files;
+    for (const auto &name : names) {
+        CacheFileInfo info;
+        info.path = directory + "/" + name;
+        info.temporary = (name.find(std::string(c_cache_extension) + c_temp_extension) != std::string::npos);
+#if defined(_WIN32)
+        struct _stat64 status;
+        if (_stat64(info.path.c_str(), &status) != 0) continue;
+#else
+        struct stat status;
+        if (stat(info.path.c_str(), &status) != 0 || S_ISREG(status.st_mode) == false) continue;
+#endif
+        info.bytes = static_cast<uint64_t>(status.st_size);
+        info.time =  static_cast<int64_t>(status.st_mtime);
+        files.push_back(info);
+    }
+    return files;
+}
+
+// Replaces 'to' with 'from' in one step, readers see old or new file, never part of one
+static bool replaceFile(const std::string &from, const std::string &to) {
+#if defined(_WIN32)
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+static void touchFile(const std::string &path) {
+#if defined(_WIN32)
+    _utime(path.c_str(), nullptr);
+#else
+    utime(path.c_str(), nullptr);
+#endif
+}
+
+static unsigned int processId() {
+#if defined(_WIN32)
+    return static_cast<unsigned int>(_getpid());
+#else
+    return static_cast<unsigned int>(getpid());
+#endif
+}
+
+
+//####################################################################################
+//##    Constructor / Keys
+//####################################################################################
+size_t DrCacheEntry::bytes() const {
+    size_t total = 0;
+    for (const auto &level : level_files) total += level.size();
+    return total;
+}
+
+DrExtrudeCache::DrExtrudeCache(std::string directory, uint64_t max_bytes)
+    : m_directory(std::move(directory)), m_max_bytes(max_bytes) {
+    while (m_directory.size() > 1 && (m_directory.back() == '/' || m_directory.back() == '\\')) m_directory.pop_back();
+    if (m_directory.size() == 0) m_directory = ".";
+}
+
+// Only alpha is hashed, rows are read through the view so any stride / channel count gives the same key
+uint64_t DrExtrudeCache::key(const DrBitmapView &bitmap, const DrExtrudeSettings &settings) {
+    DR_TIME_SCOPE("DrExtrudeCache::key");
+    CacheHash hash(c_extrude_version);
+    hash.addValue(bitmap.width);
+    hash.addValue(bitmap.height);
+    if (bitmap.isValid()) {
+        std::vector<unsigned char> alpha(bitmap.channels == 1 ? 0 : bitmap.width);
+        for (int y = 0; y < bitmap.height; ++y) {
+            const unsigned char *row = bitmap.row(y);
+            if (bitmap.channels == 1) { hash.add(row, bitmap.width); continue; }
+            for (int x = 0; x < bitmap.width; ++x) alpha[x] = row[x * bitmap.channels + (bitmap.channels - 1)];
+            hash.add(&alpha[0], alpha.size());
+        }
+    }
+
+    hash.addValue(settings.alpha_tolerance);
+    hash.addValue(settings.outline_detail);
+    hash.addValue(settings.quality);
+    hash.addValue(settings.depth);
+    hash.addValue(static_cast<int>(settings.profile));
+    hash.addValue(settings.profile_size);
+    hash.addValue(static_cast<int>(settings.triangulation));
+    hash.addValue(static_cast<int>(settings.smooth_normals));
+    hash.addValue(settings.levels);
+    hash.addValue(settings.triangle_ratio);
+    hash.addValue(settings.target_error);
+    hash.addValue(static_cast<int>(settings.allow_sloppy));
+    hash.addValue(static_cast<uint32_t>(sizeof(Vertex)));
+    return hash.result();
+}
+
+std::string DrExtrudeCache::path(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_directory + "/" + name + c_cache_extension;
+}
+
+
+//####################################################################################
+//##    Loading / Storing
+//####################################################################################
+bool DrExtrudeCache::load(uint64_t key, DrCacheEntry &entry) {
+    DR_TIME_SCOPE("DrExtrudeCache::load");
+    std::string file_path = path(key);
+    FILE *file = fopen(file_path.c_str(), "rb");
+    if (file == nullptr) return false;
+
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    std::vector<unsigned char> file_data((file_size > 0) ? static_cast<size_t>(file_size) : 0);
+    size_t read = (file_data.size() > 0) ? fread(&file_data[0], 1, file_data.size(), file) : 0;
+    fclose(file);
+    if (read != file_data.size() || read == 0) return false;
+
+    if (decodeEntry(key, &file_data[0], file_data.size(), entry) == false) return false;
+    touchFile(file_path);
+    return true;
+}
+
+bool DrExtrudeCache::store(uint64_t key, const DrCacheEntry &entry) {
+    DR_TIME_SCOPE("DrExtrudeCache::store");
+    std::vector<unsigned char> file_data;
+    encodeEntry(key, entry, file_data);
+
+    std::string file_path = path(key);
+    std::string temp_path = file_path + c_temp_extension + std::to_string(processId()) + "_" + std::to_string(g_temp_count++);
+    FILE *file = fopen(temp_path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool written = (fwrite(file_data.data(), 1, file_data.size(), file) == file_data.size());
+    written = (fclose(file) == 0) && written;
+    if (written == false || replaceFile(temp_path, file_path) == false) {
+        remove(temp_path.c_str());
+        return false;
+    }
+    evict();
+    return true;
+}
+
+// Removes oldest entries (last stored / loaded) until cache fits in max bytes. Temporary files younger than
+// c_temp_file_age are left alone (and not counted), another process may still be writing them
+uint64_t DrExtrudeCache::evict() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<CacheFileInfo> files = listCacheFiles(m_directory);
+    int64_t now = static_cast<int64_t>(time(nullptr));
+    files.erase(std::remove_if(files.begin(), files.end(), [now](const CacheFileInfo &file) {
+        return file.temporary && (now - file.time) < c_temp_file_age;
+    }), files.end());
+    uint64_t total = 0;
+    for (const auto &file : files) total += file.bytes;
+    if (total <= m_max_bytes) return total;
+
+    std::sort(files.begin(), files.end(), [](const CacheFileInfo &a, const CacheFileInfo &b) {
+        return (a.time < b.time) || (a.time == b.time && a.path < b.path);
+    });
+    for (const auto &file : files) {
+        if (total <= m_max_bytes) break;
+        if (remove(file.path.c_str()) == 0) total -= file.bytes;
+    }
+    return total;
+}
+
+
+//####################################################################################
+//##    Serialization
+//####################################################################################
+template <class T> static void writeValue(std::vector<unsigned char> &data, const T &value) {
+    size_t at = data.size();
+    data.resize(at + sizeof(T));
+    memcpy(&data[at], &value, sizeof(T));
+}
+
+static void writePoints(std::vector<unsigned char> &data, const std::vector<DrPointF> &points) {
+    writeValue(data, static_cast<uint32_t>(points.size()));
+    for (const auto &point : points) {
+        writeValue(data, point.x);
+        writeValue(data, point.y);
+    }
+}
+
+// Reads from a byte range, any read past end fails and leaves reader failed
+class CacheReader
+{
+public:
+    const unsigned char    *data;
+    size_t                  size;
+    size_t                  at      { 0 };
+    bool                    failed  { false };
+
+    CacheReader(const unsigned char *data_, size_t size_) : data(data_), size(size_) { }
+
+    template <class T> T value() {
+        T result { };
+        if (failed || size - at < sizeof(T)) { failed = true; return result; }
+        memcpy(&result, data + at, sizeof(T));
+        at += sizeof(T);
+        return result;
+    }
+
+    bool points(std::vector<DrPointF> &points) {
+        uint32_t count = value<uint32_t>();
+        if (failed || (size - at) / (sizeof(double) * 2) < count) { failed = true; return false; }
+        points.resize(count);
+        for (auto &point : points) {
+            point.x = value<double>();
+            point.y = value<double>();
+        }
+        return (failed == false);
+    }
+};
+
+void DrExtrudeCache::encodeEntry(uint64_t key, const DrCacheEntry &entry, std::vector<unsigned char> &file_data) {
+    file_data.assign(sizeof(CacheFileHeader), 0);
+    for (size_t object = 0; object < entry.poly_list.size(); object++) {
+        writePoints(file_data, entry.poly_list[object]);
+        const std::vector<std::vector<DrPointF>> no_holes;
+        const auto &holes = (object < entry.hole_list.size()) ? entry.hole_list[object] : no_holes;
+        writeValue(file_data, static_cast<uint32_t>(holes.size()));
+        for (const auto &hole : holes) writePoints(file_data, hole);
+    }
+    for (const auto &level : entry.level_files) {
+        writeValue(file_data, static_cast<uint64_t>(level.size()));
+        file_data.insert(file_data.end(), level.begin(), level.end());
+    }
+
+    CacheFileHeader header;
+    memcpy(header.magic, c_cache_magic, sizeof(header.magic));
+    header.version =        c_cache_file_version;
+    header.key =            key;
+    header.payload_bytes =  file_data.size() - sizeof(CacheFileHeader);
+    CacheHash payload;
+    payload.add(file_data.data() + sizeof(CacheFileHeader), static_cast<size_t>(header.payload_bytes));
+    header.payload_hash =   payload.result();
+    header.object_count =   static_cast<uint32_t>(entry.poly_list.size());
+    header.level_count =    static_cast<uint32_t>(entry.level_files.size());
+    memcpy(&file_data[0], &header, sizeof(CacheFileHeader));
+}
+
+bool DrExtrudeCache::decodeEntry(uint64_t key, const unsigned char *file_data, size_t file_size, DrCacheEntry &entry) {
+    // ***** Verify header and payload
+    if (file_data == nullptr || file_size < sizeof(CacheFileHeader)) return false;
+    CacheFileHeader header;
+    memcpy(&header, file_data, sizeof(CacheFileHeader));
+    if (memcmp(header.magic, c_cache_magic, sizeof(header.magic)) != 0)    return false;
+    if (header.version != c_cache_file_version || header.key != key)        return false;
+    if (header.payload_bytes != file_size - sizeof(CacheFileHeader))        return false;
+    CacheHash payload;
+    payload.add(file_data + sizeof(CacheFileHeader), static_cast<size_t>(header.payload_bytes));
+    if (payload.result() != header.payload_hash)                            return false;
+
+    // ***** Outlines, then mesh file data of each level
+    // Each object needs at least its point and hole counts, each level its byte count, check before allocating
+    uint64_t least_bytes = static_cast<uint64_t>(header.object_count) * (sizeof(uint32_t) * 2) +
+                           static_cast<uint64_t>(header.level_count)  *  sizeof(uint64_t);
+    if (least_bytes > header.payload_bytes)                                 return false;
+
+    CacheReader reader(file_data + sizeof(CacheFileHeader), static_cast<size_t>(header.payload_bytes));
+    DrCacheEntry result;
+    result.poly_list.resize(header.object_count);
+    result.hole_list.resize(header.object_count);
+    for (uint32_t object = 0; object < header.object_count && reader.failed == false; object++) {
+        reader.points(result.poly_list[object]);
+        uint32_t hole_count = reader.value<uint32_t>();
+        if (reader.failed || hole_count > (reader.size - reader.at) / sizeof(uint32_t)) return false;
+        result.hole_list[object].resize(hole_count);
+        for (auto &hole : result.hole_list[object]) reader.points(hole);
+    }
+    result.level_files.resize(header.level_count);
+    for (auto &level : result.level_files) {
+        uint64_t bytes = reader.value<uint64_t>();
+        if (reader.failed || bytes > reader.size - reader.at) return false;
+        level.assign(reader.data + reader.at, reader.data + reader.at + bytes);
+        reader.at += static_cast<size_t>(bytes);
+    }
+    if (reader.failed || reader.at != reader.size) return false;
+
+    entry = std::move(result);
+    return true;
+}
@@ -0,0 +1,98 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef ENGINE_EXTRUDE_CACHE_H
+#define ENGINE_EXTRUDE_CACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mesh.h"
+#include "types/bitmap_view.h"
+#include "types/image.h"
+#include "types/pointf.h"
+
+// Constants
+const uint32_t  c_extrude_version =     2;          // Part of every cache key, bump when outlines / meshes for same settings change
+
+
+//####################################################################################
+//##    DrExtrudeSettings
+//##        Every setting that changes outlines or meshes of an image, all are hashed into cache keys.
+//##        Things that don't change output (tile size, worker count) are left out.
+//############################
+struct DrExtrudeSettings {
+    double              alpha_tolerance     { c_alpha_tolerance };
+    float               outline_detail      { 0.25f };                              // Level of detail passed to DrImage
+    int                 quality             { 8 };
+    float               depth               { 1.f };                                // Depth multiplier, in pixels
+    Side_Profile        profile             { Side_Profile::Flat };
+    float               profile_size        { 0.f };
+    Trianglulation      triangulation       { Trianglulation::Triangulate_Opt };
+    bool                smooth_normals      { false };
+    int                 levels              { 1 };                                  // Level of detail chain
+    float               triangle_ratio      { 0.5f };
+    float               target_error        { 0.05f };
+    bool                allow_sloppy        { false };
+};
+
+//####################################################################################
+//##    DrCacheEntry
+//##        Everything kept for one image, outlines as traced and meshes as mesh file data
+//############################
+struct DrCacheEntry {
+    std::vector<std::vector<DrPointF>>                  poly_list;                  // Same as DrImage::m_poly_list
+    std::vector<std::vector<std::vector<DrPointF>>>     hole_list;                  // Same as DrImage::m_hole_list
+    std::vector<std::vector<unsigned char>>             level_files;                // Mesh file (.extm) data per level, see DrMesh::encodeMeshes()
+
+    size_t      bytes() const;
+};
+
+
+//####################################################################################
+//##    DrExtrudeCache
+//##        Content addressed cache on disk, one file per key ("<key>.extc") in cache directory. Keys are a
+//##        64 bit hash of the alpha plane (only alpha changes output), image size, settings and c_extrude_version.
+//##        Files are written to a temporary name and renamed into place, so readers never see a partial entry
+//##        (other processes can share the directory). After each store least recently used entries (by file time,
+//##        refreshed on every hit) are removed until the directory fits in max_bytes. Temporary files are only removed
+//##        once they are old enough to be left by a crash, not while another process may still be writing them.
+//##
+//##        Usage:  DrExtrudeCache cache("cache/", 512 << 20);
+//##                uint64_t key = DrExtrudeCache::key(bitmap, settings);
+//##                if (cache.load(key, entry) == false) { ...extrude, fill entry...; cache.store(key, entry); }
+//############################
+class DrExtrudeCache
+{
+private:
+    std::string         m_directory;
+    uint64_t            m_max_bytes;
+    std::mutex          m_mutex;                                                    // One store / eviction at a time per cache
+
+public:
+    DrExtrudeCache(std::string directory, uint64_t max_bytes);
+
+    // Keys
+    static uint64_t     key(const DrBitmapView &bitmap, const DrExtrudeSettings &settings);
+    std::string         path(uint64_t key) const;
+
+    // Entries, both return false on failure (missing / corrupt entry, or write error), store is thread safe
+    bool                load(uint64_t key, DrCacheEntry &entry);
+    bool                store(uint64_t key, const DrCacheEntry &entry);
+    uint64_t            evict();                                                    // Returns bytes left in cache
+
+    // Serialization
+    static void         encodeEntry(uint64_t key, const DrCacheEntry &entry, std::vector<unsigned char> &file_data);
+    static bool         decodeEntry(uint64_t key, const unsigned char *file_data, size_t file_size, DrCacheEntry &entry);
+};
+
+
+#endif // ENGINE_EXTRUDE_CACHE_H
@@ -11,7 +11,10 @@
 #define IMAGE_FILTER_H
 
 #include "types/bitmap.h"
+#include "types/bitmap_view.h"
+#include "types/point.h"
 #include "types/pointf.h"
+#include "types/rect.h"
 
 
 // Filters types
@@ -31,6 +34,22 @@ enum class Flood_Fill_Type {
     Compare_8,
 };
 
+enum class Stress_Pattern {                 // GenerateStressBitmap worst cases
+    Specks,                                 //      Thousands of 1 to 3 pixel objects
+    Blob,                                   //      One object covering most of the image
+    Rings,                                  //      Concentric rings, deeply nested holes
+    Coastline,                              //      Fractal outline, very long contour
+    Checkerboard,                           //      Squares touching only diagonally
+    Noise,                                  //      Random alpha per pixel
+};
+
+// Object found by FindObjectBoundsTiled() / FindObjectBoundsTouching(), copy pixels out with ObjectBitmap()
+struct DrObjectBounds {
+    DrRect      rect;                       // Bounds of object pixels
+    DrPoint     seed;                       // First object pixel in column order
+    int         pixel_count     { 0 };
+};
+
 
 //####################################################################################
 //##    Image editing / object finding
@@ -43,19 +62,30 @@ namespace Dr {
     // ***** Comparison
     bool        CompareBitmaps(const DrBitmap &bitmap1, const DrBitmap &bitmap2);
 
-    // ***** Object Counting / Fill (a la Ravens Project)
-    DrBitmap    BlackAndWhiteFromAlpha(const DrBitmap &bitmap, double alpha_tolerance, bool inverse, 
+    // ***** Object Counting / Fill (a la Ravens Project), sources are read through views (no copy of a DrBitmap / decoded buffer)
+    DrRect      AlphaBounds(const DrBitmapView &bitmap, double alpha_tolerance);
+    DrBitmap    BlackAndWhiteFromAlpha(const DrBitmapView &bitmap, double alpha_tolerance, bool inverse, 
                                        Bitmap_Format desired_format = Bitmap_Format::ARGB);
     void        FillBorder(DrBitmap &bitmap, DrColor fill_color, DrRect rect);
-    bool        FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps, std::vector<DrRect> &rects, 
+    bool        FindObjectsInBitmap(const DrBitmapView &bitmap, std::vector<DrBitmap> &bitmaps, std::vector<DrRect> &rects, 
                                     double alpha_tolerance, bool convert = true);
     DrBitmap    FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, double tolerance, Flood_Fill_Type type,
                           int &flood_pixel_count, DrRect &flood_rect);
 
+    // ***** Tiled Object Finding, for images too large for a full size working copy (see imaging_tiled.cpp)
+    std::vector<DrObjectBounds> FindObjectBoundsTiled(const DrBitmapView &bitmap, double alpha_tolerance, int tile_size);
+    void                        ObjectBitmap(const DrBitmapView &bitmap, const DrObjectBounds &object, double alpha_tolerance, DrRect &rect,
+                                             DrBitmap &object_bitmap);
+    std::vector<DrObjectBounds> FindObjectBoundsTouching(const DrBitmapView &bitmap, DrRect region, double alpha_tolerance,
+                                                         std::vector<unsigned char> &visited);
+
     // ***** Outlining
     std::vector<DrPointF>       OutlinePointList(const DrBitmap &bitmap);
     std::vector<DrPointF>       TraceImageOutline(const DrBitmap &bitmap);
 
+    // ***** Stress Testing
+    DrBitmap    GenerateStressBitmap(Stress_Pattern pattern, int size, unsigned int seed = 0);
+
 }
 
 #endif // IMAGE_FILTER_H
@@ -7,14 +7,24 @@
 // Copyright (c) 2021 Stephens Nunnally and Scidian Software
 //
 //
+#include <algorithm>
+#include <utility>
+
 #include "3rd_party/stb/stb_image_write.h"
+#include "budget.h"
 #include "compare.h"
 #include "imaging.h"
+#include "instrument.h"
 #include "types/color.h"
 #include "types/point.h"
 #include "types/pointf.h"
 #include "types/rect.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DR_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 
 namespace Dr
 {
@@ -35,23 +45,104 @@ bool CompareBitmaps(const DrBitmap &bitmap1, const DrBitmap &bitmap2) {
 }
 
 
+//####################################################################################
+//##    Alpha Bounds
+//##        Returns smallest rect holding every pixel with alpha at or above alpha_tolerance (same test as
+//##        BlackAndWhiteFromAlpha), empty rect if there are none. Rows are searched inward from both ends, with SSE2
+//##        16 bytes (4 ARGB / 16 grayscale pixels) are tested at a time, so cost follows the transparent margins.
+//####################################################################################
+// Index of first / last pixel in [begin, end) with alpha >= threshold, or -1
+static int firstVisible(const DrBitmapView &bitmap, const unsigned char *row, int begin, int end, int threshold) {
+    int channels = bitmap.channels;
+    int x = begin;
+#if defined(DR_USE_SSE2)
+    int per_load = 16 / channels;
+    int alpha_mask = (channels == 4) ? 0x8888 : 0xFFFF;
+    __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    for (; x + per_load <= end; x += per_load) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * channels));
+        int     hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(pixels, limit), pixels)) & alpha_mask;
+        if (hits != 0) {
+            int bit = 0;
+            while ((hits & (1 << bit)) == 0) bit++;
+            return x + bit / channels;
+        }
+    }
+#endif
+    for (; x < end; x++) if (row[x * channels + (channels - 1)] >= threshold) return x;
+    return -1;
+}
+
+static int lastVisible(const DrBitmapView &bitmap, const unsigned char *row, int begin, int end, int threshold) {
+    int channels = bitmap.channels;
+    int x = end;
+#if defined(DR_USE_SSE2)
+    int per_load = 16 / channels;
+    int alpha_mask = (channels == 4) ? 0x8888 : 0xFFFF;
+    __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    for (; x - per_load >= begin; x -= per_load) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + (x - per_load) * channels));
+        int     hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(pixels, limit), pixels)) & alpha_mask;
+        if (hits != 0) {
+            int bit = 15;
+            while ((hits & (1 << bit)) == 0) bit--;
+            return (x - per_load) + bit / channels;
+        }
+    }
+#endif
+    for (x = x - 1; x >= begin; x--) if (row[x * channels + (channels - 1)] >= threshold) return x;
+    return -1;
+}
+
+DrRect AlphaBounds(const DrBitmapView &bitmap, double alpha_tolerance) {
+    if (bitmap.isValid() == false) return DrRect(0, 0, 0, 0);
+    int threshold = static_cast<int>(alpha_tolerance * 255.0);
+    int top = -1, bottom = -1, left = bitmap.width, right = -1;
+    for (int y = 0; y < bitmap.height; ++y) {
+        const unsigned char *row = bitmap.row(y);
+        int first = firstVisible(bitmap, row, 0, left, threshold);                     // Only left of current bounds
+        if (first >= 0) left = first;
+        int last =  lastVisible(bitmap, row, left, bitmap.width, threshold);            // Stops at right most visible pixel
+        if (last < 0) continue;
+        if (last > right) right = last;
+        if (top < 0) top = y;
+        bottom = y;
+    }
+    if (top < 0) return DrRect(0, 0, 0, 0);
+    return DrRect(left, top, (right - left) + 1, (bottom - top) + 1);
+}
+
+
 //####################################################################################
 //##    Returns black / white image (binary)
 //##        alpha_tolerance is from 0.0 to 1.0
 //##        NORMAL  (inverse == false): transparent areas are black, objects are white
 //##        INVERSE (inverse == true) : transparent areas are white, objects are black
 //####################################################################################
-DrBitmap BlackAndWhiteFromAlpha(const DrBitmap &bitmap, double alpha_tolerance, bool inverse, Bitmap_Format desired_format) {
+DrBitmap BlackAndWhiteFromAlpha(const DrBitmapView &bitmap, double alpha_tolerance, bool inverse, Bitmap_Format desired_format) {
     DrColor color1 = Dr::transparent;
     DrColor color2 = Dr::white;
     if (inverse) Dr::Swap(color1, color2);
 
-    DrBitmap black_white(bitmap, desired_format);
+    DrBitmap black_white(bitmap.width, bitmap.height, desired_format);
+    if (bitmap.isValid() == false) return black_white;
     int alpha_i = static_cast<int>(alpha_tolerance * 255.0);
 
-    for (int x = 0; x < bitmap.width; ++x) {
-        for (int y = 0; y < bitmap.height; ++y) {
-            black_white.setPixel(x, y, ((bitmap.getPixel(x, y).alpha() < alpha_i) ? color1 : color2));
+    // Transparent / white are the same value in every byte, so output is written a row at a time (1 byte per pixel for
+    // Grayscale, 4 for ARGB)
+    unsigned char value1 = color1.alpha(), value2 = color2.alpha();
+    unsigned char *out = &black_white.data[0];
+    for (int y = 0; y < bitmap.height; ++y) {
+        const unsigned char *alpha = bitmap.row(y) + (bitmap.channels - 1);
+        if (black_white.channels == 1) {
+            for (int x = 0; x < bitmap.width; ++x) out[x] = (alpha[x * bitmap.channels] < alpha_i) ? value1 : value2;
+            out += bitmap.width;
+        } else {
+            for (int x = 0; x < bitmap.width; ++x) {
+                unsigned char value = (alpha[x * bitmap.channels] < alpha_i) ? value1 : value2;
+                out[0] = value;     out[1] = value;     out[2] = value;     out[3] = value;
+                out += 4;
+            }
         }
     }
     return black_white;
@@ -61,12 +152,13 @@ DrBitmap BlackAndWhiteFromAlpha(const DrBitmap &bitmap, double alpha_tolerance,
 //####################################################################################
 //##    Flood Fill
 /// @brief      Fills in an area of similar colored pixels starting at (at_x, at_y) with (fill_color)
-/// @returns    DrBitmap as new image of flood
+/// @returns    DrBitmap as new image of flood, same format as (bitmap)
 /// @ref    (bitmap):               Image passed in to be flooded, is altered during function
 /// @value  (tolerance):            Percentage of how similar color should be to continue to fill, 0.0 to 1.0
 /// @value  (type):                 Specifies algorithm used to compare neighbors during fill routine
 /// @ref    (flood_pixel_count):    Number of total pixels in flood
 /// @ref    (flood_rect):           Bounding box of fill area
+/// @note   Stops early (flood is partial) when active budget runs out, see DrBudget
 //####################################################################################
 #define FLOOD_NOT_PROCESSED         0
 #define FLOOD_WAS_PROCESSED         1
@@ -75,10 +167,13 @@ DrBitmap BlackAndWhiteFromAlpha(const DrBitmap &bitmap, double alpha_tolerance,
 DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, double tolerance, Flood_Fill_Type type,
                    int &flood_pixel_count, DrRect &flood_rect) {
     flood_pixel_count = 0;
+    DR_COUNT(Flood_Fills, 1);
 
-    // Get scan lines
-    DrBitmap flood(bitmap);
-    DrBitmap processed(bitmap);
+    // Flood starts empty, processed flags are one byte per pixel whatever the format of bitmap
+    DrBitmap flood(bitmap.width, bitmap.height, bitmap.format);
+    std::vector<unsigned char> processed(static_cast<size_t>(bitmap.width) * static_cast<size_t>(bitmap.height), FLOOD_NOT_PROCESSED);
+    DR_COUNT(Bytes_Allocated, flood.size() + processed.size());
+    auto flag = [&processed, &bitmap](int x, int y) -> unsigned char& { return processed[static_cast<size_t>(y) * bitmap.width + x]; };
 
     // Check if start point is in range
     flood_rect = DrRect(0, 0, 0, 0);
@@ -93,16 +188,9 @@ DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, dou
         return flood;
     }
 
-    // Get starting color, set processed image to all zeros
+    // Get starting color
     DrColor start_color = bitmap.getPixel(at_x, at_y);
 
-    for (int x = 0; x < bitmap.width; ++x) {
-        for (int y = 0; y < bitmap.height; ++y) {
-            flood.setPixel(x, y, 0);
-            processed.setPixel(x, y, FLOOD_NOT_PROCESSED);
-        }
-    }
-
     // Push starting point onto vector
     std::vector<DrPoint> points;
     points.clear();
@@ -115,12 +203,13 @@ DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, dou
         // Go through each point and find new points to fill
         processed_some = false;
         for (int p = 0; p < points.size(); ++p) {
+            if (Dr::BudgetCheck()) { points.clear(); break; }
             DrPoint point = points[p];
             
-            if (processed.getPixel(point.x, point.y) == FLOOD_WAS_PROCESSED) continue;
+            if (flag(point.x, point.y) == FLOOD_WAS_PROCESSED) continue;
             bitmap.setPixel(point.x, point.y, fill_color);
             flood.setPixel(point.x, point.y, fill_color);
-            processed.setPixel(point.x, point.y, FLOOD_WAS_PROCESSED);
+            flag(point.x, point.y) = FLOOD_WAS_PROCESSED;
             if (point.x < min_x) min_x = point.x;
             if (point.x > max_x) max_x = point.x;
             if (point.y < min_y) min_y = point.y;
@@ -143,10 +232,10 @@ DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, dou
                         if ( (x == point.x + 1) && (y == point.y + 1) ) continue;
                     }
 
-                    if (processed.getPixel(x, y) == FLOOD_NOT_PROCESSED) {
+                    if (flag(x, y) == FLOOD_NOT_PROCESSED) {
                         if (Dr::IsSameColor(start_color, bitmap.getPixel(x, y), tolerance)) {
                             points.push_back(DrPoint(x, y));
-                            processed.setPixel(x, y, FLOOD_MARKED_FOR_PROCESS);
+                            flag(x, y) = FLOOD_MARKED_FOR_PROCESS;
                             processed_some = true;
                         }
                     }
@@ -154,14 +243,10 @@ DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, dou
             }
         }
 
-        // Remove any points that have been processed
-        auto it = points.begin();
-        while (it != points.end()) {
-            if (processed.getPixel(it->x, it->y) == FLOOD_WAS_PROCESSED)
-                it = points.erase(it);
-            else
-                ++it;
-        }
+        // Remove any points that have been processed (single pass, erasing one at a time is quadratic in flood size)
+        points.erase(std::remove_if(points.begin(), points.end(), [&flag](const DrPoint &point) {
+            return flag(point.x, point.y) == FLOOD_WAS_PROCESSED;
+        }), points.end());
     } while ((points.size() > 0) && processed_some);
 
     flood_rect = DrRect(min_x, min_y, (max_x - min_x) + 1, (max_y - min_y) + 1);
@@ -175,32 +260,46 @@ DrBitmap FloodFill(DrBitmap &bitmap, int at_x, int at_y, DrColor fill_color, dou
 
 //####################################################################################
 //##    Fill border
-//##        Traces Border of 'rect' and makes sure to fill in any Dr::transparent areas with fill_color
+//##        Traces Border of 'rect' and makes sure to fill in any Dr::transparent areas with fill_color. Areas are
+//##        filled in place (4 connected, same as FloodFill() from each border pixel) with one point stack, so no
+//##        copies of bitmap are made. Stops early if active budget runs out (see DrBudget).
 //####################################################################################
 void FillBorder(DrBitmap &bitmap, DrColor fill_color, DrRect rect) {
-    DrRect fill_rect;
-    int    fill_qty;
+    DR_TIME_SCOPE("FillBorder");
+    std::vector<DrPoint> points;
+
+    // Fills pixel if transparent, pixels that fill_color leaves transparent aren't pushed so fill always ends
+    auto fill = [&bitmap, &fill_color, &points](int x, int y) {
+        if (x < 0 || y < 0 || x > bitmap.width - 1 || y > bitmap.height - 1) return;
+        if (bitmap.getPixel(x, y) != Dr::transparent) return;
+        bitmap.setPixel(x, y, fill_color);
+        if (bitmap.getPixel(x, y) != Dr::transparent) points.push_back(DrPoint(x, y));
+    };
+    auto fillFrom = [&](int x, int y) {
+        if (bitmap.getPixel(x, y) != Dr::transparent) return;
+        DR_COUNT(Flood_Fills, 1);
+        fill(x, y);
+        while (points.size() > 0) {
+            if (Dr::BudgetCheck()) { points.clear();  return; }
+            DrPoint point = points.back();
+            points.pop_back();
+            fill(point.x - 1, point.y);     fill(point.x + 1, point.y);
+            fill(point.x, point.y - 1);     fill(point.x, point.y + 1);
+        }
+    };
 
     int y1 = rect.top();
     int y2 = rect.bottom();
     for (int x = rect.left(); x < rect.left() + rect.width; x++) {
-        if (bitmap.getPixel(x, y1) == Dr::transparent) {
-            Dr::FloodFill(bitmap, x, y1, fill_color, 0.001, Flood_Fill_Type::Compare_4, fill_qty, fill_rect);
-        }
-        if (bitmap.getPixel(x, y2) == Dr::transparent) {
-            Dr::FloodFill(bitmap, x, y2, fill_color, 0.001, Flood_Fill_Type::Compare_4, fill_qty, fill_rect);
-        }
+        fillFrom(x, y1);
+        fillFrom(x, y2);
     }
 
     int x1 = rect.left();
     int x2 = rect.right();
     for (int y = rect.top(); y < rect.top() + rect.height; y++) {
-        if (bitmap.getPixel(x1, y) == Dr::transparent) {
-            Dr::FloodFill(bitmap, x1, y, fill_color, 0.001, Flood_Fill_Type::Compare_4, fill_qty, fill_rect);
-        }
-        if (bitmap.getPixel(x2, y) == Dr::transparent) {
-            Dr::FloodFill(bitmap, x2, y, fill_color, 0.001, Flood_Fill_Type::Compare_4, fill_qty, fill_rect);
-        }
+        fillFrom(x1, y);
+        fillFrom(x2, y);
     }
 }
 
@@ -212,15 +311,20 @@ void FillBorder(DrBitmap &bitmap, DrColor fill_color, DrRect rect) {
 //##        Seperates parts of an image divided by alpha space into seperate images, returns image count.
 //##        The images are stored into the reference array passed in 'images', the images are black and white.
 //##            Black where around the ouside of of the object, and the object itself is white.
+//##        With 'convert' the working copy and object images are one byte per pixel (Grayscale), otherwise they
+//##        keep the format of 'bitmap'.
 //##        Rects of images are returned in 'rects'
+//##        Returns true if active budget ran out (see DrBudget) before every object was found
 //####################################################################################
 #define INVERTED_COLORS     true
 
-bool FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps, std::vector<DrRect> &rects,
+bool FindObjectsInBitmap(const DrBitmapView &bitmap, std::vector<DrBitmap> &bitmaps, std::vector<DrRect> &rects,
                         double alpha_tolerance, bool convert) {
+    DR_TIME_SCOPE("FindObjectsInBitmap");
     DrBitmap     black_white;
-    if (convert) black_white = BlackAndWhiteFromAlpha(bitmap, alpha_tolerance, INVERTED_COLORS);
-    else         black_white = bitmap;
+    if (convert) black_white = BlackAndWhiteFromAlpha(bitmap, alpha_tolerance, INVERTED_COLORS, Bitmap_Format::Grayscale);
+    else         black_white = DrBitmap(bitmap);                                // Flood fills work in place, needs its own copy
+    DR_COUNT(Bytes_Allocated, black_white.size());
 
     DrColor compare(Dr::transparent);
 
@@ -243,22 +347,26 @@ bool FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps,
     if (pixels || convert == false) {
         // Loop through every pixel in image, if we find a spot that has an object,
         // flood fill that spot and add the resulting image shape to the array of object images
+        DR_COUNT(Pixels_Scanned, black_white.width * black_white.height);
         for (int x = 0; x < black_white.width; ++x) {
+            if (Dr::BudgetExpired()) return true;
             // Process Pixel
             for (int y = 0; y < black_white.height; ++y) {
                 if (black_white.getPixel(x, y) == compare) {
                     DrRect      rect;
                     int         flood_pixel_count;
                     DrBitmap    flood_fill = FloodFill(black_white, x, y, Dr::red, 0.001, Flood_Fill_Type::Compare_4, flood_pixel_count, rect);
+                    if (Dr::BudgetExpired()) return true;                       // Flood may be partial
 
                     // Add buffer around rect, create image of rect only
                     rect.adjust(-1, -1, 1, 1);
                     DrBitmap    fill_only = flood_fill.copy(rect);
+                    DR_COUNT(Bytes_Allocated, fill_only.size());
 
                     // If adequate image, add to list of floods
                     if (fill_only.width >= 1 && fill_only.height >= 1 && flood_pixel_count > 1) {
                         rects.push_back( rect );
-                        bitmaps.push_back( fill_only );
+                        bitmaps.push_back( std::move(fill_only) );
                     }
                 }
             }
@@ -273,7 +381,7 @@ bool FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps,
                 }
             }
             rects.push_back( black_white.rect() );
-            bitmaps.push_back( black_white );
+            bitmaps.push_back( std::move(black_white) );
         }
     }
 
@@ -288,6 +396,7 @@ bool FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps,
 //##    on the largest angle between two points. Idea and code written by Scidian Software.
 //##        !!!!! #NOTE: Image passed in should be black and white,
 //##                     probably from DrImageing::BlackAndWhiteFromAlpha()
+//##        Returns empty list if active budget runs out (see DrBudget) before outline is closed
 //####################################################################################
 #define TRACE_NOT_BORDER            0           // Pixels that are not near the edge
 #define TRACE_START_PIXEL           1           // Starting pixel
@@ -296,8 +405,10 @@ bool FindObjectsInBitmap(const DrBitmap &bitmap, std::vector<DrBitmap> &bitmaps,
 #define TRACE_PROCESSED_TWICE       4           // Pixels that added to the border twice        (after a there and back again trace)
 
 std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
-    // Initialize images
-    DrBitmap processed = bitmap;
+    DR_TIME_SCOPE("TraceImageOutline");
+    // Trace state, one byte per pixel whatever the format of bitmap
+    std::vector<unsigned char> processed(static_cast<size_t>(bitmap.width) * static_cast<size_t>(bitmap.height), TRACE_NOT_BORDER);
+    auto flag = [&processed, &bitmap](int x, int y) -> unsigned char& { return processed[static_cast<size_t>(y) * bitmap.width + x]; };
     int border_pixel_count = 0;
 
     // Initialize point array, verify image size
@@ -310,10 +421,11 @@ std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
     bool has_start_point = false;
 
     for (int x = 0; x < bitmap.width; ++x) {
+        if (Dr::BudgetExpired()) return std::vector<DrPointF> { };
         for (int y = 0; y < bitmap.height; ++y) {
             // If pixel is part of the exterior, it cannot be part of the border
             if (bitmap.getPixel(x, y) == Dr::transparent) {
-                processed.setPixel(x, y, TRACE_NOT_BORDER);
+                flag(x, y) = TRACE_NOT_BORDER;
                 continue;
             }
 
@@ -331,16 +443,16 @@ std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
 
             // If not touching any transparent pixels, and not on edge, cannot be part of border
             if (!can_be_border) {
-                processed.setPixel(x, y, TRACE_NOT_BORDER);
+                flag(x, y) = TRACE_NOT_BORDER;
 
             // Otherwise mark it as not processed and check if we have a start point
             } else {
-                processed.setPixel(x, y, TRACE_NOT_PROCESSED);
+                flag(x, y) = TRACE_NOT_PROCESSED;
                 ++border_pixel_count;
                 if (!has_start_point) {
                     points.push_back(DrPoint(x, y));
                     last_point = DrPoint(x - 1, y);
-                    processed.setPixel(x, y, TRACE_START_PIXEL);
+                    flag(x, y) = TRACE_START_PIXEL;
                     has_start_point = true;
                 }
             }
@@ -355,6 +467,8 @@ std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
     long trace_count = 0;
     long total_pixels = bitmap.width * bitmap.height;
     do {
+        if (Dr::BudgetCheck()) return std::vector<DrPointF> { };
+
         // Collect list of points around current point
         surround.clear();
         DrPoint current_point = points.back();
@@ -369,7 +483,7 @@ std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
                 ///if ( (x == current_point.x + 1) && (y == current_point.y - 1) ) continue;
                 ///if ( (x == current_point.x - 1) && (y == current_point.y + 1) ) continue;
                 ///if ( (x == current_point.x + 1) && (y == current_point.y + 1) ) continue;
-                if (processed.getPixel(x, y) != TRACE_PROCESSED_TWICE && processed.getPixel(x, y) != TRACE_NOT_BORDER) {
+                if (flag(x, y) != TRACE_PROCESSED_TWICE && flag(x, y) != TRACE_NOT_BORDER) {
                     surround.push_back(DrPoint(x, y));
                 }
             }
@@ -401,16 +515,16 @@ std::vector<DrPointF> TraceImageOutline(const DrBitmap &bitmap) {
 
         // If we found an angle, we found our next point, add it to the list
         if (surround.size() > 0) {
-            if (processed.getPixel(current_point.x, current_point.y) == TRACE_NOT_PROCESSED)
-                processed.setPixel(current_point.x, current_point.y, TRACE_PROCESSED_ONCE);
-            else if (processed.getPixel(current_point.x, current_point.y) == TRACE_PROCESSED_ONCE)
-                processed.setPixel(current_point.x, current_point.y, TRACE_PROCESSED_TWICE);
+            if (flag(current_point.x, current_point.y) == TRACE_NOT_PROCESSED)
+                flag(current_point.x, current_point.y) = TRACE_PROCESSED_ONCE;
+            else if (flag(current_point.x, current_point.y) == TRACE_PROCESSED_ONCE)
+                flag(current_point.x, current_point.y) = TRACE_PROCESSED_TWICE;
             last_point = current_point;
             points.push_back(next_point);
         }
 
         // Check if we're back at start and no more options
-        back_at_start = (processed.getPixel(points.back().x, points.back().y) == TRACE_START_PIXEL);
+        back_at_start = (flag(points.back().x, points.back().y) == TRACE_START_PIXEL);
         ++trace_count;
 
     } while ((surround.size() > 0) && !back_at_start);
@@ -0,0 +1,170 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "compare.h"
+#include "imaging.h"
+#include "types/color.h"
+
+// Local Constants
+const int   c_ring_width =          3;              // Width of each ring (and gap) of Stress_Pattern::Rings, in pixels
+const int   c_checker_size =        2;              // Square size of Stress_Pattern::Checkerboard, in pixels
+const int   c_speck_spacing =       8;              // Average distance between specks of Stress_Pattern::Specks, in pixels
+
+
+namespace Dr
+{
+
+//####################################################################################
+//##    Small deterministic random number generator (LCG), same sequence on every platform
+//####################################################################################
+class StressRandom
+{
+private:
+    unsigned int m_state;
+public:
+    StressRandom(unsigned int seed) : m_state(seed * 2654435761u + 1u) { }
+    unsigned int    next()                  { m_state = m_state * 1664525u + 1013904223u; return m_state >> 8; }
+    float           unit()                  { return static_cast<float>(next()) / 16777216.f; }                // 0.0 to 1.0
+    int             range(int low, int high){ return low + static_cast<int>(next() % static_cast<unsigned int>(high - low + 1)); }
+};
+
+// Fills polygon with even-odd rule, one scanline at a time through pixel centers
+static void fillPolygon(DrBitmap &bitmap, const std::vector<float> &xs, const std::vector<float> &ys) {
+    std::vector<float> crossings;
+    for (int y = 0; y < bitmap.height; y++) {
+        float center = static_cast<float>(y) + 0.5f;
+        crossings.clear();
+        for (size_t i = 0, j = xs.size() - 1; i < xs.size(); j = i++) {
+            if ((ys[i] > center) == (ys[j] > center)) continue;
+            crossings.push_back(xs[i] + (center - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i]));
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t c = 0; c + 1 < crossings.size(); c += 2) {
+            int start = Dr::Max(static_cast<int>(std::ceil(crossings[c] - 0.5f)), 0);
+            int end =   Dr::Min(static_cast<int>(std::floor(crossings[c + 1] - 0.5f)), bitmap.width - 1);
+            for (int x = start; x <= end; x++) bitmap.setPixel(x, y, Dr::white);
+        }
+    }
+}
+
+
+//####################################################################################
+//##    Generates deterministic worst case bitmaps for stress / scaling tests, white shapes on transparent background
+//##        Same pattern, size and seed always give the same bitmap
+//####################################################################################
+DrBitmap GenerateStressBitmap(Stress_Pattern pattern, int size, unsigned int seed) {
+    size = Dr::Max(size, 8);
+    DrBitmap bitmap(size, size);
+    StressRandom random(seed);
+    float half = static_cast<float>(size) * 0.5f;
+
+    switch (pattern) {
+        // ***** Thousands of tiny objects, 1 to 3 pixels wide
+        case Stress_Pattern::Specks: {
+            int count = (size * size) / (c_speck_spacing * c_speck_spacing);
+            for (int i = 0; i < count; i++) {
+                int x = random.range(1, size - 5);
+                int y = random.range(1, size - 5);
+                int w = random.range(1, 3);
+                int h = random.range(1, 3);
+                for (int sx = x; sx < x + w; sx++) {
+                    for (int sy = y; sy < y + h; sy++) bitmap.setPixel(sx, sy, Dr::white);
+                }
+            }
+            break;
+        }
+
+        // ***** One object covering most of the image, slightly wobbly edge
+        case Stress_Pattern::Blob: {
+            float radius = half * 0.9f;
+            float wobble = radius * 0.05f;
+            float phase =  random.unit() * 6.2831853f;
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    float dx = x + 0.5f - half, dy = y + 0.5f - half;
+                    float edge = radius + wobble * std::sin(5.f * std::atan2(dy, dx) + phase);
+                    if (dx*dx + dy*dy < edge*edge) bitmap.setPixel(x, y, Dr::white);
+                }
+            }
+            break;
+        }
+
+        // ***** Concentric rings, each ring is a hole of the ring around it, nesting depth grows with size
+        case Stress_Pattern::Rings: {
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    float dx = x + 0.5f - half, dy = y + 0.5f - half;
+                    int   distance = static_cast<int>(std::sqrt(dx*dx + dy*dy));
+                    if (distance < half - 1.f && (distance / c_ring_width) % 2 == 0) bitmap.setPixel(x, y, Dr::white);
+                }
+            }
+            break;
+        }
+
+        // ***** Fractal coastline, midpoint displaced polygon with segments about one pixel long (very long contour)
+        case Stress_Pattern::Coastline: {
+            std::vector<float> xs, ys;
+            const int corners = 8;
+            for (int i = 0; i < corners; i++) {
+                float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(corners);
+                xs.push_back(half + std::cos(angle) * half * 0.6f);
+                ys.push_back(half + std::sin(angle) * half * 0.6f);
+            }
+            float displacement = half * 0.25f;
+            while (displacement > 0.5f) {
+                std::vector<float> next_xs, next_ys;
+                for (size_t i = 0; i < xs.size(); i++) {
+                    size_t j = (i + 1) % xs.size();
+                    float ex = xs[j] - xs[i], ey = ys[j] - ys[i];
+                    float length = std::sqrt(ex*ex + ey*ey);
+                    float offset = (random.unit() * 2.f - 1.f) * displacement;
+                    next_xs.push_back(xs[i]);
+                    next_ys.push_back(ys[i]);
+                    if (length > 0.f) {
+                        next_xs.push_back(Dr::Clamp((xs[i] + xs[j]) * 0.5f - (ey / length) * offset, 1.f, size - 2.f));
+                        next_ys.push_back(Dr::Clamp((ys[i] + ys[j]) * 0.5f + (ex / length) * offset, 1.f, size - 2.f));
+                    }
+                }
+                xs.swap(next_xs);
+                ys.swap(next_ys);
+                displacement *= 0.55f;
+            }
+            fillPolygon(bitmap, xs, ys);
+            break;
+        }
+
+        // ***** Checkerboard, squares only touch diagonally
+        case Stress_Pattern::Checkerboard: {
+            for (int y = 1; y < size - 1; y++) {
+                for (int x = 1; x < size - 1; x++) {
+                    if (((x / c_checker_size) + (y / c_checker_size)) % 2 == 0) bitmap.setPixel(x, y, Dr::white);
+                }
+            }
+            break;
+        }
+
+        // ***** Random alpha per pixel
+        case Stress_Pattern::Noise: {
+            for (int y = 1; y < size - 1; y++) {
+                for (int x = 1; x < size - 1; x++) {
+                    bitmap.setPixel(x, y, DrColor(255, 255, 255, random.range(0, 255)));
+                }
+            }
+            break;
+        }
+    }
+    return bitmap;
+}
+
+
+}   // End namespace Dr
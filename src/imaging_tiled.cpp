@@ -0,0 +1,656 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "budget.h"
+#include "compare.h"
+#include "imaging.h"
+#include "imaging_tiled.h"
+#include "instrument.h"
+#include "types/color.h"
+#include "types/point.h"
+#include "types/rect.h"
+
+// Local Constants
+const int   c_no_label =            -1;             // Label of pixels that are not part of an object
+const int   c_frame_depth =         2;              // Rows / columns of labels kept along each tile edge, tracing looks two pixels ahead
+const int   c_window_cache =        4;              // Tiles kept while tracing, contours often wander around a tile corner
+
+// Bounds plus a one pixel border, clipped to image
+static DrRect MaskRect(DrRect rect, int width, int height) {
+    rect.adjust(-1, -1, 1, 1);
+    if (rect.x < 0) { rect.width  += rect.x;  rect.x = 0; }
+    if (rect.y < 0) { rect.height += rect.y;  rect.y = 0; }
+    if (rect.right()  > width  - 1) rect.width =  width  - rect.left();
+    if (rect.bottom() > height - 1) rect.height = height - rect.top();
+    return rect;
+}
+
+// Slot in frame of 'local' coordinate of a tile 'size' long, -1 if it isn't within c_frame_depth of either end
+static int FrameSlot(int local, int size) {
+    if (local < c_frame_depth)          return local;
+    if (local >= size - c_frame_depth)  return local - size + (c_frame_depth * 2);
+    return -1;
+}
+
+
+namespace Dr
+{
+
+//####################################################################################
+//##    Finds bounds of objects (4 connected pixels with alpha >= alpha_tolerance) without a full size working copy.
+//##        Image is labeled one tile at a time, tiles overlap the row above / column to the left so labels are
+//##        stitched across seams. After each row of tiles, objects that don't reach the next row are finished and
+//##        their labels are dropped, so working memory is one tile of labels plus one image row of seam labels.
+//##        Objects are returned in the order (and with the same single pixel / no background rules) as
+//##        FindObjectsInBitmap(), use ObjectBitmap() to copy each one out.
+//##        If active budget runs out (see DrBudget) labeling stops and list is partial, check Dr::BudgetExpired() after.
+//####################################################################################
+std::vector<DrObjectBounds> FindObjectBoundsTiled(const DrBitmapView &bitmap, double alpha_tolerance, int tile_size) {
+    DR_TIME_SCOPE("FindObjectBoundsTiled");
+    std::vector<DrObjectBounds> objects;
+    if (bitmap.isValid() == false) return objects;
+    tile_size = Max(tile_size, 1);
+    int alpha_i = static_cast<int>(alpha_tolerance * 255.0);
+
+    TileLabels          union_find;
+    std::vector<int>    tile_labels(static_cast<size_t>(tile_size) * static_cast<size_t>(tile_size));
+    std::vector<int>    seam_row(bitmap.width, c_no_label);                         // Bottom row labels of tile row above
+    std::vector<int>    seam_column(tile_size, c_no_label);                         // Right column labels of tile to the left
+    long long           background_count = 0;
+    DR_COUNT(Bytes_Allocated, (tile_labels.size() + seam_row.size() + seam_column.size()) * sizeof(int));
+
+    for (int tile_y = 0; tile_y < bitmap.height; tile_y += tile_size) {
+        int rows = Min(tile_size, bitmap.height - tile_y);
+
+        for (int tile_x = 0; tile_x < bitmap.width; tile_x += tile_size) {
+            if (Dr::BudgetExpired()) return objects;
+            int columns = Min(tile_size, bitmap.width - tile_x);
+
+            for (int y = 0; y < rows; ++y) {
+                const unsigned char *alpha = bitmap.row(tile_y + y) + tile_x * bitmap.channels + (bitmap.channels - 1);
+                int *labels = &tile_labels[static_cast<size_t>(y) * tile_size];
+                for (int x = 0; x < columns; ++x) {
+                    if (alpha[x * bitmap.channels] < alpha_i) {
+                        labels[x] = c_no_label;
+                        background_count++;
+                        continue;
+                    }
+                    int left = (x > 0) ? labels[x - 1] : ((tile_x > 0) ? seam_column[y]          : c_no_label);
+                    int up =   (y > 0) ? labels[x - tile_size] : ((tile_y > 0) ? seam_row[tile_x + x] : c_no_label);
+                    int root;
+                    if      (left == c_no_label && up == c_no_label)    root = union_find.add(tile_x + x, tile_y + y);
+                    else if (up == c_no_label)                          root = union_find.find(left);
+                    else if (left == c_no_label)                        root = union_find.find(up);
+                    else                                                root = union_find.unite(left, up);
+                    union_find.addPixel(root, tile_x + x, tile_y + y);
+                    labels[x] = root;
+                }
+            }
+
+            // Carry edges of tile over to neighbors
+            for (int y = 0; y < rows; ++y)    seam_column[y] =        tile_labels[static_cast<size_t>(y) * tile_size + (columns - 1)];
+            for (int x = 0; x < columns; ++x) seam_row[tile_x + x] =  tile_labels[static_cast<size_t>(rows - 1) * tile_size + x];
+        }
+
+        // ***** Objects not touching bottom of this tile row are finished, keep labels of the rest under new (compact) numbers
+        if (tile_y + rows >= bitmap.height) std::fill(seam_row.begin(), seam_row.end(), c_no_label);
+        std::vector<int> renumber(union_find.labels.size(), c_no_label);
+        TileLabels       live;
+        for (auto &label : seam_row) {
+            if (label == c_no_label) continue;
+            int root = union_find.find(label);
+            if (renumber[root] == c_no_label) {
+                renumber[root] = static_cast<int>(live.labels.size());
+                live.labels.push_back(union_find.labels[root]);
+                live.labels.back().parent = renumber[root];
+            }
+            label = renumber[root];
+        }
+        for (int index = 0; index < static_cast<int>(union_find.labels.size()); ++index) {
+            const TileLabel &label = union_find.labels[index];
+            if (label.parent != index || renumber[index] != c_no_label || label.pixel_count <= 1) continue;
+            DrObjectBounds object;
+            object.rect =           DrRect(label.min_x, label.min_y, (label.max_x - label.min_x) + 1, (label.max_y - label.min_y) + 1);
+            object.seed =           DrPoint(label.seed_x, label.seed_y);
+            object.pixel_count =    label.pixel_count;
+            objects.push_back(object);
+        }
+        union_find.labels.swap(live.labels);
+    }
+
+    // ***** No background pixels, whole image is one object (same as FindObjectsInBitmap())
+    if (background_count == 0) {
+        DrObjectBounds object;
+        object.rect =           bitmap.rect();
+        object.seed =           DrPoint(0, 0);
+        object.pixel_count =    bitmap.width * bitmap.height;
+        objects.clear();
+        objects.push_back(object);
+    }
+
+    // ***** FindObjectsInBitmap() scans columns, so objects are found in order of first pixel in column order
+    std::sort(objects.begin(), objects.end(), [](const DrObjectBounds &a, const DrObjectBounds &b) {
+        return (a.seed.x < b.seed.x) || (a.seed.x == b.seed.x && a.seed.y < b.seed.y);
+    });
+    DR_COUNT(Pixels_Scanned, bitmap.width * bitmap.height);
+    return objects;
+}
+
+
+//####################################################################################
+//##    Copies one object found by FindObjectBoundsTiled() into 'object_bitmap' as one byte per pixel (Grayscale),
+//##    object pixels 255 and everything else zero, with a one pixel border (clipped to image). Bitmap and 'rect' match
+//##    FindObjectsInBitmap() output. 'object_bitmap' keeps its capacity, so passing the same one for each object
+//##    only allocates when an object is larger than any before it.
+//##    Object is partial if active budget runs out (see DrBudget), check Dr::BudgetExpired() after.
+//####################################################################################
+void ObjectBitmap(const DrBitmapView &bitmap, const DrObjectBounds &object, double alpha_tolerance, DrRect &rect,
+                  DrBitmap &object_bitmap) {
+    rect = MaskRect(object.rect, bitmap.width, bitmap.height);
+    object_bitmap.format =   Bitmap_Format::Grayscale;
+    object_bitmap.channels = 1;
+    object_bitmap.width =    Max(rect.width,  0);
+    object_bitmap.height =   Max(rect.height, 0);
+    size_t pixels = static_cast<size_t>(object_bitmap.width) * static_cast<size_t>(object_bitmap.height);
+    if (pixels > object_bitmap.data.capacity()) { DR_COUNT(Bytes_Allocated, pixels); }
+    object_bitmap.data.assign(pixels, 0);
+    if (pixels == 0) { object_bitmap.width = 0;  object_bitmap.height = 0;  return; }
+    int alpha_i = static_cast<int>(alpha_tolerance * 255.0);
+
+    // Fill object from its seed, only pixels of this object are reached (any object pixel next to it would be part of it)
+    std::vector<DrPoint> points;
+    points.push_back(DrPoint(object.seed.x - rect.x, object.seed.y - rect.y));
+    object_bitmap.setPixel(points.back().x, points.back().y, Dr::red);
+    while (points.size() > 0) {
+        if (Dr::BudgetCheck()) break;
+        DrPoint point = points.back();
+        points.pop_back();
+        const DrPoint neighbors[4] = { DrPoint(point.x - 1, point.y), DrPoint(point.x + 1, point.y),
+                                       DrPoint(point.x, point.y - 1), DrPoint(point.x, point.y + 1) };
+        for (const auto &next : neighbors) {
+            if (next.x < 0 || next.y < 0 || next.x >= rect.width || next.y >= rect.height) continue;
+            if (bitmap.alpha(rect.x + next.x, rect.y + next.y) < alpha_i) continue;
+            if (object_bitmap.getPixel(next.x, next.y) != Dr::transparent) continue;
+            object_bitmap.setPixel(next.x, next.y, Dr::red);
+            points.push_back(next);
+        }
+    }
+}
+
+
+//####################################################################################
+//##    Finds bounds of objects that have at least one pixel inside 'region', each is followed past region to its full
+//##    extent. Work follows size of those objects, not size of image. 'visited' is scratch of one byte per image pixel,
+//##    it is sized on first use and left all zero on return so it can be kept between calls. Objects are returned in
+//##    the order (and with the same single pixel / no background rules) as FindObjectsInBitmap().
+//##    If active budget runs out (see DrBudget) list is partial, check Dr::BudgetExpired() after.
+//####################################################################################
+std::vector<DrObjectBounds> FindObjectBoundsTouching(const DrBitmapView &bitmap, DrRect region, double alpha_tolerance,
+                                                     std::vector<unsigned char> &visited) {
+    DR_TIME_SCOPE("FindObjectBoundsTouching");
+    std::vector<DrObjectBounds> objects;
+    if (bitmap.isValid() == false) return objects;
+    if (region.x < 0) { region.width  += region.x;  region.x = 0; }
+    if (region.y < 0) { region.height += region.y;  region.y = 0; }
+    if (region.right()  > bitmap.width  - 1) region.width =  bitmap.width  - region.left();
+    if (region.bottom() > bitmap.height - 1) region.height = bitmap.height - region.top();
+    if (region.width <= 0 || region.height <= 0) return objects;
+    size_t image_size = static_cast<size_t>(bitmap.width) * static_cast<size_t>(bitmap.height);
+    if (visited.size() != image_size) visited.assign(image_size, 0);
+    int alpha_i = static_cast<int>(alpha_tolerance * 255.0);
+
+    std::vector<size_t> filled;                                                     // Every visited pixel, to clear 'visited' after
+    std::vector<DrPoint> points;
+    bool out_of_budget = false;
+    for (int x = region.left(); x <= region.right() && !out_of_budget; ++x) {
+        for (int y = region.top(); y <= region.bottom() && !out_of_budget; ++y) {
+            size_t index = static_cast<size_t>(y) * bitmap.width + x;
+            if (visited[index] || bitmap.alpha(x, y) < alpha_i) continue;
+
+            // Column order scan, so first pixel found is seed, flood fill rest of object
+            DrObjectBounds object;
+            int min_x = x, min_y = y, max_x = x, max_y = y;
+            object.seed = DrPoint(x, y);
+            visited[index] = 1;
+            filled.push_back(index);
+            points.push_back(object.seed);
+            while (points.size() > 0) {
+                if (Dr::BudgetCheck()) { out_of_budget = true;  points.clear();  break; }
+                DrPoint point = points.back();
+                points.pop_back();
+                object.pixel_count++;
+                if (point.x < object.seed.x || (point.x == object.seed.x && point.y < object.seed.y)) object.seed = point;
+                min_x = Min(min_x, point.x);        max_x = Max(max_x, point.x);
+                min_y = Min(min_y, point.y);        max_y = Max(max_y, point.y);
+                const DrPoint neighbors[4] = { DrPoint(point.x - 1, point.y), DrPoint(point.x + 1, point.y),
+                                               DrPoint(point.x, point.y - 1), DrPoint(point.x, point.y + 1) };
+                for (const auto &next : neighbors) {
+                    if (next.x < 0 || next.y < 0 || next.x >= bitmap.width || next.y >= bitmap.height) continue;
+                    size_t next_index = static_cast<size_t>(next.y) * bitmap.width + next.x;
+                    if (visited[next_index] || bitmap.alpha(next.x, next.y) < alpha_i) continue;
+                    visited[next_index] = 1;
+                    filled.push_back(next_index);
+                    points.push_back(next);
+                }
+            }
+            object.rect = DrRect(min_x, min_y, (max_x - min_x) + 1, (max_y - min_y) + 1);
+
+            // Object covering whole image is kept whatever its size (no background pixels, same as FindObjectsInBitmap())
+            if (out_of_budget) break;
+            if (object.pixel_count > 1 || static_cast<size_t>(object.pixel_count) == image_size) objects.push_back(object);
+        }
+    }
+    for (const auto &index : filled) visited[index] = 0;
+    DR_COUNT(Flood_Fills, objects.size());
+    DR_COUNT(Pixels_Scanned, filled.size());
+
+    std::sort(objects.begin(), objects.end(), [](const DrObjectBounds &a, const DrObjectBounds &b) {
+        return (a.seed.x < b.seed.x) || (a.seed.x == b.seed.x && a.seed.y < b.seed.y);
+    });
+    return objects;
+}
+
+
+}   // End namespace Dr
+
+
+
+//####################################################################################
+//##    DrTileComponents
+//##        Objects are labeled from alpha, holes from pixels of the object's mask rect that aren't the object. Each
+//##        tile is labeled on its own, components with a pixel in the two pixel deep frame of a tile get a label in
+//##        the union find and are stitched to tiles to the left / above, all other components are finished
+//####################################################################################
+DrTileComponents::DrTileComponents(const DrBitmapView &bitmap, double alpha_tolerance, int tile_size)
+    : m_bitmap(bitmap), m_alpha(static_cast<int>(alpha_tolerance * 255.0)), m_tile_size(Dr::Max(tile_size, 1)) {
+    if (bitmap.isValid() == false) return;
+    m_region = bitmap.rect();
+    build(true);
+}
+
+DrTileComponents::DrTileComponents(const DrTileComponents &objects, const DrObjectBounds &object)
+    : m_bitmap(objects.m_bitmap), m_alpha(objects.m_alpha), m_tile_size(objects.m_tile_size),
+      m_objects(&objects), m_object_seed(object.seed) {
+    m_region = objects.maskRect(object);
+    build(false);
+}
+
+DrRect DrTileComponents::maskRect(const DrObjectBounds &component) const {
+    return MaskRect(component.rect, m_bitmap.width, m_bitmap.height);
+}
+
+// Mask of component is no larger than a tile, copying it out with Dr::ObjectBitmap() needs no more memory than tracing in tiles
+bool DrTileComponents::fitsTile(const DrObjectBounds &component) const {
+    DrRect rect = maskRect(component);
+    return static_cast<long long>(rect.width) * rect.height <= static_cast<long long>(m_tile_size) * m_tile_size;
+}
+
+DrRect DrTileComponents::tileRect(int column, int row) const {
+    int left =   Dr::Max(column * m_tile_size, m_region.x);
+    int top =    Dr::Max(row    * m_tile_size, m_region.y);
+    int right =  Dr::Min((column + 1) * m_tile_size, m_region.x + m_region.width);
+    int bottom = Dr::Min((row    + 1) * m_tile_size, m_region.y + m_region.height);
+    return DrRect(left, top, right - left, bottom - top);
+}
+
+// Frame label of pixel inside region, frame rows of a tile are kept with its tile row, frame columns with its tile column
+int* DrTileComponents::seamLabel(int x, int y) {
+    int     column = x / m_tile_size;
+    int     row =    y / m_tile_size;
+    DrRect  tile =   tileRect(column, row);
+    int     slot =   FrameSlot(y - tile.y, tile.height);
+    if (slot >= 0) {
+        size_t index = static_cast<size_t>((row - m_first_row) * (c_frame_depth * 2) + slot) * m_region.width + (x - m_region.x);
+        return &m_seam_rows[index];
+    }
+    slot = FrameSlot(x - tile.x, tile.width);
+    if (slot >= 0) {
+        size_t index = static_cast<size_t>((column - m_first_column) * (c_frame_depth * 2) + slot) * m_region.height + (y - m_region.y);
+        return &m_seam_columns[index];
+    }
+    return nullptr;
+}
+
+const int* DrTileComponents::seamLabel(int x, int y) const {
+    return const_cast<DrTileComponents*>(this)->seamLabel(x, y);
+}
+
+
+//####################################################################################
+//##    Tile labeling
+//####################################################################################
+// Pixels of tile that are labeled, for holes that is every pixel that isn't part of the object (tiles of both share the grid)
+void DrTileComponents::memberTile(const DrRect &tile, std::vector<unsigned char> &member) const {
+    member.resize(static_cast<size_t>(tile.width) * tile.height);
+    if (m_objects == nullptr) {
+        for (int y = 0; y < tile.height; ++y) {
+            const unsigned char *alpha = m_bitmap.row(tile.y + y) + tile.x * m_bitmap.channels + (m_bitmap.channels - 1);
+            unsigned char *row = &member[static_cast<size_t>(y) * tile.width];
+            for (int x = 0; x < tile.width; ++x) row[x] = (alpha[x * m_bitmap.channels] >= m_alpha) ? 1 : 0;
+        }
+        return;
+    }
+    DrRect outer = m_objects->tileRect(tile.x / m_tile_size, tile.y / m_tile_size);
+    std::vector<unsigned char> object;
+    m_objects->componentTile(outer, m_object_seed, object);
+    for (int y = 0; y < tile.height; ++y) {
+        const unsigned char *from = &object[static_cast<size_t>(tile.y + y - outer.y) * outer.width + (tile.x - outer.x)];
+        unsigned char *row = &member[static_cast<size_t>(y) * tile.width];
+        for (int x = 0; x < tile.width; ++x) row[x] = (from[x] == 0) ? 1 : 0;
+    }
+}
+
+// Labels components inside tile only (4 connected), 'labels' ends up with the root in 'locals' of each pixel
+void DrTileComponents::labelTile(const DrRect &tile, std::vector<unsigned char> &member, std::vector<int> &labels,
+                                 TileLabels &locals) const {
+    memberTile(tile, member);
+    labels.assign(member.size(), c_no_label);
+    locals.labels.clear();
+    int region_right =  m_region.x + m_region.width  - 1;
+    int region_bottom = m_region.y + m_region.height - 1;
+    for (int y = 0; y < tile.height; ++y) {
+        for (int x = 0; x < tile.width; ++x) {
+            size_t index = static_cast<size_t>(y) * tile.width + x;
+            if (member[index] == 0) continue;
+            int left = (x > 0) ? labels[index - 1]          : c_no_label;
+            int up =   (y > 0) ? labels[index - tile.width] : c_no_label;
+            int root;
+            if      (left == c_no_label && up == c_no_label)    root = locals.add(tile.x + x, tile.y + y);
+            else if (up == c_no_label)                          root = locals.find(left);
+            else if (left == c_no_label)                        root = locals.find(up);
+            else                                                root = locals.unite(left, up);
+            locals.addPixel(root, tile.x + x, tile.y + y);
+            if (tile.x + x == m_region.x || tile.y + y == m_region.y || tile.x + x == region_right || tile.y + y == region_bottom) {
+                locals.labels[root].on_edge = true;
+            }
+            labels[index] = root;
+        }
+    }
+    for (auto &label : labels) if (label != c_no_label) label = locals.find(label);
+}
+
+// Marks pixels of tile that are part of component with 'seed', components that reach the frame are looked up in the
+// union find, the rest are whole inside the tile
+void DrTileComponents::componentTile(const DrRect &tile, const DrPoint &seed, std::vector<unsigned char> &member) const {
+    std::vector<int> labels;
+    TileLabels       locals;
+    labelTile(tile, member, labels, locals);
+    std::vector<signed char> is_seed(locals.labels.size(), -1);
+    for (int y = 0; y < tile.height; ++y) {
+        bool frame_row = FrameSlot(y, tile.height) >= 0;
+        for (int x = 0; x < tile.width; ++x) {
+            int label = labels[static_cast<size_t>(y) * tile.width + x];
+            if (label == c_no_label || is_seed[label] >= 0) continue;
+            if (frame_row == false && FrameSlot(x, tile.width) < 0) continue;
+            const TileLabel &root = m_union_find.labels[m_union_find.labels[*seamLabel(tile.x + x, tile.y + y)].parent];
+            is_seed[label] = (root.seed_x == seed.x && root.seed_y == seed.y) ? 1 : 0;
+        }
+    }
+    for (size_t index = 0; index < member.size(); ++index) {
+        int label = labels[index];
+        if (label != c_no_label && is_seed[label] < 0) {
+            is_seed[label] = (locals.labels[label].seed_x == seed.x && locals.labels[label].seed_y == seed.y) ? 1 : 0;
+        }
+        member[index] = (label != c_no_label && is_seed[label] == 1) ? 1 : 0;
+    }
+}
+
+
+//####################################################################################
+//##    Labels region a tile at a time (in rows of tiles), keeps frames and finds components
+//####################################################################################
+void DrTileComponents::build(bool objects) {
+    DR_TIME_SCOPE("DrTileComponents");
+    if (m_region.width <= 0 || m_region.height <= 0) return;
+    m_first_column = m_region.x / m_tile_size;
+    m_first_row =    m_region.y / m_tile_size;
+    m_columns =      (m_region.x + m_region.width  - 1) / m_tile_size - m_first_column + 1;
+    m_rows =         (m_region.y + m_region.height - 1) / m_tile_size - m_first_row    + 1;
+    m_seam_rows.assign(   static_cast<size_t>(m_rows)    * (c_frame_depth * 2) * m_region.width,  c_no_label);
+    m_seam_columns.assign(static_cast<size_t>(m_columns) * (c_frame_depth * 2) * m_region.height, c_no_label);
+    DR_COUNT(Bytes_Allocated, (m_seam_rows.size() + m_seam_columns.size()) * sizeof(int));
+
+    // Objects keep single pixel components while finding holes, holes never touch edge of mask rect
+    auto addComponent = [this, objects](const TileLabel &label) {
+        if (label.pixel_count <= 1 || (objects == false && label.on_edge)) return;
+        DrObjectBounds component;
+        component.rect =        DrRect(label.min_x, label.min_y, (label.max_x - label.min_x) + 1, (label.max_y - label.min_y) + 1);
+        component.seed =        DrPoint(label.seed_x, label.seed_y);
+        component.pixel_count = label.pixel_count;
+        components.push_back(component);
+    };
+
+    std::vector<unsigned char>  member;
+    std::vector<int>            labels;
+    std::vector<int>            global;                                             // Union find label of each local root
+    TileLabels                  locals;
+    long long                   background_count = 0;
+    for (int row = m_first_row; row < m_first_row + m_rows; ++row) {
+        for (int column = m_first_column; column < m_first_column + m_columns; ++column) {
+            if (Dr::BudgetExpired()) return;
+            DrRect tile = tileRect(column, row);
+            labelTile(tile, member, labels, locals);
+
+            // Components in frame get a union find label
+            global.assign(locals.labels.size(), c_no_label);
+            for (int y = 0; y < tile.height; ++y) {
+                bool frame_row = FrameSlot(y, tile.height) >= 0;
+                for (int x = 0; x < tile.width; ++x) {
+                    size_t index = static_cast<size_t>(y) * tile.width + x;
+                    if (member[index] == 0) { background_count++;  continue; }
+                    if (frame_row == false && FrameSlot(x, tile.width) < 0) continue;
+                    int &label = global[labels[index]];
+                    if (label == c_no_label) {
+                        label = static_cast<int>(m_union_find.labels.size());
+                        m_union_find.labels.push_back(locals.labels[labels[index]]);
+                        m_union_find.labels.back().parent = label;
+                    }
+                    *seamLabel(tile.x + x, tile.y + y) = label;
+                }
+            }
+            for (int index = 0; index < static_cast<int>(locals.labels.size()); ++index) {
+                if (locals.labels[index].parent == index && global[index] == c_no_label) addComponent(locals.labels[index]);
+            }
+
+            // Stitch across seams to tile on the left and tile above
+            if (column > m_first_column) {
+                for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                    int here = *seamLabel(tile.x, y);
+                    int left = *seamLabel(tile.x - 1, y);
+                    if (here != c_no_label && left != c_no_label) m_union_find.unite(here, left);
+                }
+            }
+            if (row > m_first_row) {
+                for (int x = tile.x; x < tile.x + tile.width; ++x) {
+                    int here = *seamLabel(x, tile.y);
+                    int up =   *seamLabel(x, tile.y - 1);
+                    if (here != c_no_label && up != c_no_label) m_union_find.unite(here, up);
+                }
+            }
+        }
+    }
+    DR_COUNT(Pixels_Scanned, static_cast<long long>(m_region.width) * m_region.height);
+
+    // Point every label straight at its root, so lookups while tracing don't change the union find
+    for (int index = 0; index < static_cast<int>(m_union_find.labels.size()); ++index) {
+        m_union_find.labels[index].parent = m_union_find.find(index);
+    }
+    for (int index = 0; index < static_cast<int>(m_union_find.labels.size()); ++index) {
+        if (m_union_find.labels[index].parent == index) addComponent(m_union_find.labels[index]);
+    }
+
+    // ***** No background pixels, whole image is one object (same as FindObjectsInBitmap())
+    if (objects && background_count == 0) {
+        DrObjectBounds object;
+        object.rect =           m_region;
+        object.seed =           DrPoint(0, 0);
+        object.pixel_count =    m_region.width * m_region.height;
+        components.clear();
+        components.push_back(object);
+    }
+
+    // ***** FindObjectsInBitmap() scans columns, so components are found in order of first pixel in column order
+    std::sort(components.begin(), components.end(), [](const DrObjectBounds &a, const DrObjectBounds &b) {
+        return (a.seed.x < b.seed.x) || (a.seed.x == b.seed.x && a.seed.y < b.seed.y);
+    });
+}
+
+
+//####################################################################################
+//##    Traces component the same way as Dr::TraceImageOutline(), following contour from tile to tile. Pixels of the
+//##    component around the tile being traced (it and two pixels past it, for border tests) come from labeling the
+//##    tile again and looking up frames of its neighbors, so contour pieces of each tile join up across seams. Pixels
+//##    traced once / twice are kept per contour pixel, a few tiles are kept for contours that wander back and forth.
+//##        Returns empty list if active budget runs out (see DrBudget) before outline is closed
+//####################################################################################
+void DrTileComponents::loadWindow(int x, int y, const DrPoint &seed, TileWindow &window) const {
+    window.tile = tileRect(x / m_tile_size, y / m_tile_size);
+    int left =   Dr::Max(window.tile.x - c_frame_depth, 0);
+    int top =    Dr::Max(window.tile.y - c_frame_depth, 0);
+    int right =  Dr::Min(window.tile.x + window.tile.width  + c_frame_depth, m_bitmap.width);
+    int bottom = Dr::Min(window.tile.y + window.tile.height + c_frame_depth, m_bitmap.height);
+    window.rect = DrRect(left, top, right - left, bottom - top);
+    window.member.assign(static_cast<size_t>(window.rect.width) * window.rect.height, 0);
+
+    // Tile itself, then pixels around it from frames of neighboring tiles
+    std::vector<unsigned char> tile;
+    componentTile(window.tile, seed, tile);
+    int region_right =  m_region.x + m_region.width;
+    int region_bottom = m_region.y + m_region.height;
+    for (int j = top; j < bottom; ++j) {
+        for (int i = left; i < right; ++i) {
+            unsigned char &member = window.member[static_cast<size_t>(j - top) * window.rect.width + (i - left)];
+            if (i >= window.tile.x && j >= window.tile.y && i < window.tile.x + window.tile.width && j < window.tile.y + window.tile.height) {
+                member = tile[static_cast<size_t>(j - window.tile.y) * window.tile.width + (i - window.tile.x)];
+                continue;
+            }
+            if (i < m_region.x || j < m_region.y || i >= region_right || j >= region_bottom) continue;
+            const int *label = seamLabel(i, j);
+            if (label == nullptr || *label == c_no_label) continue;
+            const TileLabel &root = m_union_find.labels[m_union_find.labels[*label].parent];
+            member = (root.seed_x == seed.x && root.seed_y == seed.y) ? 1 : 0;
+        }
+    }
+}
+
+std::vector<DrPointF> DrTileComponents::traceOutline(const DrObjectBounds &component) const {
+    DR_TIME_SCOPE("traceOutline");
+    // Fewer than three pixels can't have three border pixels, Dr::TraceImageOutline() returns nothing then too
+    if (component.pixel_count < 3 || m_region.width <= 0 || m_region.height <= 0) return std::vector<DrPointF> { };
+
+    std::vector<TileWindow> windows;
+    windows.reserve(c_window_cache);
+    TileWindow *window = nullptr;
+    long        step = 0;
+    auto member = [this, &window](int x, int y) -> bool {
+        if (x < 0 || y < 0 || x >= m_bitmap.width || y >= m_bitmap.height) return false;
+        return window->member[static_cast<size_t>(y - window->rect.y) * window->rect.width + (x - window->rect.x)] != 0;
+    };
+    auto border = [this, &member](int x, int y) -> bool {
+        if (member(x, y) == false) return false;
+        if (x == 0 || y == 0 || (x == m_bitmap.width - 1) || (y == m_bitmap.height - 1)) return true;
+        for (int i = x - 1; i <= x + 1; ++i) {
+            for (int j = y - 1; j <= y + 1; ++j) {
+                if (member(i, j) == false) return true;
+            }
+        }
+        return false;
+    };
+
+    // Times each border pixel was added, start pixel is never counted (same as TraceImageOutline() flags)
+    std::unordered_map<size_t, unsigned char> traced;
+    auto tracedCount = [this, &traced](int x, int y) -> int {
+        auto it = traced.find(static_cast<size_t>(y) * m_bitmap.width + x);
+        return (it == traced.end()) ? 0 : it->second;
+    };
+
+    // ***** Start is first border pixel in column order, which is the seed of the component
+    DrPoint start = component.seed;
+    DrPoint last_point(start.x - 1, start.y);
+    std::vector<DrPoint> points { start };
+    std::vector<DrPoint> surround;
+    bool back_at_start;
+    do {
+        if (Dr::BudgetCheck()) return std::vector<DrPointF> { };
+        DrPoint current_point = points.back();
+
+        // Tile of current pixel, contour crossing a seam continues in tile on the other side
+        ++step;
+        if (window == nullptr || window->tile.contains(current_point) == false) {
+            window = nullptr;
+            for (auto &cached : windows) {
+                if (cached.tile.contains(current_point)) { window = &cached;  break; }
+            }
+            if (window == nullptr) {
+                if (static_cast<int>(windows.size()) < c_window_cache) {
+                    windows.push_back(TileWindow());
+                    window = &windows.back();
+                } else {
+                    window = &windows[0];
+                    for (auto &cached : windows) if (cached.used < window->used) window = &cached;
+                }
+                loadWindow(current_point.x, current_point.y, component.seed, *window);
+            }
+        }
+        window->used = step;
+
+        // Collect list of points around current point
+        surround.clear();
+        int x_start = (current_point.x > 0) ?                       current_point.x - 1 : 0;
+        int x_end =   (current_point.x < m_bitmap.width - 1)  ?     current_point.x + 1 : m_bitmap.width  - 1;
+        int y_start = (current_point.y > 0) ?                       current_point.y - 1 : 0;
+        int y_end =   (current_point.y < m_bitmap.height - 1) ?     current_point.y + 1 : m_bitmap.height - 1;
+        for (int x = x_start; x <= x_end; ++x) {
+            for (int y = y_start; y <= y_end; ++y) {
+                if (x == current_point.x && y == current_point.y) continue;
+                if (border(x, y) && tracedCount(x, y) < 2) surround.push_back(DrPoint(x, y));
+            }
+        }
+
+        // Compare surrounding points to see which one has the greatest angle measured clockwise from the last set of points
+        double   last_point_angle = Dr::CalcRotationAngleInDegrees(current_point.toPointF(), last_point.toPointF());
+        double   angle_diff = 0;
+        bool     first = true;
+        DrPoint  next_point;
+        for (auto point : surround) {
+            double check_angle = Dr::CalcRotationAngleInDegrees(current_point.toPointF(), point.toPointF());
+            while (check_angle > 0) {                 check_angle -= 360.0; }
+            while (check_angle <= last_point_angle) { check_angle += 360.0; }
+            double check_point_diff = check_angle - last_point_angle;
+            if (first || check_point_diff < angle_diff) {
+                angle_diff = check_point_diff;
+                next_point = point;
+                first = false;
+            }
+        }
+
+        // If we found an angle, we found our next point, add it to the list
+        if (surround.size() > 0) {
+            if ((current_point == start) == false) {
+                unsigned char &count = traced[static_cast<size_t>(current_point.y) * m_bitmap.width + current_point.x];
+                if (count < 2) count++;
+            }
+            last_point = current_point;
+            points.push_back(next_point);
+        }
+        back_at_start = (points.back() == start);
+
+    } while ((surround.size() > 0) && !back_at_start);
+
+    // ***** Convert to DrPointF array and return
+    std::vector<DrPointF> hull_points;
+    for (size_t i = 0; i < points.size(); ++i) {
+        hull_points.push_back(DrPointF(points[i].x, points[i].y));
+    }
+    return hull_points;
+}
@@ -0,0 +1,149 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef IMAGING_TILED_H
+#define IMAGING_TILED_H
+
+#include <utility>
+#include <vector>
+
+#include "compare.h"
+#include "imaging.h"
+#include "types/bitmap_view.h"
+#include "types/point.h"
+#include "types/pointf.h"
+#include "types/rect.h"
+
+
+//####################################################################################
+//##    Union find over provisional labels, each root keeps bounds / pixel count / seed of its whole component
+//############################
+struct TileLabel {
+    int     parent;
+    int     min_x, min_y, max_x, max_y;
+    int     seed_x, seed_y;                         // First pixel in column order
+    int     pixel_count;
+    bool    on_edge;                                // Has a pixel on edge of labeled region
+};
+
+class TileLabels
+{
+public:
+    std::vector<TileLabel>      labels;
+
+    int add(int x, int y) {
+        TileLabel label { static_cast<int>(labels.size()), x, y, x, y, x, y, 0 };
+        labels.push_back(label);
+        return label.parent;
+    }
+
+    int find(int label) {
+        while (labels[label].parent != label) {
+            labels[label].parent = labels[labels[label].parent].parent;
+            label = labels[label].parent;
+        }
+        return label;
+    }
+
+    int unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return a;
+        if (b < a) std::swap(a, b);
+        TileLabel &keep = labels[a];
+        TileLabel &from = labels[b];
+        from.parent = a;
+        keep.min_x = Dr::Min(keep.min_x, from.min_x);   keep.max_x = Dr::Max(keep.max_x, from.max_x);
+        keep.min_y = Dr::Min(keep.min_y, from.min_y);   keep.max_y = Dr::Max(keep.max_y, from.max_y);
+        if (from.seed_x < keep.seed_x || (from.seed_x == keep.seed_x && from.seed_y < keep.seed_y)) {
+            keep.seed_x = from.seed_x;
+            keep.seed_y = from.seed_y;
+        }
+        keep.pixel_count += from.pixel_count;
+        keep.on_edge = keep.on_edge || from.on_edge;
+        return a;
+    }
+
+    void addPixel(int root, int x, int y) {
+        TileLabel &label = labels[root];
+        label.min_x = Dr::Min(label.min_x, x);          label.max_x = Dr::Max(label.max_x, x);
+        label.min_y = Dr::Min(label.min_y, y);          label.max_y = Dr::Max(label.max_y, y);
+        if (x < label.seed_x || (x == label.seed_x && y < label.seed_y)) {
+            label.seed_x = x;
+            label.seed_y = y;
+        }
+        label.pixel_count++;
+    }
+};
+
+
+//####################################################################################
+//##    DrTileComponents
+//##        4 connected components of an image (objects, pixels with alpha >= alpha_tolerance) or of the pixels around
+//##        one object inside its bounds (holes), labeled one tile at a time. Only labels of the two pixel deep frame
+//##        of each tile are kept, labels stitched across seams. Anything else a tile needs is labeled again when
+//##        the tile is visited, so outlines are traced a tile at a time (see traceOutline()) with working memory of
+//##        a few tiles plus the seam frames, whatever the size of the object.
+//##
+//##        Components are in the order, and with the same single pixel / no background rules, as FindObjectsInBitmap().
+//##        If active budget (see DrBudget) runs out list is partial, check Dr::BudgetExpired() after.
+//############################
+class DrTileComponents
+{
+public:
+    std::vector<DrObjectBounds>     components;                                 // Objects, or holes of one object
+
+public:
+    // Constructors
+    DrTileComponents(const DrBitmapView &bitmap, double alpha_tolerance, int tile_size);       // Objects of image
+    DrTileComponents(const DrTileComponents &objects, const DrObjectBounds &object);           // Holes of one object
+
+    // Bounds plus a one pixel border (clipped to image), same as 'rect' from Dr::ObjectBitmap()
+    DrRect                  maskRect(const DrObjectBounds &component) const;
+    bool                    fitsTile(const DrObjectBounds &component) const;
+
+    // Same points as Dr::TraceImageOutline() of component pixels copied out, in image coordinates
+    std::vector<DrPointF>   traceOutline(const DrObjectBounds &component) const;
+
+private:
+    // Pixels of traced component around one tile of the grid (aligned to image, clipped to labeled region)
+    struct TileWindow {
+        DrRect                      tile;
+        DrRect                      rect;                                       // Tile plus two pixels, clipped to image
+        std::vector<unsigned char>  member;                                     // 1 where pixel is part of traced component
+        long                        used        { 0 };                          // Step of trace window was last needed
+    };
+
+    DrBitmapView                m_bitmap;
+    int                         m_alpha             { 0 };
+    int                         m_tile_size         { 1 };
+    DrRect                      m_region;                                       // Image for objects, mask rect for holes
+    const DrTileComponents     *m_objects           { nullptr };                // Holes: pixels of object at m_object_seed aren't labeled
+    DrPoint                     m_object_seed;
+    int                         m_first_column      { 0 };                      // Tiles of grid covering m_region
+    int                         m_first_row         { 0 };
+    int                         m_columns           { 0 };
+    int                         m_rows              { 0 };
+    TileLabels                  m_union_find;                                   // Components with a pixel in a frame
+    std::vector<int>            m_seam_rows;                                    // Labels of first / last two rows of each tile row
+    std::vector<int>            m_seam_columns;                                 // Labels of first / last two columns of each tile column
+
+    void                    build(bool objects);
+    DrRect                  tileRect(int column, int row) const;
+    const int*              seamLabel(int x, int y) const;                      // nullptr if pixel isn't in a tile frame
+    int*                    seamLabel(int x, int y);
+    void                    memberTile(const DrRect &tile, std::vector<unsigned char> &member) const;
+    void                    labelTile(const DrRect &tile, std::vector<unsigned char> &member, std::vector<int> &labels,
+                                      TileLabels &locals) const;
+    void                    componentTile(const DrRect &tile, const DrPoint &seed, std::vector<unsigned char> &member) const;
+    void                    loadWindow(int x, int y, const DrPoint &seed, TileWindow &window) const;
+};
+
+
+#endif // IMAGING_TILED_H
@@ -0,0 +1,170 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include "instrument.h"
+
+#if defined(EXTRUDE_INSTRUMENT)
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Local Constants
+const size_t c_max_trace_events =   1 << 20;        // Trace events kept per reset, later events are dropped (stage totals still count)
+
+// Local Structs
+struct TraceEvent {
+    const char     *name;
+    double          start_us;                       // Microseconds since last reset
+    double          duration_us;
+    int             thread;
+};
+
+struct StageTotal {
+    const char     *name;
+    int             calls;
+    double          total_ms;
+    double          max_ms;
+};
+
+// Collector, counters are atomic so hot loops (flood fills) don't take the lock
+static std::mutex                                   g_mutex;
+static std::atomic<long long>                       g_counters[static_cast<int>(Stat_Counter::Count)];
+static std::vector<StageTotal>                      g_stages;
+static std::vector<TraceEvent>                      g_events;
+static std::vector<std::thread::id>                 g_threads;              // Index + 1 is thread id used in trace
+static bool                                         g_record_trace = false;
+static std::chrono::steady_clock::time_point        g_epoch = std::chrono::steady_clock::now();
+
+
+namespace Dr
+{
+
+
+//####################################################################################
+//##    Collection
+//####################################################################################
+void InstrumentReset(bool record_trace) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (auto &counter : g_counters) counter.store(0);
+    g_stages.clear();
+    g_events.clear();
+    g_threads.clear();
+    g_record_trace = record_trace;
+    g_epoch = std::chrono::steady_clock::now();
+}
+
+void AddToCounter(Stat_Counter type, long long amount) {
+    g_counters[static_cast<int>(type)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+// Stage names are string literals, same stage from different translation units can have different pointers so names are compared
+void RecordStage(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    StageTotal *total = nullptr;
+    for (auto &stage : g_stages) {
+        if (stage.name == name || strcmp(stage.name, name) == 0) { total = &stage; break; }
+    }
+    if (total == nullptr) {
+        g_stages.push_back({ name, 0, 0.0, 0.0 });
+        total = &g_stages.back();
+    }
+    total->calls++;
+    total->total_ms += duration_ms;
+    if (duration_ms > total->max_ms) total->max_ms = duration_ms;
+
+    if (g_record_trace == false || g_events.size() >= c_max_trace_events) return;
+    std::thread::id id = std::this_thread::get_id();
+    int thread = 0;
+    while (thread < static_cast<int>(g_threads.size()) && g_threads[thread] != id) thread++;
+    if (thread == static_cast<int>(g_threads.size())) g_threads.push_back(id);
+    TraceEvent event;
+    event.name =        name;
+    event.start_us =    std::chrono::duration<double, std::micro>(start - g_epoch).count();
+    event.duration_us = duration_ms * 1000.0;
+    event.thread =      thread + 1;
+    g_events.push_back(event);
+}
+
+DrPipelineStats InstrumentStats() {
+    DrPipelineStats stats;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (const auto &total : g_stages) {
+        DrStageStats stage;
+        stage.name =        total.name;
+        stage.calls =       total.calls;
+        stage.total_ms =    total.total_ms;
+        stage.max_ms =      total.max_ms;
+        stats.stages.push_back(stage);
+    }
+    for (int c = 0; c < static_cast<int>(Stat_Counter::Count); c++) stats.counters[c] = g_counters[c].load();
+    return stats;
+}
+
+const char* CounterName(Stat_Counter type) {
+    switch (type) {
+        case Stat_Counter::Pixels_Scanned:              return "pixels_scanned";
+        case Stat_Counter::Pixels_Trimmed:              return "pixels_trimmed";
+        case Stat_Counter::Objects_Found:               return "objects_found";
+        case Stat_Counter::Flood_Fills:                 return "flood_fills";
+        case Stat_Counter::Contour_Points_Traced:       return "contour_points_traced";
+        case Stat_Counter::Contour_Points_Smoothed:     return "contour_points_smoothed";
+        case Stat_Counter::Contour_Points_Simplified:   return "contour_points_simplified";
+        case Stat_Counter::Triangles_Ear_Clipping:      return "triangles_ear_clipping";
+        case Stat_Counter::Triangles_Triangulate_Opt:   return "triangles_triangulate_opt";
+        case Stat_Counter::Triangles_Monotone:          return "triangles_monotone";
+        case Stat_Counter::Vertices_Before_Remap:       return "vertices_before_remap";
+        case Stat_Counter::Vertices_After_Remap:        return "vertices_after_remap";
+        case Stat_Counter::Bytes_Allocated:             return "bytes_allocated";
+        case Stat_Counter::Count:                       break;
+    }
+    return "";
+}
+
+
+//####################################################################################
+//##    Chrome Trace Event Format (JSON object form)
+//##        Stages are complete ("X") events, one track per thread. Counter totals are written as one counter ("C")
+//##        event at the end of the trace.
+//####################################################################################
+bool WriteTraceEvents(const std::string &path) {
+    DrPipelineStats stats = InstrumentStats();
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"extrude\"}}");
+    for (size_t t = 0; t < g_threads.size(); t++) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                static_cast<int>(t + 1), static_cast<int>(t + 1));
+    }
+    double last_us = 0.0;
+    for (const auto &event : g_events) {
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"extrude\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                event.name, event.start_us, event.duration_us, event.thread);
+        if (event.start_us + event.duration_us > last_us) last_us = event.start_us + event.duration_us;
+    }
+    fprintf(file, ",\n{\"name\":\"counters\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":0,\"args\":{", last_us);
+    for (int c = 0; c < static_cast<int>(Stat_Counter::Count); c++) {
+        fprintf(file, "%s\"%s\":%lld", (c > 0) ? "," : "", CounterName(static_cast<Stat_Counter>(c)), stats.counters[c]);
+    }
+    fprintf(file, "}}\n]}\n");
+    return (fclose(file) == 0);
+}
+
+
+}   // End namespace Dr
+
+#endif  // EXTRUDE_INSTRUMENT
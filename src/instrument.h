@@ -0,0 +1,119 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef ENGINE_INSTRUMENT_H
+#define ENGINE_INSTRUMENT_H
+
+#include <string>
+#include <vector>
+
+#if defined(EXTRUDE_INSTRUMENT)
+    #include <chrono>
+#endif
+
+// Pipeline counters, summed over every thread since the last Dr::InstrumentReset()
+enum class Stat_Counter {
+    Pixels_Scanned,                             // Pixels checked by FindObjectsInBitmap() for new objects
+    Pixels_Trimmed,                             // Transparent margin pixels DrImage::outlinePoints() skipped (see Dr::AlphaBounds())
+    Objects_Found,                              // Objects found by DrImage::outlinePoints() (holes not included)
+    Flood_Fills,                                // Calls to FloodFill()
+    Contour_Points_Traced,                      // Outline / hole points from TraceImageOutline()
+    Contour_Points_Smoothed,                    // ...after DrMesh::smoothPoints()
+    Contour_Points_Simplified,                  // ...after Ramer-Douglas-Peucker
+    Triangles_Ear_Clipping,                     // Face triangles from DrMesh::triangulateFace(), per Trianglulation mode
+    Triangles_Triangulate_Opt,
+    Triangles_Monotone,
+    Vertices_Before_Remap,                      // Vertices going into DrMesh::optimizeMesh()
+    Vertices_After_Remap,                       // Unique vertices left after remap
+    Bytes_Allocated,                            // Bytes of bitmaps / buffers created by instrumented stages
+
+    Count,
+};
+
+// Total time spent in one named stage
+struct DrStageStats {
+    std::string     name;
+    int             calls           { 0 };
+    double          total_ms        { 0.0 };
+    double          max_ms          { 0.0 };
+};
+
+// Snapshot returned by Dr::InstrumentStats()
+struct DrPipelineStats {
+    std::vector<DrStageStats>   stages      { };                                // In order each stage was first entered
+    long long                   counters[static_cast<int>(Stat_Counter::Count)] = { };
+
+    long long               counter(Stat_Counter type) const    { return counters[static_cast<int>(type)]; }
+    const DrStageStats*     stage(const std::string &name) const;
+};
+
+
+//####################################################################################
+//##    Instrumentation
+//##        Built with EXTRUDE_INSTRUMENT defined, scoped timers and counters are recorded from any thread into one
+//##        process wide collector. Without it, DR_TIME_SCOPE / DR_COUNT compile to nothing and the functions below
+//##        are empty inlines returning empty stats.
+//##
+//##        Usage:  Dr::InstrumentReset(true);              // true also records trace events
+//##                DrImage image("name", bitmap, lod);
+//##                DrPipelineStats stats = Dr::InstrumentStats();
+//##                Dr::WriteTraceEvents("trace.json");     // Open with chrome://tracing or ui.perfetto.dev
+//############################
+#if defined(EXTRUDE_INSTRUMENT)
+
+const bool c_instrument_enabled = true;
+
+namespace Dr {
+    void                InstrumentReset(bool record_trace = false);
+    DrPipelineStats     InstrumentStats();
+    bool                WriteTraceEvents(const std::string &path);
+    const char*         CounterName(Stat_Counter type);
+
+    void                AddToCounter(Stat_Counter type, long long amount);
+    void                RecordStage(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+}
+
+// Records time from construction to destruction under 'name', name must be a string literal (pointer is kept)
+class DrScopedTimer
+{
+private:
+    const char                                 *m_name;
+    std::chrono::steady_clock::time_point       m_start;
+public:
+    DrScopedTimer(const char *name) : m_name(name), m_start(std::chrono::steady_clock::now()) { }
+    ~DrScopedTimer() { Dr::RecordStage(m_name, m_start, std::chrono::steady_clock::now()); }
+};
+
+#define DR_INSTRUMENT_JOIN2(a, b)       a##b
+#define DR_INSTRUMENT_JOIN(a, b)        DR_INSTRUMENT_JOIN2(a, b)
+#define DR_TIME_SCOPE(name)             DrScopedTimer DR_INSTRUMENT_JOIN(dr_scoped_timer_, __LINE__)(name)
+#define DR_COUNT(counter, amount)       Dr::AddToCounter(Stat_Counter::counter, static_cast<long long>(amount))
+
+#else
+
+const bool c_instrument_enabled = false;
+
+namespace Dr {
+    inline void             InstrumentReset(bool = false)       { }
+    inline DrPipelineStats  InstrumentStats()                   { return DrPipelineStats(); }
+    inline bool             WriteTraceEvents(const std::string&){ return false; }
+    inline const char*      CounterName(Stat_Counter)           { return ""; }
+}
+
+#define DR_TIME_SCOPE(name)
+#define DR_COUNT(counter, amount)
+
+#endif  // EXTRUDE_INSTRUMENT
+
+inline const DrStageStats* DrPipelineStats::stage(const std::string &name) const {
+    for (const auto &one_stage : stages) if (one_stage.name == name) return &one_stage;
+    return nullptr;
+}
+
+#endif  // ENGINE_INSTRUMENT_H
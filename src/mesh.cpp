@@ -7,6 +7,8 @@
 // Copyright (c) 2021 Stephens Nunnally and Scidian Software
 //
 //
+#include <limits>
+
 #include "3rd_party/handmade_math.h"
 #include "compare.h"
 #include "mesh.h"
@@ -83,6 +85,24 @@ void DrMesh::set(Vertex &from_vertex, Vertex &to_vertex) {
 }
 
 
+//####################################################################################
+//##    Returns axis aligned bounding box of vertex positions
+//####################################################################################
+DrMeshBounds DrMesh::bounds() const {
+    DrMeshBounds box;
+    for (int i = 0; i < 3; i++) {
+        box.min[i] = (vertices.size() > 0) ?  std::numeric_limits<float>::max() : 0.f;
+        box.max[i] = (vertices.size() > 0) ? -std::numeric_limits<float>::max() : 0.f;
+    }
+    for (const auto &v : vertices) {
+        box.min[0] = Dr::Min(box.min[0], v.px);     box.max[0] = Dr::Max(box.max[0], v.px);
+        box.min[1] = Dr::Min(box.min[1], v.py);     box.max[1] = Dr::Max(box.max[1], v.py);
+        box.min[2] = Dr::Min(box.min[2], v.pz);     box.max[2] = Dr::Max(box.max[2], v.pz);
+    }
+    return box;
+}
+
+
 //####################################################################################
 //##    Builds a Textured Quad
 //####################################################################################
@@ -253,37 +273,6 @@ void DrMesh::triangle(float x1, float y1, float tx1, float ty1,
     add(DrVec3(x2, y2, -depth), n, DrVec2(tx2, ty2), Triangle_Point::Point3);
 }
 
-//####################################################################################
-//##    Adds a Quad extruded from an Edge
-//####################################################################################
-void DrMesh::extrude(float x1, float y1, float tx1, float ty1,
-                     float x2, float y2, float tx2, float ty2, int steps, float depth_multiplier) {
-    float depth = c_extrude_depth * depth_multiplier;
-
-    float step = (depth * 2.0f) / static_cast<float>(steps);
-    float front = depth;
-    float back =  depth - step;
-
-    for (int i = 0; i < steps; i++) {
-        DrVec3 n;
-        n = DrVec3::triangleNormal(DrVec3(x1, y1, front), DrVec3(x2, y2, front), DrVec3(x1, y1, back));
-
-        add(DrVec3(x1, y1, front), n, DrVec2(tx1, ty1), Triangle_Point::Point1);
-        add(DrVec3(x1, y1, back),  n, DrVec2(tx1, ty1), Triangle_Point::Point2);
-        add(DrVec3(x2, y2, front), n, DrVec2(tx2, ty2), Triangle_Point::Point3);
-
-        n = DrVec3::triangleNormal(DrVec3(x2, y2, front), DrVec3(x2, y2, back), DrVec3(x1, y1, back));
-
-        add(DrVec3(x2, y2, front), n, DrVec2(tx2, ty2), Triangle_Point::Point1);
-        add(DrVec3(x1, y1, back),  n, DrVec2(tx1, ty1), Triangle_Point::Point2);
-        add(DrVec3(x2, y2, back),  n, DrVec2(tx2, ty2), Triangle_Point::Point3);
-
-        front -= step;
-        back  -= step;
-    }
-
-}
-
 
 
 
@@ -10,7 +10,9 @@
 #ifndef ENGINE_MESH_H
 #define ENGINE_MESH_H
 
+#include <cstdint>
 #include <map>
+#include <string>
 #include <vector>
 #include "types/vec3.h"
 
@@ -21,6 +23,7 @@ class DrPointF;
 class DrVec2;
 class DrVec3;
 class Vertex;
+struct DrMeshLevel;
 
 // Type Definitions
 typedef std::map<DrVec3, std::vector<Vertex>> NeighborMap;
@@ -34,6 +37,13 @@ const int   c_vertex_length = 11;
 const float c_extrude_depth = 0.1f;
 const float c_cube_depth =    0.5f;
 
+const unsigned int c_strip_restart_index = 0xFFFFFFFF;     // Primitive restart index used in strip_indices, use 0xFFFF when copying to 16 bit indices
+
+const int   c_meshlet_max_vertices =    64;         // Meshlet size limits, mesh optimizer requires max triangles to be a multiple of 4
+const int   c_meshlet_max_triangles =   124;
+
+const unsigned int c_max_short_batch_vertices = 0xFFFF;     // Vertices per 16 bit draw batch, 0xFFFF itself is left free as restart index
+
 // Local Enums
 enum class Trianglulation {
     Ear_Clipping,
@@ -41,6 +51,18 @@ enum class Trianglulation {
     Monotone,
 };
 
+enum class Side_Profile {
+    Flat,                                           // Straight walls, one quad per outline edge
+    Bevel,                                          // Walls chamfered outward by profile_size, flat in the middle
+    Round,                                          // Walls rounded outward by profile_size, sliced to chord tolerance
+};
+
+enum class Strip_Type {
+    None,                                           // Triangle list only
+    Primitive_Restart,                              // Strips separated by c_strip_restart_index
+    Degenerate,                                     // Strips stitched with degenerate triangles, for targets without primitive restart (GLES2)
+};
+
 enum class Triangle_Point {
     Point1,
     Point2,
@@ -65,6 +87,32 @@ union Triangle {
 	char data[sizeof(Vertex) * 3];
 };
 
+//####################################################################################
+//##    DrMeshlet
+//##        Cluster of up to c_meshlet_max_triangles triangles, with bounds for culling
+//############################
+struct DrMeshlet {
+    unsigned int vertex_offset;                     // Offset into DrMesh::meshlet_vertices
+    unsigned int triangle_offset;                   // Offset into DrMesh::meshlet_triangles
+    unsigned int vertex_count;
+    unsigned int triangle_count;
+
+    float center[3];                                // Bounding sphere
+    float radius;
+    float cone_apex[3];                             // Normal cone, cluster is backfacing when
+    float cone_axis[3];                             //      dot(normalize(cone_apex - camera), cone_axis) >= cone_cutoff
+    float cone_cutoff;
+};
+
+//####################################################################################
+//##    DrMeshBounds
+//##        Axis aligned bounding box of one mesh, stored per object in mesh files
+//############################
+struct DrMeshBounds {
+    float min[3];
+    float max[3];
+};
+
 
 //####################################################################################
 //##    DrMesh
@@ -75,6 +123,12 @@ class DrMesh
 public:
     std::vector<unsigned int>   indices     { };
     std::vector<Vertex>         vertices    { };
+    std::vector<unsigned int>   strip_indices   { };    // Optional, triangle strip version of indices, filled by optimizeMesh()
+
+    // Optional, filled by buildMeshlets(), cleared by anything that rebuilds indices / vertices
+    std::vector<DrMeshlet>      meshlets            { };
+    std::vector<unsigned int>   meshlet_vertices    { };        // Indices into vertices
+    std::vector<unsigned char>  meshlet_triangles   { };        // Three indices into meshlet_vertices per triangle, relative to meshlet vertex_offset
 
 public:    
     // Constructor
@@ -83,23 +137,52 @@ public:
     // Properties
     int             indexCount() const      { return indices.size(); }
     int             vertexCount() const     { return vertices.size(); }
+    int             stripIndexCount() const { return strip_indices.size(); }
 
     // Creation Functions
-    void    extrudeObjectFromPolygon(DrImage *image, int poly_number, int quality, float depth_multiplier);
+    void    extrudeObjectFromPolygon(DrImage *image, int poly_number, int quality, float depth_multiplier,
+                                     Side_Profile profile = Side_Profile::Flat, float profile_size = 0.f);
+    static  std::vector<int>    reuseObjectMeshes(const std::vector<int> &previous_objects, std::vector<DrMesh> &meshes);
     void    initializeTextureCube(float size);
     void    initializeTextureQuad(float size);
 
     // Optimize Mesh
-    void    optimizeMesh();
-    void    smoothMesh();
+    void    optimizeMesh(Strip_Type strip_type = Strip_Type::None);
+    void    smoothMesh(int iterations = 1, float weld_tolerance = 0.5f);
+    void    generateNormals(float crease_angle = 40.f);                 // Angle weighted vertex normals, split at creases sharper than crease_angle
+
+    // Bounds
+    DrMeshBounds    bounds() const;
+
+    // Meshlets
+    void            buildMeshlets(float cone_weight = 0.5f);
+    void            clearMeshlets();
+    size_t          visibleIndices(const DrVec3 &camera_position, std::vector<unsigned int> &visible) const;
+
+    // Level of Detail, builds chain of simplified meshes from this (already optimized) mesh, level 0 is a copy of this mesh
+    std::vector<DrMeshLevel>    buildLevelsOfDetail(int level_count, float triangle_ratio = 0.5f, float target_error = 0.05f,
+                                                    bool allow_sloppy = false) const;
+
+    // Mesh Files (.extm), compressed with mesh optimizer vertex / index codecs
+    bool            saveToFile(std::string filename) const;                                     // Returns false on failure
+    bool            loadFromFile(std::string filename);                                         // Returns false on failure
+    static  bool    saveMeshes(std::string filename, const std::vector<DrMesh> &meshes);        // Returns false on failure
+    static  bool    loadMeshes(std::string filename, std::vector<DrMesh> &meshes, std::vector<DrMeshBounds> *bounds = nullptr);
+    static  void    encodeMeshes(const std::vector<DrMesh> &meshes, std::vector<unsigned char> &file_data);
+    static  bool    decodeMeshes(const unsigned char *file_data, size_t file_size, std::vector<DrMesh> &meshes,
+                                 std::vector<DrMeshBounds> *bounds = nullptr);
 
     // Helper Functions
     static  std::vector<DrPointF>   insertPoints(  const std::vector<DrPointF> &outline_points);
     static  std::vector<DrPointF>   smoothPoints(  const std::vector<DrPointF> &outline_points, int neighbors, double neighbor_distance, double weight);
+    static  size_t  weldPositions(const std::vector<Vertex> &vertices, float tolerance, std::vector<unsigned int> &remap);
+    static  void    profileSlices(Side_Profile profile, float profile_size, float depth, float tolerance,
+                                  std::vector<float> &depths, std::vector<float> &offsets);
 
 
     // Extrusion Functions
-    void    extrudeFacePolygon(const std::vector<DrPointF> &outline_points, int width, int height, int steps, bool reverse = false, float depth_multiplier = 1.f);
+    void    extrudeFacePolygon(const std::vector<DrPointF> &outline_points, int width, int height,
+                               const std::vector<float> &depths, const std::vector<float> &offsets, bool reverse = false);
     void    triangulateFace(const std::vector<DrPointF> &outline_points, const std::vector<std::vector<DrPointF>> &hole_list,
                             const DrBitmap &image, Trianglulation type, double alpha_tolerance, float depth_multiplier);
 
@@ -108,8 +191,6 @@ public:
 
     // Building Functions
     void    add(const DrVec3 &vertex, const DrVec3 &normal, const DrVec2 &text_coord, Triangle_Point point_number);
-    void    extrude(float x1, float y1, float tx1, float ty1,
-                    float x2, float y2, float tx2, float ty2, int steps = 1, float depth_multiplier = 1.f);
     void    cube(float x1, float y1, float tx1, float ty1,
                  float x2, float y2, float tx2, float ty2,
                  float x3, float y3, float tx3, float ty3,
@@ -124,6 +205,65 @@ public:
 };
 
 
+//####################################################################################
+//##    DrMeshLevel
+//##        One level of a level of detail chain, see DrMesh::buildLevelsOfDetail()
+//############################
+struct DrMeshLevel {
+    DrMesh      mesh;                               // Optimized mesh for this level
+    int         target_triangles    { 0 };          // Triangle count simplifier was asked for
+    float       error               { 0.f };        // Deviation from level 0, relative to mesh extents
+    float       absolute_error      { 0.f };        // Deviation from level 0, in mesh units
+    bool        sloppy              { false };      // True if topology preserving simplifier stalled and sloppy simplifier was used
+
+    int         triangleCount() const   { return mesh.indexCount() / 3; }
+};
+
+
+//####################################################################################
+//##    DrDrawBatch
+//##        One draw call of a DrMeshPack, indices are relative to base_vertex
+//############################
+struct DrDrawBatch {
+    unsigned int    base_vertex     { 0 };          // First vertex in DrMeshPack::vertices, bind as vertex buffer offset (base_vertex * sizeof(Vertex))
+    unsigned int    vertex_count    { 0 };
+    unsigned int    first_index     { 0 };          // First element in short_indices or long_indices
+    unsigned int    index_count     { 0 };
+    bool            long_indices    { false };      // True if batch uses long_indices (32 bit), otherwise short_indices (16 bit)
+};
+
+//####################################################################################
+//##    DrMeshPack
+//##        Packs many meshes into one vertex buffer and 16 / 32 bit index buffers for drawing.
+//##        Meshes are merged into 16 bit batches of up to c_max_short_batch_vertices vertices. A mesh larger than that
+//##        gets its own 32 bit batch, or when long indices aren't allowed (GLES2 without OES_element_index_uint) it is
+//##        split by triangles into as many 16 bit batches as needed.
+//############################
+class DrMeshPack
+{
+public:
+    std::vector<Vertex>         vertices        { };
+    std::vector<uint16_t>       short_indices   { };
+    std::vector<uint32_t>       long_indices    { };
+    std::vector<DrDrawBatch>    batches         { };
+
+public:
+    void    clear();
+    void    pack(const std::vector<DrMesh> &meshes, bool allow_long_indices = true);
+    void    addMesh(const DrMesh &mesh, bool allow_long_indices = true);
+    void    finish();                                   // Closes open batch, call after last addMesh()
+
+    int     triangleCount() const   { return (short_indices.size() + long_indices.size()) / 3; }
+
+private:
+    DrDrawBatch     m_open;                             // Batch currently being filled with 16 bit indices
+
+    void    openBatch();
+    void    closeBatch();
+    void    splitMesh(const DrMesh &mesh);
+};
+
+
 #endif // ENGINE_MESH_H
 
 
@@ -0,0 +1,177 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <vector>
+
+#include "mesh.h"
+#include "mesh_adjacency.h"
+
+
+//####################################################################################
+//##    Building
+//####################################################################################
+void DrMeshAdjacency::clear() {
+    remap.clear();
+    origins.clear();
+    twins.clear();
+    vertex_offsets.clear();
+    vertex_half_edges.clear();
+    m_edge_count =              0;
+    m_boundary_edges =          0;
+    m_non_manifold_edges =      0;
+    m_non_manifold_vertices =   0;
+    m_inconsistent_edges =      0;
+    m_degenerate_triangles =    0;
+}
+
+void DrMeshAdjacency::build(const DrMesh &mesh, float weld_tolerance) {
+    clear();
+    size_t index_count = (mesh.indices.size() > 0) ? mesh.indices.size() : mesh.vertices.size();
+    index_count -= index_count % 3;
+    if (index_count < 3) return;
+
+    // ***** Welded vertices
+    size_t vertex_count = mesh.vertices.size();
+    if (weld_tolerance > 0.f) {
+        vertex_count = DrMesh::weldPositions(mesh.vertices, weld_tolerance, remap);
+    } else {
+        remap.resize(vertex_count);
+        for (size_t i = 0; i < vertex_count; i++) remap[i] = static_cast<unsigned int>(i);
+    }
+
+    // ***** Half-edge origins, half-edges of degenerate triangles (two corners welded together) are left without adjacency
+    origins.resize(index_count);
+    twins.assign(index_count, c_no_half_edge);
+    for (size_t h = 0; h < index_count; h++) {
+        origins[h] = remap[(mesh.indices.size() > 0) ? mesh.indices[h] : static_cast<unsigned int>(h)];
+    }
+    std::vector<bool> degenerate(index_count / 3, false);
+    for (size_t t = 0; t < index_count / 3; t++) {
+        unsigned int a = origins[t*3 + 0], b = origins[t*3 + 1], c = origins[t*3 + 2];
+        if (a == b || b == c || c == a) {
+            degenerate[t] = true;
+            m_degenerate_triangles++;
+        }
+    }
+
+    // ***** Outgoing half-edges of each vertex (CSR, counting sort)
+    vertex_offsets.assign(vertex_count + 1, 0);
+    for (size_t h = 0; h < index_count; h++) {
+        if (degenerate[h / 3] == false) vertex_offsets[origins[h] + 1]++;
+    }
+    for (size_t v = 0; v < vertex_count; v++) vertex_offsets[v + 1] += vertex_offsets[v];
+    vertex_half_edges.resize(vertex_offsets[vertex_count]);
+    std::vector<unsigned int> fill(vertex_offsets.begin(), vertex_offsets.end() - 1);
+    for (size_t h = 0; h < index_count; h++) {
+        if (degenerate[h / 3] == false) vertex_half_edges[fill[origins[h]]++] = static_cast<unsigned int>(h);
+    }
+
+    matchEdges();
+    checkVertexFans();
+}
+
+
+//####################################################################################
+//##    Edge Matching
+//##        Half-edges are sorted by undirected edge key (lower vertex, higher vertex) with two stable counting sorts
+//##        (higher vertex first, then lower vertex), so half-edges of the same edge end up next to each other
+//####################################################################################
+void DrMeshAdjacency::matchEdges() {
+    unsigned int vertex_count = vertexCount();
+    const std::vector<unsigned int> &by_origin = vertex_half_edges;     // Non degenerate half-edges
+
+    // ***** Edge keys
+    std::vector<unsigned int> low(twins.size()), high(twins.size());
+    for (auto h : by_origin) {
+        unsigned int a = origin(h), b = target(h);
+        low[h] =  (a < b) ? a : b;
+        high[h] = (a < b) ? b : a;
+    }
+
+    // ***** Sort by higher vertex
+    std::vector<unsigned int> counts(vertex_count + 1, 0);
+    std::vector<unsigned int> by_high(by_origin.size());
+    for (auto h : by_origin) counts[high[h] + 1]++;
+    for (unsigned int v = 0; v < vertex_count; v++) counts[v + 1] += counts[v];
+    for (auto h : by_origin) by_high[counts[high[h]]++] = h;
+
+    // ***** Stable sort by lower vertex
+    std::vector<unsigned int> sorted(by_origin.size());
+    counts.assign(vertex_count + 1, 0);
+    for (auto h : by_high) counts[low[h] + 1]++;
+    for (unsigned int v = 0; v < vertex_count; v++) counts[v + 1] += counts[v];
+    for (auto h : by_high) sorted[counts[low[h]]++] = h;
+
+    // ***** Runs of equal keys are one edge
+    size_t begin = 0;
+    while (begin < sorted.size()) {
+        unsigned int a = sorted[begin];
+        size_t end = begin + 1;
+        while (end < sorted.size() && low[sorted[end]] == low[a] && high[sorted[end]] == high[a]) end++;
+
+        m_edge_count++;
+        if (end - begin == 1) {
+            m_boundary_edges++;
+        } else if (end - begin == 2) {
+            unsigned int b = sorted[begin + 1];
+            if (origin(a) != origin(b)) {
+                twins[a] = b;
+                twins[b] = a;
+            } else {
+                m_inconsistent_edges++;
+            }
+        } else {
+            m_non_manifold_edges++;
+        }
+        begin = end;
+    }
+}
+
+
+//####################################################################################
+//##    Vertex Fans
+//##        Triangles around a manifold vertex form a single fan (open at a boundary, or closed). A fan starts at an
+//##        outgoing half-edge without twin, walking rotate() from each start (or from any half-edge when there are
+//##        no starts) must visit every outgoing half-edge exactly once.
+//####################################################################################
+void DrMeshAdjacency::checkVertexFans() {
+    for (unsigned int v = 0; v < vertexCount(); v++) {
+        unsigned int count = outgoingCount(v);
+        if (count == 0) continue;
+
+        unsigned int starts = 0, steps = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            unsigned int h = outgoing(v, i);
+            if (twins[h] != c_no_half_edge) continue;
+            starts++;
+            for (unsigned int g = h; g != c_no_half_edge && steps <= count; g = rotate(g)) steps++;
+        }
+        if (starts == 0) {
+            unsigned int first = outgoing(v, 0);
+            unsigned int g = first;
+            do {
+                steps++;
+                g = rotate(g);
+            } while (g != first && g != c_no_half_edge && steps <= count);
+        }
+        if (starts > 1 || steps != count) m_non_manifold_vertices++;
+    }
+}
+
+
+//####################################################################################
+//##    Validation
+//####################################################################################
+bool DrMeshAdjacency::isManifold() const {
+    return (m_non_manifold_edges == 0 && m_non_manifold_vertices == 0 && m_inconsistent_edges == 0 && m_degenerate_triangles == 0);
+}
+
+bool DrMeshAdjacency::isClosed() const {
+    return (isManifold() && m_boundary_edges == 0 && triangleCount() > 0);
+}
@@ -0,0 +1,101 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef ENGINE_MESH_ADJACENCY_H
+#define ENGINE_MESH_ADJACENCY_H
+
+#include <vector>
+
+// Forward Declarations
+class DrMesh;
+
+// Constants
+const unsigned int c_no_half_edge =             0xFFFFFFFF;     // Returned by twin() / neighbor queries on boundary and non-manifold edges
+const float        c_adjacency_weld_tolerance = 0.01f;          // Default weld, joins uv seams and the half texel nudge of side walls
+
+
+//####################################################################################
+//##    DrMeshAdjacency
+//##        Index based half-edge structure of a triangle list. Half-edge h belongs to triangle h / 3 and runs from
+//##        corner h to corner next(h), so next / prev / face are implicit and only twins and origins are stored.
+//##        Vertices are welded positions (see DrMesh::weldPositions()), outgoing half-edges of each vertex are
+//##        stored as CSR. Built in O(I + V) with counting sorts, no hashing or pointers.
+//##
+//##        Twins are only linked for manifold edges (exactly two opposite half-edges), boundary edges, edges shared
+//##        by three or more triangles and edges of inconsistently wound neighbors have no twin.
+//############################
+class DrMeshAdjacency
+{
+public:
+    std::vector<unsigned int>   remap               { };        // Welded vertex of each mesh vertex
+    std::vector<unsigned int>   origins             { };        // Welded vertex each half-edge starts at
+    std::vector<unsigned int>   twins               { };        // Opposite half-edge, or c_no_half_edge
+    std::vector<unsigned int>   vertex_offsets      { };        // Outgoing half-edges of vertex v are
+    std::vector<unsigned int>   vertex_half_edges   { };        //      vertex_half_edges[vertex_offsets[v]] to vertex_half_edges[vertex_offsets[v + 1] - 1]
+
+public:
+    // Constructors
+    DrMeshAdjacency() { }
+    DrMeshAdjacency(const DrMesh &mesh, float weld_tolerance = c_adjacency_weld_tolerance) { build(mesh, weld_tolerance); }
+
+    // Building, weld_tolerance of 0 uses mesh indices as is
+    void            build(const DrMesh &mesh, float weld_tolerance = c_adjacency_weld_tolerance);
+    void            clear();
+
+    // Properties
+    unsigned int    vertexCount() const         { return (vertex_offsets.size() > 0) ? static_cast<unsigned int>(vertex_offsets.size() - 1) : 0; }
+    unsigned int    triangleCount() const       { return static_cast<unsigned int>(twins.size() / 3); }
+    unsigned int    halfEdgeCount() const       { return static_cast<unsigned int>(twins.size()); }
+    unsigned int    edgeCount() const           { return m_edge_count; }
+    unsigned int    boundaryEdgeCount() const   { return m_boundary_edges; }
+    unsigned int    nonManifoldEdgeCount() const    { return m_non_manifold_edges; }
+    unsigned int    nonManifoldVertexCount() const  { return m_non_manifold_vertices; }
+    unsigned int    inconsistentEdgeCount() const   { return m_inconsistent_edges; }
+    unsigned int    degenerateTriangleCount() const { return m_degenerate_triangles; }
+
+    // Validation
+    bool            isManifold() const;                         // Every edge has one or two triangles, every vertex a single fan, winding is consistent
+    bool            isClosed() const;                           // Manifold without boundary edges (watertight)
+
+    // Half-Edge Queries, all O(1)
+    static unsigned int face(unsigned int h)    { return h / 3; }
+    static unsigned int next(unsigned int h)    { return (h % 3 == 2) ? h - 2 : h + 1; }
+    static unsigned int prev(unsigned int h)    { return (h % 3 == 0) ? h + 2 : h - 1; }
+    unsigned int    origin(unsigned int h) const    { return origins[h]; }
+    unsigned int    target(unsigned int h) const    { return origins[next(h)]; }
+    unsigned int    twin(unsigned int h) const      { return twins[h]; }
+    bool            isBoundary(unsigned int h) const    { return twins[h] == c_no_half_edge; }
+
+    // Triangle across edge 'corner' (0 to 2) of triangle t, or c_no_half_edge
+    unsigned int    neighbor(unsigned int t, int corner) const {
+        unsigned int h = twins[t*3 + corner];
+        return (h == c_no_half_edge) ? c_no_half_edge : face(h);
+    }
+
+    // Outgoing half-edges of welded vertex v
+    unsigned int    outgoingCount(unsigned int v) const             { return vertex_offsets[v + 1] - vertex_offsets[v]; }
+    unsigned int    outgoing(unsigned int v, unsigned int i) const  { return vertex_half_edges[vertex_offsets[v] + i]; }
+
+    // Next outgoing half-edge around origin of h (counter clockwise in winding order), or c_no_half_edge at a boundary
+    unsigned int    rotate(unsigned int h) const    { return twins[prev(h)]; }
+
+private:
+    unsigned int    m_edge_count            { 0 };
+    unsigned int    m_boundary_edges        { 0 };
+    unsigned int    m_non_manifold_edges    { 0 };
+    unsigned int    m_non_manifold_vertices { 0 };
+    unsigned int    m_inconsistent_edges    { 0 };
+    unsigned int    m_degenerate_triangles  { 0 };
+
+    void            matchEdges();
+    void            checkVertexFans();
+};
+
+
+#endif // ENGINE_MESH_ADJACENCY_H
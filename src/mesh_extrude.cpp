@@ -8,6 +8,7 @@
 //
 //
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <list>
 #include <vector>
@@ -15,8 +16,10 @@
 #include "3rd_party/mesh_optimizer/meshoptimizer.h"
 #include "3rd_party/poly_partition.h"
 #include "3rd_party/polyline_simplification.h"
+#include "budget.h"
 #include "compare.h"
 #include "imaging.h"
+#include "instrument.h"
 #include "mesh.h"
 #include "types/color.h"
 #include "types/image.h"
@@ -24,13 +27,25 @@
 #include "types/pointf.h"
 #include "types/polygonf.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DR_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Local Constants
+const float c_profile_tolerance =   4.0f;           // Chord error (in pixels) allowed on round side profiles, divided by quality
+const float c_bevel_fraction =      0.25f;          // Fraction of total depth taken by each bevel chamfer
+const int   c_max_profile_slices =  32;
+
 //####################################################################################
 //##    Builds an Extruded DrImage Model
 //####################################################################################
-void DrMesh::extrudeObjectFromPolygon(DrImage *image, int poly_number, int quality, float depth_multiplier) {
+void DrMesh::extrudeObjectFromPolygon(DrImage *image, int poly_number, int quality, float depth_multiplier, Side_Profile profile, float profile_size) {
+    DR_TIME_SCOPE("extrudeObjectFromPolygon");
     int w = image->getBitmap().width;
     int h = image->getBitmap().height;
     if (w < 1 || h < 1) return;
+    Dr::BudgetStage(Budget_Stage::Triangulating);
 
     // ***** Triangulate Concave Hull
     std::vector<DrPointF>              &points =    image->m_poly_list[poly_number];
@@ -44,11 +59,16 @@ void DrMesh::extrudeObjectFromPolygon(DrImage *image, int poly_number, int quali
     
     // !!!!! #TODO: For greatly improved Trianglulation::Delaunay, break polygon into convex polygons before running algorithm
 
-    // ***** Add extruded triangles from Hull and Holes
-    int slices = (quality / 3) + 1;
-    extrudeFacePolygon(points, w, h, slices, false, depth_multiplier);
-    for (auto &hole : hole_list) {
-        extrudeFacePolygon(hole, w, h, slices, false, depth_multiplier);
+    // ***** Add extruded triangles from Hull and Holes, walls are only sliced when profile isn't flat
+    std::vector<float> depths, offsets;
+    float tolerance = c_profile_tolerance / static_cast<float>(Dr::Max(quality, 1));
+    profileSlices(profile, profile_size, c_extrude_depth * depth_multiplier, tolerance, depths, offsets);
+    {
+        DR_TIME_SCOPE("extrudeFacePolygon");
+        extrudeFacePolygon(points, w, h, depths, offsets, false);
+        for (auto &hole : hole_list) {
+            extrudeFacePolygon(hole, w, h, depths, offsets, false);
+        }
     }
     
     // Optimize and smooth mesh
@@ -59,27 +79,67 @@ void DrMesh::extrudeObjectFromPolygon(DrImage *image, int poly_number, int quali
 }
 
 
+//####################################################################################
+//##    Puts one mesh per object back in object order after DrImage::updateRegion(), 'previous_objects' is what it
+//##    returned. Meshes of kept objects are moved (not rebuilt), returns objects that need a new mesh (left empty).
+//####################################################################################
+std::vector<int> DrMesh::reuseObjectMeshes(const std::vector<int> &previous_objects, std::vector<DrMesh> &meshes) {
+    std::vector<DrMesh> reordered(previous_objects.size());
+    std::vector<int>    rebuild;
+    for (int object = 0; object < static_cast<int>(previous_objects.size()); ++object) {
+        int previous = previous_objects[object];
+        if (previous >= 0 && previous < static_cast<int>(meshes.size())) {
+            reordered[object] = std::move(meshes[previous]);
+        } else {
+            rebuild.push_back(object);
+        }
+    }
+    meshes.swap(reordered);
+    return rebuild;
+}
+
+
 //####################################################################################
 //##    Optimize Mesh
+//##        Works on unindexed triangles (as built by add()) or an already indexed mesh
+//##        When strip_type is not Strip_Type::None, triangles are ordered for strips and a triangle strip
+//##        version of the index buffer is stored in strip_indices (indices still hold the triangle list)
 //####################################################################################
-void DrMesh::optimizeMesh() {
-    // Remap Table
+void DrMesh::optimizeMesh(Strip_Type strip_type) {
+    DR_TIME_SCOPE("optimizeMesh");
+    // Remap Table, mesh can be unindexed (straight list of triangles) or already indexed
     DrMesh result;
-    size_t total_indices = vertexCount();
-    std::vector<unsigned int> remap(total_indices);        
-    size_t total_vertices = meshopt_generateVertexRemap(&remap[0], NULL, total_indices, &vertices[0], total_indices, sizeof(Vertex));
+    size_t total_indices = (indices.size() > 0) ? indices.size() : vertices.size();
+    const unsigned int *source_indices = (indices.size() > 0) ? &indices[0] : NULL;
+    std::vector<unsigned int> remap(vertices.size());        
+    size_t total_vertices = meshopt_generateVertexRemap(&remap[0], source_indices, total_indices, &vertices[0], vertices.size(), sizeof(Vertex));
+    DR_COUNT(Vertices_Before_Remap, vertices.size());
+    DR_COUNT(Vertices_After_Remap,  total_vertices);
+    DR_COUNT(Bytes_Allocated, remap.size() * sizeof(unsigned int) + total_indices * sizeof(unsigned int) + total_vertices * sizeof(Vertex));
 	    
     // 1. Indexing
     result.indices.resize(total_indices);
-	meshopt_remapIndexBuffer(&result.indices[0], NULL, total_indices, &remap[0]);
+	meshopt_remapIndexBuffer(&result.indices[0], source_indices, total_indices, &remap[0]);
 	result.vertices.resize(total_vertices);
-	meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], total_indices, sizeof(Vertex), &remap[0]);
-    // 2. Vertex cache optimization
-    meshopt_optimizeVertexCache(&result.indices[0], &result.indices[0], result.indices.size(), result.vertices.size());
-    // 3. Overdraw optimization
-    meshopt_optimizeOverdraw(&result.indices[0], &result.indices[0], result.indices.size(), &result.vertices[0].px, result.vertices.size(), sizeof(Vertex), 1.05f);
+	meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], vertices.size(), sizeof(Vertex), &remap[0]);
+    // 2. Vertex cache optimization, 3. Overdraw optimization (skipped for strips, it breaks up strip friendly order)
+    if (strip_type == Strip_Type::None) {
+        meshopt_optimizeVertexCache(&result.indices[0], &result.indices[0], result.indices.size(), result.vertices.size());
+        meshopt_optimizeOverdraw(&result.indices[0], &result.indices[0], result.indices.size(), &result.vertices[0].px, result.vertices.size(), sizeof(Vertex), 1.05f);
+    } else {
+        meshopt_optimizeVertexCacheStrip(&result.indices[0], &result.indices[0], result.indices.size(), result.vertices.size());
+    }
     // 4. Vertex fetch optimization
     meshopt_optimizeVertexFetch(&result.vertices[0], &result.indices[0], result.indices.size(), &result.vertices[0], result.vertices.size(), sizeof(Vertex));
+    // 5. Stripify, meshlets built before index into old vertex order
+    strip_indices.clear();
+    clearMeshlets();
+    if (strip_type != Strip_Type::None) {
+        unsigned int restart_index = (strip_type == Strip_Type::Primitive_Restart) ? c_strip_restart_index : 0;
+        strip_indices.resize(meshopt_stripifyBound(result.indices.size()));
+        size_t strip_size = meshopt_stripify(&strip_indices[0], &result.indices[0], result.indices.size(), result.vertices.size(), restart_index);
+        strip_indices.resize(strip_size);
+    }
 
     // Set indices and vertices from optimized mesh
     indices.resize(result.indices.size());
@@ -89,127 +149,6 @@ void DrMesh::optimizeMesh() {
 }
 
 
-//####################################################################################
-//##    Smooth Mesh
-//####################################################################################
-void DrMesh::smoothMesh() {
-    std::vector<int> counts;
-    counts.resize(11);
-
-    // Keep list of vertices processed
-    std::vector<bool> processed;
-    for(size_t i = 0; i < vertexCount(); i++) {
-        processed.push_back(false);
-    }
-
-    // Keep list of vertices smoothed
-    std::vector<Vertex> smoothed;
-    smoothed.resize(vertexCount());
-
-    // Loop through all points, find neighbors, then average the points
-    for(size_t one_vertex = 0; one_vertex < vertexCount(); one_vertex++) {
-        if (processed[one_vertex]) continue;
-
-        // Find list of points that are identical
-        std::list<unsigned int> same_points;
-        same_points.push_back(one_vertex);
-        processed[one_vertex] = true;
-        for(size_t j = 0; j < vertexCount(); j++) {
-            if (one_vertex == j) continue;
-            if (Dr::IsCloseTo(vertices[one_vertex].px, vertices[j].px, 0.5f) &&
-                Dr::IsCloseTo(vertices[one_vertex].py, vertices[j].py, 0.5f) &&
-                Dr::IsCloseTo(vertices[one_vertex].pz, vertices[j].pz, 0.5f)) {
-                    same_points.push_back(j);
-                    processed[j] = true;
-            }
-        }
-        same_points.unique();
-
-        // ***** Get list of neighbors
-        std::list<unsigned int> neighbors;
-        for(auto point : same_points) {
-            for(size_t j = 0; j < indexCount(); j += 3) {
-                if        (indices[j+0] == point) {
-                    neighbors.push_back(indices[j+1]);   
-                    neighbors.push_back(indices[j+2]);
-                } else if (indices[j+1] == point) {
-                    neighbors.push_back(indices[j+0]);   
-                    neighbors.push_back(indices[j+2]);
-                } else if (indices[j+2] == point) {
-                    neighbors.push_back(indices[j+0]);   
-                    neighbors.push_back(indices[j+1]);
-                }
-            }
-        }
-        neighbors.unique();
-
-        // ***** Average with neighbors
-        float weight = 1.0;
-        Vertex v = vertices[one_vertex];
-        Vertex o = vertices[one_vertex];
-        v.px *= weight;
-        v.py *= weight;           
-        v.pz *= weight;
-        v.nx *= weight;
-        v.ny *= weight;
-        v.nz *= weight;
-        v.tx *= weight;
-        v.ty *= weight;
-        for(auto n : neighbors) {
-            // Add neighbor diminished by distance
-            float edge_length = DrVec3(o.px, o.py, o.pz).distance({vertices[n].px, vertices[n].py, vertices[n].pz});
-            if (edge_length ==0) edge_length = std::numeric_limits<float>::epsilon();
-            float d = 1.f / edge_length;
-            v.px += (vertices[n].px * d);
-            v.py += (vertices[n].py * d);
-            v.pz += (vertices[n].pz * d);
-            v.nx += (vertices[n].nx * d);
-            v.ny += (vertices[n].ny * d);
-            v.nz += (vertices[n].nz * d);
-            v.tx += (vertices[n].tx * d);
-            v.ty += (vertices[n].ty * d);
-            weight += d;
-        }
-        v.px /= weight;
-        v.py /= weight;
-        v.pz /= weight;
-        v.nx /= weight;
-        v.ny /= weight;
-        v.nz /= weight;
-        v.tx = Dr::Clamp(v.tx/weight, 0.f, 1.f);
-        v.ty = Dr::Clamp(v.ty/weight, 0.f, 1.f);
-
-        DrVec3 normal = DrVec3(v.nx, v.ny, v.nz).normalized();
-        v.nx = normal.x;
-        v.ny = normal.y;
-        v.nz = normal.z;
-                
-        // Set all same points to new averaged point
-        for(auto point : same_points) {
-            DrMesh::set(v, smoothed[point]);            
-        }
-    }
-
-    // ***** Set smoothed vertices
-    for (size_t i = 0; i < vertices.size(); i++) {
-        DrMesh::set(smoothed[i], vertices[i]);
-    }
-
-    // ***** Reset barycentric coordinates
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        vertices[indices[i+0]].bx = 1;
-        vertices[indices[i+0]].by = 0;
-        vertices[indices[i+0]].bz = 0;
-        vertices[indices[i+1]].bx = 0;
-        vertices[indices[i+1]].by = 1;
-        vertices[indices[i+1]].bz = 0;
-        vertices[indices[i+2]].bx = 0;
-        vertices[indices[i+2]].by = 0;
-        vertices[indices[i+2]].bz = 1;
-    }
-}
-
-
 //####################################################################################
 //##    Smooth / Curve a collection of points representing a 2D outline
 //####################################################################################
@@ -342,6 +281,8 @@ std::vector<DrPointF> DrMesh::insertPoints(const std::vector<DrPointF> &outline_
 
 //####################################################################################
 //##    Triangulate Face and add Triangles to Vertex Data
+//##        If active budget (see DrBudget) has run out, or runs out during hole removal / triangulation, face falls
+//##        back to monotone triangulation (O(n log n), takes holes as they are)
 //####################################################################################
 // Finds average number of pixels in a small grid that are transparent
 DrColor getRoundedPixel(const DrBitmap &bitmap, const DrPointF &at_point) {
@@ -371,6 +312,7 @@ double averageTransparentPixels(const DrBitmap &bitmap, const DrPointF &at_point
 
 void DrMesh::triangulateFace(const std::vector<DrPointF> &outline_points, const std::vector<std::vector<DrPointF>> &hole_list,
                              const DrBitmap &image, Trianglulation type, double alpha_tolerance, float depth_multiplier) {
+    DR_TIME_SCOPE("triangulateFace");
     int width =  image.width;
     int height = image.height;
     double w2d = width  / 2.0;
@@ -411,18 +353,41 @@ void DrMesh::triangulateFace(const std::vector<DrPointF> &outline_points, const
     
     TPPLPartition pp;
     std::list<TPPLPoly> outpolys;
+    bool fallback = Dr::BudgetExpired();
 
-    if (hole_count > 0) {
-        pp.RemoveHoles(&testpolys, &outpolys);
-    } else {
-        outpolys = testpolys;
+    if (fallback == false) {
+        if (hole_count > 0) {
+            if (pp.RemoveHoles(&testpolys, &outpolys) == 0) fallback = Dr::BudgetExpired();
+        } else {
+            outpolys = testpolys;
+        }
     }
 
     // ***** Run triangulation
+    if (fallback == false) {
+        int done = 0;
+        switch (type) {
+            case Trianglulation::Ear_Clipping:      done = pp.Triangulate_EC(&outpolys, &result);           break;
+            case Trianglulation::Triangulate_Opt:
+                if (outpolys.size() > 0)            done = pp.Triangulate_OPT(&(*outpolys.begin()), &result);
+                break;
+            case Trianglulation::Monotone:          done = pp.Triangulate_MONO(&outpolys, &result);         break; 
+        }
+        if (done == 0) fallback = Dr::BudgetExpired();
+    }
+    if (fallback) {
+        result.clear();
+        pp.Triangulate_MONO(&testpolys, &result);
+        type = Trianglulation::Monotone;
+    }
     switch (type) {
-        case Trianglulation::Ear_Clipping:      pp.Triangulate_EC(&outpolys, &result);                  break;
-        case Trianglulation::Triangulate_Opt:   pp.Triangulate_OPT(&(*outpolys.begin()), &result);      break;
-        case Trianglulation::Monotone:          pp.Triangulate_MONO(&outpolys, &result);                break; 
+        case Trianglulation::Ear_Clipping:      DR_COUNT(Triangles_Ear_Clipping,    result.size());     break;
+        case Trianglulation::Triangulate_Opt:   DR_COUNT(Triangles_Triangulate_Opt, result.size());     break;
+        case Trianglulation::Monotone:          DR_COUNT(Triangles_Monotone,        result.size());     break;
+    }
+    if (DrBudget *budget = Dr::ActiveBudget()) {
+        if (fallback) budget->faces_fallback++;
+        else          budget->faces_triangulated++;
     }
 
     // ***** Add triangulated convex hull to vertex data
@@ -448,46 +413,253 @@ void DrMesh::triangulateFace(const std::vector<DrPointF> &outline_points, const
     
 }
 
+//####################################################################################
+//##    Side Profile, fills slice boundaries of side walls from front (+depth) to back (-depth)
+//##        Number of slices follows profile curvature:
+//##            Flat        1 slice, planar walls gain nothing from slicing
+//##            Bevel       3 slices, one per chamfer and one for the flat middle
+//##            Round       Enough slices to keep chord error of elliptical arc under tolerance
+//##        Slices are the same for every edge of a contour, so neighboring walls share vertices (no t-junctions)
+//####################################################################################
+void DrMesh::profileSlices(Side_Profile profile, float profile_size, float depth, float tolerance,
+                           std::vector<float> &depths, std::vector<float> &offsets) {
+    depths.clear();
+    offsets.clear();
+    if (profile_size <= 0.f || depth <= 0.f) profile = Side_Profile::Flat;
+
+    switch (profile) {
+        case Side_Profile::Flat:
+            depths  = { +depth, -depth };
+            offsets = { 0.f, 0.f };
+            break;
+
+        case Side_Profile::Bevel: {
+            float chamfer = (depth * 2.f) * c_bevel_fraction;
+            depths  = { +depth, +depth - chamfer, -depth + chamfer, -depth };
+            offsets = { 0.f, profile_size, profile_size, 0.f };
+            break;
+        }
+
+        case Side_Profile::Round: {
+            // Largest radius of curvature of ellipse with semi axes 'depth' and 'profile_size'
+            float radius = Dr::Max((depth * depth) / profile_size, (profile_size * profile_size) / depth);
+            int   slices = c_max_profile_slices;
+            if (tolerance < radius) {
+                double max_angle = 2.0 * std::acos(1.0 - static_cast<double>(tolerance / radius));
+                slices = static_cast<int>(std::ceil(DR_PI / max_angle));
+            }
+            slices = Dr::Clamp(slices, 2, c_max_profile_slices);
+            for (int i = 0; i <= slices; i++) {
+                double angle = DR_PI * static_cast<double>(i) / static_cast<double>(slices);
+                depths.push_back(  static_cast<float>(depth * std::cos(angle)));
+                offsets.push_back( static_cast<float>(profile_size * std::sin(angle)));
+            }
+            break;
+        }
+    }
+}
+
+//####################################################################################
+//##    Side Wall Kernel
+//##        Works on a contour stored as SoA arrays, 4 edges at a time with SSE2 (scalar loop for other targets / tail).
+//##        Edge e runs from point (first + e) to point (second + e) of the arrays, arrays have count + 1 entries
+//##        (first point repeated at end) so no wrapping is needed.
+//####################################################################################
+struct WallContour {
+    const float *x1, *y1, *tx1, *ty1, *ox1, *oy1;           // First point of each edge, position / uv / outward direction
+    const float *x2, *y2, *tx2, *ty2, *ox2, *oy2;           // Second point of each edge
+};
+
+// Positions and normals of one slice of up to 4 edges
+struct WallBlock {
+    float f1x[4], f1y[4], b1x[4], b1y[4];                   // Front / back of first point
+    float f2x[4], f2y[4], b2x[4], b2y[4];                   // Front / back of second point
+    float n1x[4], n1y[4], n1z[4];                           // Normal of triangle f1, b1, f2
+    float n2x[4], n2y[4], n2z[4];                           // Normal of triangle f2, b1, b2
+};
+
+// Normal of a wall slice triangle, same as DrVec3::triangleNormal(), zero for degenerate edges
+static inline void wallNormal(float ux, float uy, float uz, float wx, float wy, float wz, float &nx, float &ny, float &nz) {
+    nx = uy*wz - uz*wy;
+    ny = uz*wx - ux*wz;
+    nz = ux*wy - uy*wx;
+    float length = std::sqrt(nx*nx + ny*ny + nz*nz);
+    float scale = (length > 0.f) ? (1.f / length) : 0.f;
+    nx *= scale;    ny *= scale;    nz *= scale;
+}
+
+static void computeWallLanes(const WallContour &c, int e, int lanes, float z0, float z1, float o0, float o1, WallBlock &w) {
+    for (int l = 0; l < lanes; l++) {
+        int i = e + l;
+        w.f1x[l] = c.x1[i] + (c.ox1[i] * o0);       w.f1y[l] = c.y1[i] + (c.oy1[i] * o0);
+        w.b1x[l] = c.x1[i] + (c.ox1[i] * o1);       w.b1y[l] = c.y1[i] + (c.oy1[i] * o1);
+        w.f2x[l] = c.x2[i] + (c.ox2[i] * o0);       w.f2y[l] = c.y2[i] + (c.oy2[i] * o0);
+        w.b2x[l] = c.x2[i] + (c.ox2[i] * o1);       w.b2y[l] = c.y2[i] + (c.oy2[i] * o1);
+        wallNormal(w.f1x[l] - w.f2x[l], w.f1y[l] - w.f2y[l], 0.f,
+                   w.f2x[l] - w.b1x[l], w.f2y[l] - w.b1y[l], z0 - z1, w.n1x[l], w.n1y[l], w.n1z[l]);
+        wallNormal(w.f2x[l] - w.b2x[l], w.f2y[l] - w.b2y[l], z0 - z1,
+                   w.b2x[l] - w.b1x[l], w.b2y[l] - w.b1y[l], 0.f,     w.n2x[l], w.n2y[l], w.n2z[l]);
+    }
+}
+
+#if defined(DR_USE_SSE2)
+static inline void wallNormal4(__m128 ux, __m128 uy, __m128 uz, __m128 wx, __m128 wy, __m128 wz, float *nx, float *ny, float *nz) {
+    __m128 x = _mm_sub_ps(_mm_mul_ps(uy, wz), _mm_mul_ps(uz, wy));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(uz, wx), _mm_mul_ps(ux, wz));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(ux, wy), _mm_mul_ps(uy, wx));
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+    __m128 scale =  _mm_and_ps(_mm_cmpgt_ps(length, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.f), length));
+    _mm_storeu_ps(nx, _mm_mul_ps(x, scale));
+    _mm_storeu_ps(ny, _mm_mul_ps(y, scale));
+    _mm_storeu_ps(nz, _mm_mul_ps(z, scale));
+}
+
+static void computeWallBlock4(const WallContour &c, int e, float z0, float z1, float o0, float o1, WallBlock &w) {
+    __m128 off0 = _mm_set1_ps(o0), off1 = _mm_set1_ps(o1);
+    __m128 x1 =  _mm_loadu_ps(c.x1  + e),   y1 =  _mm_loadu_ps(c.y1  + e);
+    __m128 ox1 = _mm_loadu_ps(c.ox1 + e),   oy1 = _mm_loadu_ps(c.oy1 + e);
+    __m128 x2 =  _mm_loadu_ps(c.x2  + e),   y2 =  _mm_loadu_ps(c.y2  + e);
+    __m128 ox2 = _mm_loadu_ps(c.ox2 + e),   oy2 = _mm_loadu_ps(c.oy2 + e);
+
+    __m128 f1x = _mm_add_ps(x1, _mm_mul_ps(ox1, off0)),     f1y = _mm_add_ps(y1, _mm_mul_ps(oy1, off0));
+    __m128 b1x = _mm_add_ps(x1, _mm_mul_ps(ox1, off1)),     b1y = _mm_add_ps(y1, _mm_mul_ps(oy1, off1));
+    __m128 f2x = _mm_add_ps(x2, _mm_mul_ps(ox2, off0)),     f2y = _mm_add_ps(y2, _mm_mul_ps(oy2, off0));
+    __m128 b2x = _mm_add_ps(x2, _mm_mul_ps(ox2, off1)),     b2y = _mm_add_ps(y2, _mm_mul_ps(oy2, off1));
+    _mm_storeu_ps(w.f1x, f1x);      _mm_storeu_ps(w.f1y, f1y);
+    _mm_storeu_ps(w.b1x, b1x);      _mm_storeu_ps(w.b1y, b1y);
+    _mm_storeu_ps(w.f2x, f2x);      _mm_storeu_ps(w.f2y, f2y);
+    _mm_storeu_ps(w.b2x, b2x);      _mm_storeu_ps(w.b2y, b2y);
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 dz =   _mm_set1_ps(z0 - z1);
+    wallNormal4(_mm_sub_ps(f1x, f2x), _mm_sub_ps(f1y, f2y), zero,
+                _mm_sub_ps(f2x, b1x), _mm_sub_ps(f2y, b1y), dz,   w.n1x, w.n1y, w.n1z);
+    wallNormal4(_mm_sub_ps(f2x, b2x), _mm_sub_ps(f2y, b2y), dz,
+                _mm_sub_ps(b2x, b1x), _mm_sub_ps(b2y, b1y), zero, w.n2x, w.n2y, w.n2z);
+}
+#endif
+
+static inline void writeWallVertex(Vertex &v, float px, float py, float pz, float nx, float ny, float nz, float tx, float ty, Triangle_Point point) {
+    v.px = px;  v.py = py;  v.pz = pz;
+    v.nx = nx;  v.ny = ny;  v.nz = nz;
+    v.tx = tx;  v.ty = ty;
+    v.bx = (point == Triangle_Point::Point1) ? 1.f : 0.f;
+    v.by = (point == Triangle_Point::Point2) ? 1.f : 0.f;
+    v.bz = (point == Triangle_Point::Point3) ? 1.f : 0.f;
+}
+
 //####################################################################################
 //##    Add Extrusion Triangles to Vertex Data
+//##        Converts contour to SoA arrays (applying the half pixel inward nudge), then streams side walls straight into
+//##        pre-sized vertex array, 6 vertices per edge per slice. Profile offsets push each outline point outward along
+//##        average of its two edge normals.
 //####################################################################################
-void DrMesh::extrudeFacePolygon(const std::vector<DrPointF> &outline_points, int width, int height, int steps, bool reverse, float depth_multiplier) {
-    double w2d = width  / 2.0;
-    double h2d = height / 2.0;
+void DrMesh::extrudeFacePolygon(const std::vector<DrPointF> &outline_points, int width, int height,
+                                const std::vector<float> &depths, const std::vector<float> &offsets, bool reverse) {
+    int count =  static_cast<int>(outline_points.size());
+    int slices = static_cast<int>(depths.size()) - 1;
+    if (count < 2 || slices < 1) return;
+
+    // ***** Contour as SoA, one extra entry repeats first point
+    std::vector<float> xs(count + 1), ys(count + 1), txs(count + 1), tys(count + 1);
+    for (int i = 0; i < count; i++) {
+        xs[i] =  static_cast<float>(         outline_points[i].x);
+        ys[i] =  static_cast<float>(height - outline_points[i].y);
+        txs[i] = static_cast<float>(         outline_points[i].x / width);
+        tys[i] = static_cast<float>(         outline_points[i].y / height);
+    }
 
-    for (int i = 0; i < static_cast<int>(outline_points.size()); i++) {
-        int point1 = i + 1;
-        int point2 = i;
-        if (point1 >= static_cast<int>(outline_points.size())) point1 = 0;
-
-        float  x1 = static_cast<float>(         outline_points[point1].x);
-        float  y1 = static_cast<float>(height - outline_points[point1].y);
-        float tx1 = static_cast<float>(         outline_points[point1].x / width);
-        float ty1 = static_cast<float>(         outline_points[point1].y / height);
-
-        float  x2 = static_cast<float>(         outline_points[point2].x);
-        float  y2 = static_cast<float>(height - outline_points[point2].y);
-        float tx2 = static_cast<float>(         outline_points[point2].x / width);
-        float ty2 = static_cast<float>(         outline_points[point2].y / height);
-
-        x1 -= static_cast<float>(w2d);
-        x2 -= static_cast<float>(w2d);
-        y1 -= static_cast<float>(h2d);
-        y2 -= static_cast<float>(h2d);
-
-        float pixel_w = (1.0f / width);
-        float pixel_h = (1.0f / height);
-        if (tx1 > 0.5f) x1 -= pixel_w; else x1 += pixel_w;
-        if (tx2 > 0.5f) x2 -= pixel_w; else x2 += pixel_w;
-        if (ty1 > 0.5f) y1 -= pixel_h; else y1 += pixel_h;
-        if (ty2 > 0.5f) y2 -= pixel_h; else y2 += pixel_h;
-
-        if (reverse == false) {
-            extrude(x1, y1, tx1, ty1,
-                    x2, y2, tx2, ty2, steps, depth_multiplier);
-        } else {
-            extrude(x2, y2, tx2, ty2,
-                    x1, y1, tx1, ty1, steps, depth_multiplier);
+    // Center on origin, nudge half a texel inward
+    float w2d = static_cast<float>(width  / 2.0);
+    float h2d = static_cast<float>(height / 2.0);
+    float pixel_w = (1.0f / width);
+    float pixel_h = (1.0f / height);
+    int   i = 0;
+#if defined(DR_USE_SSE2)
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 w2 = _mm_set1_ps(w2d),       h2 = _mm_set1_ps(h2d);
+    __m128 pw = _mm_set1_ps(pixel_w),   ph = _mm_set1_ps(pixel_h);
+    for (; i + 4 <= count; i += 4) {
+        __m128 right = _mm_cmpgt_ps(_mm_loadu_ps(&txs[i]), half);
+        __m128 up =    _mm_cmpgt_ps(_mm_loadu_ps(&tys[i]), half);
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(&xs[i]), w2);
+        __m128 y = _mm_sub_ps(_mm_loadu_ps(&ys[i]), h2);
+        x = _mm_add_ps(x, _mm_sub_ps(_mm_andnot_ps(right, pw), _mm_and_ps(right, pw)));
+        y = _mm_add_ps(y, _mm_sub_ps(_mm_andnot_ps(up,    ph), _mm_and_ps(up,    ph)));
+        _mm_storeu_ps(&xs[i], x);
+        _mm_storeu_ps(&ys[i], y);
+    }
+#endif
+    for (; i < count; i++) {
+        xs[i] -= w2d;
+        ys[i] -= h2d;
+        if (txs[i] > 0.5f) xs[i] -= pixel_w; else xs[i] += pixel_w;
+        if (tys[i] > 0.5f) ys[i] -= pixel_h; else ys[i] += pixel_h;
+    }
+    xs[count] = xs[0];      ys[count] = ys[0];      txs[count] = txs[0];    tys[count] = tys[0];
+
+    // ***** Outward direction of each point, edge from point i + 1 to point i faces (-dy, dx)
+    std::vector<float> oxs(count + 1, 0.f), oys(count + 1, 0.f);
+    bool profiled = false;
+    for (auto offset : offsets) { if (offset != 0.f) profiled = true; }
+    if (profiled) {
+        float flip = (reverse) ? -1.f : 1.f;
+        for (int p = 0; p < count; p++) {
+            float dx = xs[p] - xs[p + 1];
+            float dy = ys[p] - ys[p + 1];
+            float length = std::sqrt(dx*dx + dy*dy);
+            if (length <= 0.f) continue;
+            float nx = flip * -dy / length;
+            float ny = flip *  dx / length;
+            oxs[p] +=     nx;     oys[p] +=     ny;
+            oxs[p + 1] += nx;     oys[p + 1] += ny;
+        }
+        oxs[0] += oxs[count];   oys[0] += oys[count];
+        for (int p = 0; p < count; p++) {
+            float length = std::sqrt(oxs[p]*oxs[p] + oys[p]*oys[p]);
+            if (length > 0.f) { oxs[p] /= length; oys[p] /= length; }
+        }
+        oxs[count] = oxs[0];    oys[count] = oys[0];
+    }
+
+    // ***** Edge e runs from point e + 1 to point e, or reversed
+    int first =  (reverse) ? 0 : 1;
+    int second = (reverse) ? 1 : 0;
+    WallContour contour;
+    contour.x1 = &xs[first];     contour.y1 = &ys[first];     contour.tx1 = &txs[first];     contour.ty1 = &tys[first];
+    contour.ox1 = &oxs[first];   contour.oy1 = &oys[first];
+    contour.x2 = &xs[second];    contour.y2 = &ys[second];    contour.tx2 = &txs[second];    contour.ty2 = &tys[second];
+    contour.ox2 = &oxs[second];  contour.oy2 = &oys[second];
+
+    // ***** Stream walls into vertex array
+    size_t start = vertices.size();
+    vertices.resize(start + (static_cast<size_t>(count) * static_cast<size_t>(slices) * 6));
+    Vertex *out = &vertices[start];
+
+    WallBlock block;
+    for (int e = 0; e < count; e += 4) {
+        int lanes = Dr::Min(4, count - e);
+        for (int s = 0; s < slices; s++) {
+            float z0 = depths[s],  z1 = depths[s + 1];
+            float o0 = offsets[s], o1 = offsets[s + 1];
+        #if defined(DR_USE_SSE2)
+            if (lanes == 4) computeWallBlock4(contour, e, z0, z1, o0, o1, block);
+            else            computeWallLanes( contour, e, lanes, z0, z1, o0, o1, block);
+        #else
+            computeWallLanes(contour, e, lanes, z0, z1, o0, o1, block);
+        #endif
+            for (int l = 0; l < lanes; l++) {
+                int    edge = e + l;
+                float  tx1 = contour.tx1[edge], ty1 = contour.ty1[edge];
+                float  tx2 = contour.tx2[edge], ty2 = contour.ty2[edge];
+                Vertex *v = out + ((static_cast<size_t>(edge) * slices + s) * 6);
+                writeWallVertex(v[0], block.f1x[l], block.f1y[l], z0, block.n1x[l], block.n1y[l], block.n1z[l], tx1, ty1, Triangle_Point::Point1);
+                writeWallVertex(v[1], block.b1x[l], block.b1y[l], z1, block.n1x[l], block.n1y[l], block.n1z[l], tx1, ty1, Triangle_Point::Point2);
+                writeWallVertex(v[2], block.f2x[l], block.f2y[l], z0, block.n1x[l], block.n1y[l], block.n1z[l], tx2, ty2, Triangle_Point::Point3);
+                writeWallVertex(v[3], block.f2x[l], block.f2y[l], z0, block.n2x[l], block.n2y[l], block.n2z[l], tx2, ty2, Triangle_Point::Point1);
+                writeWallVertex(v[4], block.b1x[l], block.b1y[l], z1, block.n2x[l], block.n2y[l], block.n2z[l], tx1, ty1, Triangle_Point::Point2);
+                writeWallVertex(v[5], block.b2x[l], block.b2y[l], z1, block.n2x[l], block.n2y[l], block.n2z[l], tx2, ty2, Triangle_Point::Point3);
+            }
         }
     }
 }
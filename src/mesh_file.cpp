@@ -0,0 +1,231 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Reading / writing of compressed mesh files (.extm)
+//
+//  Layout (native byte order, structs and vertices are stored as in memory. A file from a host of the other byte
+//  order fails the version check):
+//      Header          magic "EXTM", version, object count, vertex size
+//      Object Table    one entry per mesh: vertex / index counts, byte ranges of encoded streams, bounds
+//      Data            meshopt encoded vertex and index streams, each aligned to 4 bytes
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "3rd_party/mesh_optimizer/meshoptimizer.h"
+#include "mesh.h"
+
+// Local Constants
+const char      c_mesh_file_magic[4] =  { 'E', 'X', 'T', 'M' };
+const uint32_t  c_mesh_file_version =   1;
+const uint64_t  c_vertex_codec_ratio =  64;         // Vertex codec stores at most 64 bytes of vertices per encoded byte (2 header bits per 16 bytes)
+
+// File Structures
+struct MeshFileHeader {
+    char        magic[4];
+    uint32_t    version;
+    uint32_t    object_count;
+    uint32_t    vertex_size;
+};
+
+struct MeshFileObject {
+    uint32_t    vertex_count;
+    uint32_t    index_count;
+    uint64_t    vertex_offset;                                      // Byte offset of encoded vertex stream from start of file
+    uint64_t    vertex_bytes;
+    uint64_t    index_offset;                                       // Byte offset of encoded index stream from start of file
+    uint64_t    index_bytes;
+    float       bounds_min[3];
+    float       bounds_max[3];
+};
+
+// Rounds byte count up to next multiple of 4
+static size_t alignFour(size_t bytes) { return (bytes + 3) & ~static_cast<size_t>(3); }
+
+
+//####################################################################################
+//##    Encodes meshes into file format, data can be written to disk as is
+//####################################################################################
+void DrMesh::encodeMeshes(const std::vector<DrMesh> &meshes, std::vector<unsigned char> &file_data) {
+    // ***** Header and object table
+    MeshFileHeader header;
+    memcpy(header.magic, c_mesh_file_magic, sizeof(header.magic));
+    header.version =        c_mesh_file_version;
+    header.object_count =   static_cast<uint32_t>(meshes.size());
+    header.vertex_size =    static_cast<uint32_t>(sizeof(Vertex));
+
+    std::vector<MeshFileObject> objects(meshes.size());
+    size_t data_start = sizeof(MeshFileHeader) + (sizeof(MeshFileObject) * objects.size());
+
+    // ***** Reserve worst case size, encode streams directly into file data
+    size_t worst_case = data_start;
+    for (const auto &mesh : meshes) {
+        worst_case += alignFour(meshopt_encodeVertexBufferBound(mesh.vertices.size(), sizeof(Vertex)));
+        worst_case += alignFour(meshopt_encodeIndexBufferBound(mesh.indices.size(), mesh.vertices.size()));
+    }
+    file_data.assign(worst_case, 0);
+
+    size_t offset = data_start;
+    for (size_t m = 0; m < meshes.size(); m++) {
+        const DrMesh   &mesh =   meshes[m];
+        MeshFileObject &object = objects[m];
+        DrMeshBounds    box =    mesh.bounds();
+        memcpy(object.bounds_min, box.min, sizeof(object.bounds_min));
+        memcpy(object.bounds_max, box.max, sizeof(object.bounds_max));
+        object.vertex_count =   static_cast<uint32_t>(mesh.vertices.size());
+        object.index_count =    static_cast<uint32_t>(mesh.indices.size());
+
+        // Vertex stream
+        object.vertex_offset =  offset;
+        object.vertex_bytes =   0;
+        if (mesh.vertices.size() > 0) {
+            object.vertex_bytes = meshopt_encodeVertexBuffer(&file_data[offset], file_data.size() - offset,
+                                                             &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+        }
+        offset += alignFour(object.vertex_bytes);
+
+        // Index stream
+        object.index_offset =   offset;
+        object.index_bytes =    0;
+        if (mesh.indices.size() > 0) {
+            object.index_bytes = meshopt_encodeIndexBuffer(&file_data[offset], file_data.size() - offset,
+                                                           &mesh.indices[0], mesh.indices.size());
+        }
+        offset += alignFour(object.index_bytes);
+    }
+    file_data.resize(offset);
+
+    memcpy(&file_data[0], &header, sizeof(MeshFileHeader));
+    if (objects.size() > 0) {
+        memcpy(&file_data[sizeof(MeshFileHeader)], &objects[0], sizeof(MeshFileObject) * objects.size());
+    }
+}
+
+
+//####################################################################################
+//##    Decodes meshes from file data, works on a buffer read in one pass or memory mapped file
+//##        Returns false if data is not a valid mesh file
+//##        !!!!! #NOTE: Index codec may rotate vertex order within a triangle, winding is preserved
+//####################################################################################
+bool DrMesh::decodeMeshes(const unsigned char *file_data, size_t file_size, std::vector<DrMesh> &meshes, std::vector<DrMeshBounds> *bounds) {
+    // ***** Verify header
+    if (file_data == nullptr || file_size < sizeof(MeshFileHeader)) return false;
+    MeshFileHeader header;
+    memcpy(&header, file_data, sizeof(MeshFileHeader));
+    if (memcmp(header.magic, c_mesh_file_magic, sizeof(header.magic)) != 0) return false;
+    if (header.version != c_mesh_file_version)                              return false;
+    if (header.vertex_size != sizeof(Vertex))                               return false;
+
+    size_t table_end = sizeof(MeshFileHeader) + (sizeof(MeshFileObject) * static_cast<size_t>(header.object_count));
+    if (table_end > file_size) return false;
+
+    // ***** Decode each object
+    size_t first_mesh = meshes.size();
+    meshes.resize(first_mesh + header.object_count);
+    if (bounds != nullptr) bounds->reserve(bounds->size() + header.object_count);
+
+    for (uint32_t m = 0; m < header.object_count; m++) {
+        MeshFileObject object;
+        memcpy(&object, file_data + sizeof(MeshFileHeader) + (sizeof(MeshFileObject) * m), sizeof(MeshFileObject));
+        if (object.vertex_offset > file_size || object.vertex_bytes > file_size - object.vertex_offset ||
+            object.index_offset  > file_size || object.index_bytes  > file_size - object.index_offset  ||
+            object.index_count % 3 != 0) {
+            meshes.resize(first_mesh);
+            return false;
+        }
+
+        // Counts have to fit in their streams before anything is allocated for them (same minimums decoders check)
+        if (static_cast<uint64_t>(object.vertex_count) * sizeof(Vertex) > object.vertex_bytes * c_vertex_codec_ratio ||
+            (object.index_count > 0 && static_cast<uint64_t>(object.index_count / 3) + 17 > object.index_bytes)) {
+            meshes.resize(first_mesh);
+            return false;
+        }
+
+        DrMesh &mesh = meshes[first_mesh + m];
+        mesh.vertices.resize(object.vertex_count);
+        mesh.indices.resize(object.index_count);
+        if (object.vertex_count > 0 &&
+            meshopt_decodeVertexBuffer(&mesh.vertices[0], object.vertex_count, sizeof(Vertex),
+                                       file_data + object.vertex_offset, object.vertex_bytes) != 0) {
+            meshes.resize(first_mesh);
+            return false;
+        }
+        if (object.index_count > 0 &&
+            meshopt_decodeIndexBuffer(&mesh.indices[0], object.index_count, sizeof(unsigned int),
+                                      file_data + object.index_offset, object.index_bytes) != 0) {
+            meshes.resize(first_mesh);
+            return false;
+        }
+
+        // Decoder is safe for corrupt data, but may produce out of range indices
+        for (size_t i = 0; i < mesh.indices.size(); i++) {
+            if (mesh.indices[i] >= object.vertex_count) { meshes.resize(first_mesh); return false; }
+        }
+
+        if (bounds != nullptr) {
+            DrMeshBounds box;
+            memcpy(box.min, object.bounds_min, sizeof(box.min));
+            memcpy(box.max, object.bounds_max, sizeof(box.max));
+            bounds->push_back(box);
+        }
+    }
+    return true;
+}
+
+
+//####################################################################################
+//##    Saving / Loading
+//####################################################################################
+bool DrMesh::saveMeshes(std::string filename, const std::vector<DrMesh> &meshes) {
+    std::vector<unsigned char> file_data;
+    encodeMeshes(meshes, file_data);
+
+    FILE *file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) return false;
+    size_t written = fwrite(&file_data[0], 1, file_data.size(), file);
+    bool   closed =  (fclose(file) == 0);
+    return (written == file_data.size() && closed);
+}
+
+// Reads entire file with one bulk read, then decodes from memory
+bool DrMesh::loadMeshes(std::string filename, std::vector<DrMesh> &meshes, std::vector<DrMeshBounds> *bounds) {
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) return false;
+
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_size <= 0) { fclose(file); return false; }
+
+    std::vector<unsigned char> file_data(static_cast<size_t>(file_size));
+    size_t read = fread(&file_data[0], 1, file_data.size(), file);
+    fclose(file);
+    if (read != file_data.size()) return false;
+
+    return decodeMeshes(&file_data[0], file_data.size(), meshes, bounds);
+}
+
+bool DrMesh::saveToFile(std::string filename) const {
+    std::vector<DrMesh> meshes { *this };
+    return saveMeshes(filename, meshes);
+}
+
+// Loads first mesh found in file
+bool DrMesh::loadFromFile(std::string filename) {
+    std::vector<DrMesh> meshes;
+    if (loadMeshes(filename, meshes) == false || meshes.size() < 1) return false;
+    indices.swap(meshes[0].indices);
+    vertices.swap(meshes[0].vertices);
+    strip_indices.clear();
+    clearMeshlets();
+    return true;
+}
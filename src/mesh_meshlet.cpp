@@ -0,0 +1,97 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <cmath>
+#include <vector>
+
+#include "3rd_party/mesh_optimizer/meshoptimizer.h"
+#include "mesh.h"
+#include "types/vec3.h"
+
+
+//####################################################################################
+//##    Drops meshlets, they index into vertices so they go stale once indices / vertices are rebuilt
+//####################################################################################
+void DrMesh::clearMeshlets() {
+    meshlets.clear();
+    meshlet_vertices.clear();
+    meshlet_triangles.clear();
+}
+
+
+//####################################################################################
+//##    Builds Meshlets
+//##        Splits index buffer into clusters of up to c_meshlet_max_vertices / c_meshlet_max_triangles,
+//##        each with a bounding sphere and normal cone. Index buffer and vertices are left untouched.
+//##
+//##        cone_weight     0.0 to 1.0, higher values trade cluster size for tighter normal cones (better backface culling)
+//####################################################################################
+void DrMesh::buildMeshlets(float cone_weight) {
+    clearMeshlets();
+    if (indices.size() < 3 || vertices.size() < 3) return;
+
+    // ***** Build clusters
+    size_t max_meshlets = meshopt_buildMeshletsBound(indices.size(), c_meshlet_max_vertices, c_meshlet_max_triangles);
+    std::vector<meshopt_Meshlet> clusters(max_meshlets);
+    meshlet_vertices.resize(max_meshlets * c_meshlet_max_vertices);
+    meshlet_triangles.resize(max_meshlets * c_meshlet_max_triangles * 3);
+
+    size_t meshlet_count = meshopt_buildMeshlets(&clusters[0], &meshlet_vertices[0], &meshlet_triangles[0], &indices[0], indices.size(),
+                                                 &vertices[0].px, vertices.size(), sizeof(Vertex),
+                                                 c_meshlet_max_vertices, c_meshlet_max_triangles, cone_weight);
+    if (meshlet_count == 0) {
+        meshlet_vertices.clear();
+        meshlet_triangles.clear();
+        return;
+    }
+
+    // ***** Trim to used size, triangle data of each meshlet is padded to 4 bytes
+    const meshopt_Meshlet &last = clusters[meshlet_count - 1];
+    meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
+    meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+
+    // ***** Culling bounds
+    meshlets.resize(meshlet_count);
+    for (size_t m = 0; m < meshlet_count; m++) {
+        const meshopt_Meshlet &cluster = clusters[m];
+        meshopt_Bounds bounds = meshopt_computeMeshletBounds(&meshlet_vertices[cluster.vertex_offset], &meshlet_triangles[cluster.triangle_offset],
+                                                             cluster.triangle_count, &vertices[0].px, vertices.size(), sizeof(Vertex));
+        DrMeshlet &meshlet = meshlets[m];
+        meshlet.vertex_offset =     cluster.vertex_offset;
+        meshlet.triangle_offset =   cluster.triangle_offset;
+        meshlet.vertex_count =      cluster.vertex_count;
+        meshlet.triangle_count =    cluster.triangle_count;
+        for (int i = 0; i < 3; i++) {
+            meshlet.center[i] =     bounds.center[i];
+            meshlet.cone_apex[i] =  bounds.cone_apex[i];
+            meshlet.cone_axis[i] =  bounds.cone_axis[i];
+        }
+        meshlet.radius =            bounds.radius;
+        meshlet.cone_cutoff =       bounds.cone_cutoff;
+    }
+}
+
+
+//####################################################################################
+//##    Appends triangles of meshlets that are not backfacing from camera_position (in mesh space) to 'visible'
+//##        Returns number of indices appended
+//####################################################################################
+size_t DrMesh::visibleIndices(const DrVec3 &camera_position, std::vector<unsigned int> &visible) const {
+    size_t start = visible.size();
+    for (const auto &meshlet : meshlets) {
+        DrVec3 apex(meshlet.cone_apex[0], meshlet.cone_apex[1], meshlet.cone_apex[2]);
+        DrVec3 axis(meshlet.cone_axis[0], meshlet.cone_axis[1], meshlet.cone_axis[2]);
+        if ((apex - camera_position).normalized().dot(axis) >= meshlet.cone_cutoff) continue;
+
+        for (unsigned int t = 0; t < meshlet.triangle_count * 3; t++) {
+            visible.push_back(meshlet_vertices[meshlet.vertex_offset + meshlet_triangles[meshlet.triangle_offset + t]]);
+        }
+    }
+    return visible.size() - start;
+}
@@ -0,0 +1,120 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <cmath>
+#include <vector>
+
+#include "compare.h"
+#include "mesh.h"
+#include "types/vec3.h"
+
+// Local Constants
+const float c_normal_weld_tolerance =   0.01f;      // Positions closer than this share normals, covers half texel nudge of side walls
+
+
+//####################################################################################
+//##    Generate Normals
+//##        Replaces flat triangle normals with angle weighted vertex normals. Corners around a vertex are split into
+//##        smoothing groups, a corner joins the first group whose seed face is within crease_angle (in degrees) of its
+//##        own face, so cap rims and sharp outline corners stay hard while curved walls become smooth.
+//##        Linear in the number of indices (groups per vertex are few), mesh is re-optimized afterwards so smooth
+//##        areas can share vertices.
+//####################################################################################
+void DrMesh::generateNormals(float crease_angle) {
+    size_t index_count = (indices.size() > 0) ? indices.size() : vertices.size();
+    if (index_count < 3) return;
+    index_count -= index_count % 3;
+    auto index = [this](size_t i) -> unsigned int { return (indices.size() > 0) ? indices[i] : static_cast<unsigned int>(i); };
+
+    // ***** Weld positions, so normals are shared across attribute seams
+    std::vector<unsigned int> remap;
+    size_t welded_count = weldPositions(vertices, c_normal_weld_tolerance, remap);
+
+    // ***** Face normals and corner angles
+    size_t triangle_count = index_count / 3;
+    std::vector<DrVec3> face_normals(triangle_count);
+    std::vector<float>  corner_angles(index_count, 0.f);
+    for (size_t t = 0; t < triangle_count; t++) {
+        DrVec3 p[3];
+        DrVec3 existing(0.f, 0.f, 0.f);
+        for (int k = 0; k < 3; k++) {
+            const Vertex &v = vertices[index(t*3 + k)];
+            p[k] = DrVec3(v.px, v.py, v.pz);
+            existing += DrVec3(v.nx, v.ny, v.nz);
+        }
+
+        // Keep facing of existing normals, extruded meshes store normals opposite of winding (pipeline culls front faces)
+        DrVec3 n = (p[1] - p[0]) % (p[2] - p[0]);
+        if (n.dot(existing) < 0.f) n = -n;
+        float length = std::sqrt(n.normSquared());
+        face_normals[t] = (length > 0.f) ? (n * (1.f / length)) : DrVec3(0.f, 0.f, 0.f);
+        if (length <= 0.f) continue;
+
+        for (int k = 0; k < 3; k++) {
+            DrVec3 a = p[(k + 1) % 3] - p[k];
+            DrVec3 b = p[(k + 2) % 3] - p[k];
+            float  lengths = std::sqrt(a.normSquared() * b.normSquared());
+            if (lengths > 0.f) corner_angles[t*3 + k] = std::acos(Dr::Clamp(a.dot(b) / lengths, -1.f, 1.f));
+        }
+    }
+
+    // ***** Corners of each welded vertex (CSR, counting sort)
+    std::vector<unsigned int> offsets(welded_count + 1, 0);
+    for (size_t c = 0; c < index_count; c++) offsets[remap[index(c)] + 1]++;
+    for (size_t w = 0; w < welded_count; w++) offsets[w + 1] += offsets[w];
+    std::vector<unsigned int> corners(index_count);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t c = 0; c < index_count; c++) corners[fill[remap[index(c)]]++] = static_cast<unsigned int>(c);
+
+    // ***** Smoothing groups per welded vertex
+    float crease_cos = std::cos(static_cast<float>(Dr::DegreesToRadians(static_cast<double>(crease_angle))));
+    std::vector<DrVec3>       corner_normals(index_count);
+    std::vector<unsigned int> corner_group(index_count);
+    std::vector<DrVec3>       seeds, sums;
+    for (size_t w = 0; w < welded_count; w++) {
+        seeds.clear();
+        sums.clear();
+        for (unsigned int i = offsets[w]; i < offsets[w + 1]; i++) {
+            unsigned int  c = corners[i];
+            const DrVec3 &n = face_normals[c / 3];
+            size_t group = 0;
+            while (group < seeds.size() && seeds[group].dot(n) < crease_cos) group++;
+            if (group == seeds.size()) {
+                seeds.push_back(n);
+                sums.push_back(DrVec3(0.f, 0.f, 0.f));
+            }
+            sums[group] += n * corner_angles[c];
+            corner_group[c] = static_cast<unsigned int>(group);
+        }
+        for (auto &sum : sums) {
+            float length = std::sqrt(sum.normSquared());
+            if (length > 0.f) sum = sum * (1.f / length);
+        }
+        for (unsigned int i = offsets[w]; i < offsets[w + 1]; i++) {
+            unsigned int c = corners[i];
+            corner_normals[c] = sums[corner_group[c]];
+        }
+    }
+
+    // ***** Expand into triangles with new normals, then re-index
+    std::vector<Vertex> expanded(index_count);
+    for (size_t c = 0; c < index_count; c++) {
+        Vertex v = vertices[index(c)];
+        v.nx = corner_normals[c].x;
+        v.ny = corner_normals[c].y;
+        v.nz = corner_normals[c].z;
+        v.bx = (c % 3 == 0) ? 1.f : 0.f;
+        v.by = (c % 3 == 1) ? 1.f : 0.f;
+        v.bz = (c % 3 == 2) ? 1.f : 0.f;
+        expanded[c] = v;
+    }
+    vertices.swap(expanded);
+    indices.clear();
+    optimizeMesh();
+}
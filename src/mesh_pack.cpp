@@ -0,0 +1,127 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <vector>
+
+#include "mesh.h"
+
+// Local Constants
+const unsigned int c_unassigned = 0xFFFFFFFF;
+
+
+//####################################################################################
+//##    Batches
+//####################################################################################
+void DrMeshPack::clear() {
+    vertices.clear();
+    short_indices.clear();
+    long_indices.clear();
+    batches.clear();
+    openBatch();
+}
+
+// Starts new 16 bit batch at end of vertex / index buffers
+void DrMeshPack::openBatch() {
+    m_open = DrDrawBatch();
+    m_open.base_vertex =    static_cast<unsigned int>(vertices.size());
+    m_open.first_index =    static_cast<unsigned int>(short_indices.size());
+    m_open.long_indices =   false;
+}
+
+// Stores open batch if it has anything in it, then opens next one
+void DrMeshPack::closeBatch() {
+    if (m_open.index_count > 0) batches.push_back(m_open);
+    openBatch();
+}
+
+void DrMeshPack::finish() {
+    closeBatch();
+}
+
+
+//####################################################################################
+//##    Packing
+//####################################################################################
+void DrMeshPack::pack(const std::vector<DrMesh> &meshes, bool allow_long_indices) {
+    clear();
+    for (const auto &mesh : meshes) {
+        addMesh(mesh, allow_long_indices);
+    }
+    finish();
+}
+
+void DrMeshPack::addMesh(const DrMesh &mesh, bool allow_long_indices) {
+    if (mesh.indices.size() < 3 || mesh.vertices.size() < 1) return;
+
+    // ***** Fits in a 16 bit batch, merge with open batch when there is room
+    if (mesh.vertices.size() <= c_max_short_batch_vertices) {
+        if (m_open.vertex_count + mesh.vertices.size() > c_max_short_batch_vertices) closeBatch();
+
+        unsigned int offset = m_open.vertex_count;
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        for (const auto &index : mesh.indices) {
+            short_indices.push_back(static_cast<uint16_t>(offset + index));
+        }
+        m_open.vertex_count += static_cast<unsigned int>(mesh.vertices.size());
+        m_open.index_count +=  static_cast<unsigned int>(mesh.indices.size());
+
+    // ***** Too big, gets its own 32 bit batch
+    } else if (allow_long_indices) {
+        closeBatch();
+        DrDrawBatch batch;
+        batch.base_vertex =     static_cast<unsigned int>(vertices.size());
+        batch.vertex_count =    static_cast<unsigned int>(mesh.vertices.size());
+        batch.first_index =     static_cast<unsigned int>(long_indices.size());
+        batch.index_count =     static_cast<unsigned int>(mesh.indices.size());
+        batch.long_indices =    true;
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        long_indices.insert(long_indices.end(), mesh.indices.begin(), mesh.indices.end());
+        batches.push_back(batch);
+        openBatch();
+
+    // ***** Too big and only 16 bit indices allowed, split into batches
+    } else {
+        closeBatch();
+        splitMesh(mesh);
+        closeBatch();
+    }
+}
+
+//####################################################################################
+//##    Splits mesh by triangles into 16 bit batches, vertices are copied in order of first use
+//##        Vertices shared by triangles on both sides of a split are duplicated into each batch
+//####################################################################################
+void DrMeshPack::splitMesh(const DrMesh &mesh) {
+    std::vector<unsigned int> local(mesh.vertices.size(), c_unassigned);     // Index of mesh vertex within open batch
+    std::vector<unsigned int> used;                                          // Mesh vertices assigned in open batch
+
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+        // Start new batch if triangle's new vertices won't fit
+        unsigned int added = 0;
+        for (size_t i = t; i < t + 3; i++) {
+            if (local[mesh.indices[i]] == c_unassigned) added++;
+        }
+        if (m_open.vertex_count + added > c_max_short_batch_vertices) {
+            closeBatch();
+            for (const auto &vertex : used) local[vertex] = c_unassigned;
+            used.clear();
+        }
+
+        for (size_t i = t; i < t + 3; i++) {
+            unsigned int vertex = mesh.indices[i];
+            if (local[vertex] == c_unassigned) {
+                local[vertex] = m_open.vertex_count++;
+                used.push_back(vertex);
+                vertices.push_back(mesh.vertices[vertex]);
+            }
+            short_indices.push_back(static_cast<uint16_t>(local[vertex]));
+        }
+        m_open.index_count += 3;
+    }
+}
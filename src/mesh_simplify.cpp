@@ -0,0 +1,119 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "3rd_party/mesh_optimizer/meshoptimizer.h"
+#include "compare.h"
+#include "mesh.h"
+
+// Local Constants
+const float c_sloppy_threshold =    1.5f;           // Use sloppy simplifier when result is this many times larger than target
+const float c_stall_ratio =         0.95f;          // Level must have less than this ratio of triangles of the level before it
+
+
+//####################################################################################
+//##    Expands simplified index list back into triangles with barycentric coordinates, then re-optimizes
+//####################################################################################
+static void buildLevelMesh(DrMesh &mesh, const std::vector<Vertex> &welded, const std::vector<unsigned int> &level_indices) {
+    mesh.indices.clear();
+    mesh.vertices.resize(level_indices.size());
+    for (size_t i = 0; i < level_indices.size(); i++) {
+        Vertex v = welded[level_indices[i]];
+        v.bx = (i % 3 == 0) ? 1.f : 0.f;
+        v.by = (i % 3 == 1) ? 1.f : 0.f;
+        v.bz = (i % 3 == 2) ? 1.f : 0.f;
+        mesh.vertices[i] = v;
+    }
+    mesh.optimizeMesh();
+}
+
+
+//####################################################################################
+//##    Builds Level of Detail Chain
+//##        Each level targets (triangle_ratio ^ level) of the triangles of this mesh and is simplified from the level before it.
+//##        Vertices are welded on position, normal and uv (barycentrics are ignored), so cap rims and sharp outline corners
+//##        become attribute seams. Simplifier only collapses seam / border vertices along their edge, never across, so creases
+//##        stay sharp and crack free while the outline loses points.
+//##
+//##        target_error    Maximum deviation allowed per level, relative to mesh extents (0.01 = 1%)
+//##        allow_sloppy    Opt in, when topology preserving simplifier can't get near target, fall back to meshopt_simplifySloppy.
+//##                        Sloppy simplifier ignores seams and borders, so those levels collapse across cap rims / creases
+//##                        and lose the guarantees above (see DrMeshLevel::sloppy)
+//##
+//##        Chain stops early once simplifier can no longer remove triangles
+//####################################################################################
+std::vector<DrMeshLevel> DrMesh::buildLevelsOfDetail(int level_count, float triangle_ratio, float target_error, bool allow_sloppy) const {
+    std::vector<DrMeshLevel> levels;
+    if (level_count < 1 || indices.size() < 3 || vertices.size() < 3) return levels;
+
+    // ***** Level 0, this mesh
+    DrMeshLevel first;
+    first.mesh = *this;
+    first.target_triangles = indexCount() / 3;
+    levels.push_back(std::move(first));
+
+    // ***** Weld vertices, ignoring barycentric coordinates
+    std::vector<Vertex> stripped(vertices);
+    for (auto &v : stripped) { v.bx = 0.f; v.by = 0.f; v.bz = 0.f; }
+    std::vector<unsigned int> remap(vertices.size());
+    size_t welded_count = meshopt_generateVertexRemap(&remap[0], &indices[0], indices.size(), &stripped[0], stripped.size(), sizeof(Vertex));
+
+    std::vector<Vertex>       welded(welded_count);
+    std::vector<unsigned int> level_indices(indices.size());
+    meshopt_remapVertexBuffer(&welded[0], &stripped[0], stripped.size(), sizeof(Vertex), &remap[0]);
+    meshopt_remapIndexBuffer(&level_indices[0], &indices[0], indices.size(), &remap[0]);
+
+    // ***** Simplify, each level starting from the previous one
+    float scale =       meshopt_simplifyScale(&welded[0].px, welded_count, sizeof(Vertex));
+    float total_error = 0.f;
+    std::vector<unsigned int> simplified(level_indices.size());
+
+    for (int level = 1; level < level_count; level++) {
+        size_t target = static_cast<size_t>(static_cast<double>(indices.size() / 3) * std::pow(triangle_ratio, level)) * 3;
+        target = Dr::Max(target, static_cast<size_t>(3));
+        target = Dr::Min(target, level_indices.size());                 // Previous level may already be below target (sloppy overshoot)
+
+        float  result_error = 0.f;
+        bool   sloppy = false;
+        size_t count = meshopt_simplify(&simplified[0], &level_indices[0], level_indices.size(), &welded[0].px, welded_count, sizeof(Vertex),
+                                       target, target_error, &result_error);
+
+        if (allow_sloppy && static_cast<float>(count) > static_cast<float>(target) * c_sloppy_threshold) {
+            std::vector<unsigned int> sloppy_indices(level_indices.size());
+            float  sloppy_error = 0.f;
+            size_t sloppy_count = meshopt_simplifySloppy(&sloppy_indices[0], &level_indices[0], level_indices.size(), &welded[0].px, welded_count,
+                                                         sizeof(Vertex), target, target_error, &sloppy_error);
+            if (sloppy_count >= 3 && sloppy_count < count) {
+                simplified.swap(sloppy_indices);
+                count =         sloppy_count;
+                result_error =  sloppy_error;
+                sloppy =        true;
+            }
+        }
+
+        // Simplifier stalled, no point adding identical levels
+        if (count < 3 || static_cast<float>(count) > static_cast<float>(level_indices.size()) * c_stall_ratio) break;
+
+        level_indices.assign(simplified.begin(), simplified.begin() + count);
+        total_error += result_error;
+
+        DrMeshLevel next;
+        buildLevelMesh(next.mesh, welded, level_indices);
+        next.target_triangles = static_cast<int>(target / 3);
+        next.error =            total_error;
+        next.absolute_error =   total_error * scale;
+        next.sloppy =           sloppy;
+        levels.push_back(std::move(next));
+    }
+
+    return levels;
+}
@@ -0,0 +1,240 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "compare.h"
+#include "mesh.h"
+
+// Local Constants
+const int c_empty_bucket = -1;
+
+
+//####################################################################################
+//##    Spatial Hash Weld
+//##        Groups vertices whose positions are within +-tolerance (on every axis) of the first vertex of a group,
+//##        same test as Dr::IsCloseTo(). Positions are bucketed in a grid with cells of 'tolerance' size, so only
+//##        the 27 surrounding cells are searched and the weld is O(V).
+//##
+//##        remap       Filled with welded index of each vertex, welded indices are assigned in order of first use
+//##        Returns number of welded vertices
+//####################################################################################
+static inline unsigned int hashCell(int x, int y, int z) {
+    return (static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(y) * 19349663u) ^ (static_cast<unsigned int>(z) * 83492791u);
+}
+
+size_t DrMesh::weldPositions(const std::vector<Vertex> &vertices, float tolerance, std::vector<unsigned int> &remap) {
+    remap.assign(vertices.size(), 0);
+    if (vertices.size() == 0) return 0;
+
+    float cell_size = Dr::Max(tolerance, std::numeric_limits<float>::epsilon());
+    float inverse = 1.f / cell_size;
+
+    // Open hash table of buckets, each bucket holds chain of welded vertices (linked through 'next')
+    size_t bucket_count = 1;
+    while (bucket_count < vertices.size() * 2) bucket_count *= 2;
+    unsigned int mask = static_cast<unsigned int>(bucket_count - 1);
+    std::vector<int> buckets(bucket_count, c_empty_bucket);
+    std::vector<int> next;              next.reserve(vertices.size());
+    std::vector<int> cells;             cells.reserve(vertices.size() * 3);
+    std::vector<unsigned int> first;    first.reserve(vertices.size());         // First vertex of each welded group
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex &v = vertices[i];
+        int cx = static_cast<int>(std::floor(v.px * inverse));
+        int cy = static_cast<int>(std::floor(v.py * inverse));
+        int cz = static_cast<int>(std::floor(v.pz * inverse));
+
+        // Search surrounding cells for a group within tolerance
+        int found = c_empty_bucket;
+        for (int x = cx - 1; x <= cx + 1 && found == c_empty_bucket; x++) {
+            for (int y = cy - 1; y <= cy + 1 && found == c_empty_bucket; y++) {
+                for (int z = cz - 1; z <= cz + 1 && found == c_empty_bucket; z++) {
+                    for (int w = buckets[hashCell(x, y, z) & mask]; w != c_empty_bucket; w = next[w]) {
+                        if (cells[w*3 + 0] != x || cells[w*3 + 1] != y || cells[w*3 + 2] != z) continue;
+                        const Vertex &o = vertices[first[w]];
+                        if (Dr::IsCloseTo(o.px, v.px, tolerance) && Dr::IsCloseTo(o.py, v.py, tolerance) && Dr::IsCloseTo(o.pz, v.pz, tolerance)) {
+                            found = w;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        // New group
+        if (found == c_empty_bucket) {
+            found = static_cast<int>(first.size());
+            unsigned int bucket = hashCell(cx, cy, cz) & mask;
+            first.push_back(static_cast<unsigned int>(i));
+            cells.push_back(cx);    cells.push_back(cy);    cells.push_back(cz);
+            next.push_back(buckets[bucket]);
+            buckets[bucket] = found;
+        }
+        remap[i] = static_cast<unsigned int>(found);
+    }
+    return first.size();
+}
+
+
+//####################################################################################
+//##    Vertex Adjacency (CSR), neighbors of welded vertex v are neighbors[offsets[v]] to neighbors[offsets[v + 1] - 1]
+//##        Built with two passes over the indices, each row is sorted and without duplicates
+//####################################################################################
+static void buildVertexAdjacency(const std::vector<unsigned int> &indices, const std::vector<unsigned int> &remap, size_t vertex_count,
+                                 std::vector<unsigned int> &offsets, std::vector<unsigned int> &neighbors) {
+    // ***** Count, then prefix sum into row offsets
+    offsets.assign(vertex_count + 1, 0);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int a = remap[indices[t + k]];
+            unsigned int b = remap[indices[t + ((k + 1) % 3)]];
+            if (a == b) continue;
+            offsets[a + 1]++;
+            offsets[b + 1]++;
+        }
+    }
+    for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] += offsets[v];
+
+    // ***** Fill rows
+    neighbors.resize(offsets[vertex_count]);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int a = remap[indices[t + k]];
+            unsigned int b = remap[indices[t + ((k + 1) % 3)]];
+            if (a == b) continue;
+            neighbors[fill[a]++] = b;
+            neighbors[fill[b]++] = a;
+        }
+    }
+
+    // ***** Remove duplicates (interior edges are seen from both triangles), compacting rows in place
+    unsigned int write = 0;
+    for (size_t v = 0; v < vertex_count; v++) {
+        unsigned int begin = offsets[v];
+        unsigned int end =   offsets[v + 1];
+        std::sort(neighbors.begin() + begin, neighbors.begin() + end);
+        offsets[v] = write;
+        for (unsigned int n = begin; n < end; n++) {
+            if (n > begin && neighbors[n] == neighbors[n - 1]) continue;
+            neighbors[write++] = neighbors[n];
+        }
+    }
+    offsets[vertex_count] = write;
+    neighbors.resize(write);
+}
+
+
+//####################################################################################
+//##    One Jacobi smoothing step for welded vertices [begin, end), reads 'from' and writes 'to'
+//##        Rows don't depend on each other, so ranges can be run on separate threads
+//####################################################################################
+struct SmoothVertex {
+    float px, py, pz;
+    float nx, ny, nz;
+    float tx, ty;
+};
+
+static void smoothRange(size_t begin, size_t end, const std::vector<unsigned int> &offsets, const std::vector<unsigned int> &neighbors,
+                        const std::vector<SmoothVertex> &from, std::vector<SmoothVertex> &to) {
+    for (size_t v = begin; v < end; v++) {
+        const SmoothVertex &o = from[v];
+        SmoothVertex s = o;
+        float weight = 1.f;
+
+        // Add neighbors diminished by distance
+        for (unsigned int n = offsets[v]; n < offsets[v + 1]; n++) {
+            const SmoothVertex &neighbor = from[neighbors[n]];
+            float dx = neighbor.px - o.px, dy = neighbor.py - o.py, dz = neighbor.pz - o.pz;
+            float edge_length = std::sqrt(dx*dx + dy*dy + dz*dz);
+            if (edge_length == 0.f) edge_length = std::numeric_limits<float>::epsilon();
+            float d = 1.f / edge_length;
+            s.px += neighbor.px * d;    s.py += neighbor.py * d;    s.pz += neighbor.pz * d;
+            s.nx += neighbor.nx * d;    s.ny += neighbor.ny * d;    s.nz += neighbor.nz * d;
+            s.tx += neighbor.tx * d;    s.ty += neighbor.ty * d;
+            weight += d;
+        }
+        s.px /= weight;     s.py /= weight;     s.pz /= weight;
+        s.tx = Dr::Clamp(s.tx / weight, 0.f, 1.f);
+        s.ty = Dr::Clamp(s.ty / weight, 0.f, 1.f);
+
+        float length = std::sqrt(s.nx*s.nx + s.ny*s.ny + s.nz*s.nz);
+        if (length > 0.f) { s.nx /= length; s.ny /= length; s.nz /= length; }
+        to[v] = s;
+    }
+}
+
+
+//####################################################################################
+//##    Smooth Mesh
+//##        Laplacian smoothing of indexed mesh, coincident vertices (within weld_tolerance) are welded and moved together.
+//##        Each vertex is averaged with its neighbors weighted by inverse edge length. Setup is O(V + I), each iteration
+//##        is O(V + I) too.
+//####################################################################################
+void DrMesh::smoothMesh(int iterations, float weld_tolerance) {
+    if (indices.size() < 3 || vertices.size() < 3 || iterations < 1) return;
+    clearMeshlets();                                                    // Meshlet bounds / cones would be stale
+
+    // ***** Weld, welded vertex starts at first vertex of its group with average normal of the group
+    std::vector<unsigned int> remap;
+    size_t welded_count = weldPositions(vertices, weld_tolerance, remap);
+
+    std::vector<SmoothVertex> welded(welded_count);
+    std::vector<bool>         assigned(welded_count, false);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex &v = vertices[i];
+        SmoothVertex &w = welded[remap[i]];
+        if (assigned[remap[i]] == false) {
+            w = SmoothVertex { v.px, v.py, v.pz, v.nx, v.ny, v.nz, v.tx, v.ty };
+            assigned[remap[i]] = true;
+        } else {
+            w.nx += v.nx;   w.ny += v.ny;   w.nz += v.nz;
+        }
+    }
+    for (auto &w : welded) {
+        float length = std::sqrt(w.nx*w.nx + w.ny*w.ny + w.nz*w.nz);
+        if (length > 0.f) { w.nx /= length; w.ny /= length; w.nz /= length; }
+    }
+
+    // ***** Adjacency, then smooth
+    std::vector<unsigned int> offsets, neighbors;
+    buildVertexAdjacency(indices, remap, welded_count, offsets, neighbors);
+
+    std::vector<SmoothVertex> smoothed(welded_count);
+    for (int i = 0; i < iterations; i++) {
+        smoothRange(0, welded_count, offsets, neighbors, welded, smoothed);
+        welded.swap(smoothed);
+    }
+
+    // ***** Set all vertices of each group to smoothed vertex
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const SmoothVertex &s = welded[remap[i]];
+        Vertex &v = vertices[i];
+        v.px = s.px;    v.py = s.py;    v.pz = s.pz;
+        v.nx = s.nx;    v.ny = s.ny;    v.nz = s.nz;
+        v.tx = s.tx;    v.ty = s.ty;
+    }
+
+    // ***** Reset barycentric coordinates
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        vertices[indices[i+0]].bx = 1;
+        vertices[indices[i+0]].by = 0;
+        vertices[indices[i+0]].bz = 0;
+        vertices[indices[i+1]].bx = 0;
+        vertices[indices[i+1]].by = 1;
+        vertices[indices[i+1]].bz = 0;
+        vertices[indices[i+2]].bx = 0;
+        vertices[indices[i+2]].by = 0;
+        vertices[indices[i+2]].bz = 1;
+    }
+}
@@ -7,10 +7,14 @@
 // Copyright (c) 2021 Stephens Nunnally and Scidian Software
 //
 //
+#include <cstring>
+
 #include "../3rd_party/stb/stb_image.h"
 #include "../3rd_party/stb/stb_image_resize.h"
 #include "../3rd_party/stb/stb_image_write.h"
+#include "../compare.h"
 #include "bitmap.h"
+#include "bitmap_view.h"
 #include "color.h"
 #include "pointf.h"
 #include "polygonf.h"
@@ -28,9 +32,8 @@ DrBitmap::DrBitmap(Bitmap_Format desired_format) {
         case Bitmap_Format::ARGB:        channels = 4;   break;
     }
 }
-DrBitmap::~DrBitmap() { 
-    data.clear(); 
-}
+
+DrBitmap::DrBitmap(const DrBitmap &bitmap) : DrBitmap(bitmap, bitmap.format) { }
 
 DrBitmap::DrBitmap(const DrBitmap &bitmap, Bitmap_Format desired_format) : DrBitmap(bitmap.width, bitmap.height, desired_format) {
     if (bitmap.format == format && data.size()) {
@@ -48,6 +51,11 @@ DrBitmap::DrBitmap(const DrBitmap &bitmap, Bitmap_Format desired_format) : DrBit
     }
 }
 
+// Copies pixels of view (same format)
+DrBitmap::DrBitmap(const DrBitmapView &view) : DrBitmap(view.width, view.height, view.format) {
+    paste(view, 0, 0);
+}
+
 // Create empty bitmap
 DrBitmap::DrBitmap(int width_, int height_, Bitmap_Format desired_format) : DrBitmap(desired_format) {
     width =     width_;
@@ -103,6 +111,25 @@ DrBitmap DrBitmap::copy(DrRect &copy_rect) {
     return copy;
 }
 
+// Rows are copied with memcpy when formats match, otherwise pixel by pixel
+void DrBitmap::paste(const DrBitmapView &source, int at_x, int at_y) {
+    int first_x = Dr::Max(0, -at_x),    last_x = Dr::Min(source.width,  width  - at_x);
+    int first_y = Dr::Max(0, -at_y),    last_y = Dr::Min(source.height, height - at_y);
+    if (source.isValid() == false || last_x <= first_x || last_y <= first_y) return;
+
+    if (source.format == format) {
+        size_t row_bytes = static_cast<size_t>(last_x - first_x) * channels;
+        for (int y = first_y; y < last_y; ++y) {
+            size_t index = (static_cast<size_t>(y + at_y) * width + (first_x + at_x)) * channels;
+            memcpy(&data[index], source.row(y) + first_x * channels, row_bytes);
+        }
+    } else {
+        for (int y = first_y; y < last_y; ++y) {
+            for (int x = first_x; x < last_x; ++x) setPixel(x + at_x, y + at_y, source.getPixel(x, y));
+        }
+    }
+}
+
 // Returns a clockwise polygon representing a box around this image
 DrPolygonF DrBitmap::polygon() const {
     DrPolygonF box;
@@ -126,12 +153,12 @@ DrColor DrBitmap::getPixel(int x, int y) const {
     }
 }
 
-// DrBitmap data is in the format (Format_ARGB32)
+// DrBitmap data is in the format (Format_ARGB32), Grayscale bitmaps are one byte of alpha per pixel (alpha plane / masks)
 void DrBitmap::setPixel(int x, int y, DrColor color) {
     size_t index = (y * this->width * channels) + (x * channels);
     switch (format) {
         case Bitmap_Format::Grayscale:   
-            data[index]   = (color.redF() * 0.2126) + (color.greenF() * 0.7152) + (color.blueF() * 0.0722);
+            data[index]   = color.alpha();
             break;
         case Bitmap_Format::ARGB:        
             data[index]   = color.blue();
@@ -167,8 +194,11 @@ void DrBitmap::fuzzyAlpha() {
 //##    Loading Images
 //####################################################################################
 void DrBitmap::loadFromFile(std::string filename, Bitmap_Format desired_format) {
-    // Load Image
-    unsigned char* ptr = stbi_load(filename.data(), &width, &height, &channels, desired_format);
+    // Load Image, stb converts to desired number of channels (file channel count is not used)
+    int file_channels;
+    unsigned char* ptr = stbi_load(filename.data(), &width, &height, &file_channels, desired_format);
+    format =   desired_format;
+    channels = desired_format;
 
     // Error Check
     if (ptr == nullptr || width == 0 || height == 0) {
@@ -193,7 +223,8 @@ void DrBitmap::loadFromMemory(const unsigned char *from_data, const int &number_
     // Load Image
     } else {
         const stbi_uc *compressed_data = reinterpret_cast<const stbi_uc*>(from_data);
-        unsigned char* ptr = stbi_load_from_memory(compressed_data, number_of_bytes, &width, &height, &channels, channels);
+        int file_channels;
+        unsigned char* ptr = stbi_load_from_memory(compressed_data, number_of_bytes, &width, &height, &file_channels, channels);
 
         // Error Check
         if (ptr == nullptr || width == 0 || height == 0) {
@@ -208,6 +239,40 @@ void DrBitmap::loadFromMemory(const unsigned char *from_data, const int &number_
     }
 }
 
+
+
+//####################################################################################
+//##    Alpha Only Loading
+//##        Object finding / outlining only read alpha, so these load a one channel alpha plane (Grayscale format,
+//##        each byte is alpha, see DrBitmapView::alpha()) for when color isn't needed. stb decodes to gray + alpha
+//##        (images without alpha come back opaque), half the output of a 4 channel decode, packed to alpha in place.
+//####################################################################################
+static void keepAlphaPlane(DrBitmap &bitmap, unsigned char *gray_alpha) {
+    bitmap.format =   Bitmap_Format::Grayscale;
+    bitmap.channels = 1;
+    if (gray_alpha == nullptr || bitmap.width <= 0 || bitmap.height <= 0) {
+        if (gray_alpha) stbi_image_free(gray_alpha);
+        bitmap.width = 0;   bitmap.height = 0;
+        bitmap.data.clear();
+        return;
+    }
+    size_t pixel_count = static_cast<size_t>(bitmap.width) * static_cast<size_t>(bitmap.height);
+    for (size_t i = 0; i < pixel_count; ++i) gray_alpha[i] = gray_alpha[i * 2 + 1];
+    bitmap.data.assign(gray_alpha, gray_alpha + pixel_count);
+    stbi_image_free(gray_alpha);
+}
+
+void DrBitmap::loadAlphaFromFile(std::string filename) {
+    int file_channels;
+    keepAlphaPlane(*this, stbi_load(filename.data(), &width, &height, &file_channels, 2));
+}
+
+void DrBitmap::loadAlphaFromMemory(const unsigned char *compressed_data, const int &number_of_bytes) {
+    int file_channels;
+    keepAlphaPlane(*this, stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(compressed_data), number_of_bytes,
+                                                &width, &height, &file_channels, 2));
+}
+
 // Aligns pixel format (stb ABGR vs QImage ARGB) for stbi_write
 void DrBitmap::saveFormat(std::vector<unsigned char> &formatted) {
     formatted.resize(width * height * channels);
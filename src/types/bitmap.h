@@ -15,6 +15,7 @@
 
 
 // Forward Declarations
+class DrBitmapView;
 class DrColor;
 class DrPolygonF;
 class DrRect;
@@ -42,10 +43,14 @@ public:
 
 
 public:
-    // Constructors
+    // Constructors, moves take over pixel data without copying
     DrBitmap(Bitmap_Format desired_format = Bitmap_Format::ARGB);
-    ~DrBitmap();
-    DrBitmap(const DrBitmap &bitmap, Bitmap_Format desired_format = Bitmap_Format::ARGB);
+    DrBitmap(const DrBitmap &bitmap);                                   // Keeps format of 'bitmap'
+    DrBitmap(const DrBitmap &bitmap, Bitmap_Format desired_format);
+    DrBitmap(DrBitmap &&bitmap) noexcept = default;
+    DrBitmap& operator=(const DrBitmap &bitmap) = default;
+    DrBitmap& operator=(DrBitmap &&bitmap) noexcept = default;
+    explicit DrBitmap(const DrBitmapView &view);
     DrBitmap(int width_, int height_, Bitmap_Format desired_format = Bitmap_Format::ARGB);
     DrBitmap(std::string filename, Bitmap_Format desired_format = Bitmap_Format::ARGB);
     DrBitmap(const unsigned char *from_data, const int &number_of_bytes,
@@ -61,6 +66,7 @@ public:
     DrRect      rect() const;
     DrColor     getPixel(int x, int y) const;
     void        setPixel(int x, int y, DrColor color);
+    void        paste(const DrBitmapView &source, int at_x, int at_y);     // Copies source into this bitmap, clipped to bitmap
 
     // Alpha Testing
     void    fuzzyAlpha();
@@ -69,6 +75,8 @@ public:
     void    loadFromFile(std::string filename, Bitmap_Format desired_format = Bitmap_Format::ARGB);
     void    loadFromMemory(const unsigned char *compressed_data, const int &number_of_bytes,
                            bool compressed = true, int width_ = 0, int height_ = 0);
+    void    loadAlphaFromFile(std::string filename);                    // Alpha only, one channel (Grayscale) alpha plane
+    void    loadAlphaFromMemory(const unsigned char *compressed_data, const int &number_of_bytes);
 
 
     void    saveFormat(std::vector<unsigned char> &formatted);          // Realigns pixels with stb image format
@@ -0,0 +1,69 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include "../compare.h"
+#include "bitmap.h"
+#include "bitmap_view.h"
+#include "color.h"
+#include "rect.h"
+
+
+//####################################################################################
+//##    Constructors
+//####################################################################################
+DrBitmapView::DrBitmapView(const DrBitmap &bitmap) {
+    data =      (bitmap.data.size() > 0) ? &bitmap.data[0] : nullptr;
+    format =    bitmap.format;
+    channels =  bitmap.channels;
+    width =     bitmap.width;
+    height =    bitmap.height;
+    stride =    bitmap.width * bitmap.channels;
+}
+
+// Stride of 0 means rows are packed (width * channels bytes)
+DrBitmapView::DrBitmapView(const unsigned char *pixels, int width_, int height_, int stride_, Bitmap_Format format_) {
+    data =      pixels;
+    format =    format_;
+    channels =  (format_ == Bitmap_Format::Grayscale) ? 1 : 4;
+    width =     width_;
+    height =    height_;
+    stride =    (stride_ > 0) ? stride_ : width_ * channels;
+}
+
+
+//####################################################################################
+//##    Info / Access
+//####################################################################################
+DrRect DrBitmapView::rect() const {
+    return DrRect(0, 0, width, height);
+}
+
+// Same channel order as DrBitmap::getPixel()
+DrColor DrBitmapView::getPixel(int x, int y) const {
+    const unsigned char *pixel = row(y) + x * channels;
+    if (format == Bitmap_Format::Grayscale) return DrColor(pixel[0], pixel[0], pixel[0], pixel[0]);
+    return DrColor(pixel[2], pixel[1], pixel[0], pixel[3]);
+}
+
+DrBitmapView DrBitmapView::region(DrRect roi) const {
+    int left =      Dr::Max(roi.left(), 0);
+    int top =       Dr::Max(roi.top(),  0);
+    int right =     Dr::Min(roi.left() + roi.width,  width);
+    int bottom =    Dr::Min(roi.top()  + roi.height, height);
+    DrBitmapView view = *this;
+    if (right <= left || bottom <= top) {
+        view.width =    0;
+        view.height =   0;
+        return view;
+    }
+    view.data =     row(top) + left * channels;
+    view.width =    right - left;
+    view.height =   bottom - top;
+    return view;
+}
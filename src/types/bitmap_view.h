@@ -0,0 +1,57 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#ifndef DR_BITMAP_VIEW_H
+#define DR_BITMAP_VIEW_H
+
+#include "bitmap.h"
+
+// Forward Declarations
+class DrColor;
+class DrRect;
+
+
+//####################################################################################
+//##    DrBitmapView
+//##        Non-owning, read only window into pixel data laid out like DrBitmap (4 channel pixels with alpha in the
+//##        last byte, or 1 channel grayscale). Rows are 'stride' bytes apart, so a view can cover a region of a
+//##        larger buffer (a decoded stb_image buffer, a DrBitmap, or part of either) without copying it.
+//##        Pixels must outlive the view.
+//############################
+class DrBitmapView
+{
+public:
+    const unsigned char    *data        = nullptr;                  // First pixel of first row
+    Bitmap_Format           format      = Bitmap_Format::ARGB;
+    int                     channels    = 4;
+    int                     width       = 0;
+    int                     height      = 0;
+    int                     stride      = 0;                        // Bytes from one row to the next
+
+public:
+    // Constructors
+    DrBitmapView() { }
+    DrBitmapView(const DrBitmap &bitmap);
+    DrBitmapView(const unsigned char *pixels, int width_, int height_, int stride_ = 0, Bitmap_Format format_ = Bitmap_Format::ARGB);
+
+    // Info
+    bool                    isValid() const             { return (data != nullptr && width > 0 && height > 0); }
+    DrRect                  rect() const;
+
+    // Access, no out of bounds checks are done for speed
+    const unsigned char*    row(int y) const            { return data + static_cast<size_t>(y) * static_cast<size_t>(stride); }
+    unsigned char           alpha(int x, int y) const   { return row(y)[x * channels + (channels - 1)]; }
+    DrColor                 getPixel(int x, int y) const;
+
+    // Sub region, clipped to this view, shares pixels
+    DrBitmapView            region(DrRect roi) const;
+};
+
+
+#endif // DR_BITMAP_VIEW_H
@@ -7,9 +7,14 @@
 // Copyright (c) 2021 Stephens Nunnally and Scidian Software
 //
 //
+#include <utility>
+
 #include "../3rd_party/polyline_simplification.h"
+#include "../budget.h"
 #include "../compare.h"
 #include "../imaging.h"
+#include "../imaging_tiled.h"
+#include "../instrument.h"
 #include "../mesh.h"
 #include "color.h"
 #include "image.h"
@@ -26,18 +31,46 @@ const int c_neighbors =             5;                  // Number of neighbors t
 //####################################################################################
 //##    Constructors
 //####################################################################################
-DrImage::DrImage(std::string image_name, DrBitmap &bitmap, float lod, bool outline) {
-    this->m_simple_name = image_name;
-    this->m_bitmap = bitmap;
+DrImage::DrImage(std::string image_name, const DrBitmapView &bitmap, float lod, bool outline, int tile_size, bool keep_pixels)
+    : m_simple_name(std::move(image_name)) {
+    // Outlines are traced straight from view, image only keeps the size unless asked to keep a copy of the pixels
+    if (keep_pixels) {
+        m_bitmap = DrBitmap(bitmap);
+    } else {
+        m_bitmap.width =  bitmap.width;
+        m_bitmap.height = bitmap.height;
+    }
+    m_tile_size = Dr::Max(tile_size, 0);
+    if (outline == false)   initialize(lod, outline);
+    else if (tile_size > 0) outlinePointsTiled(bitmap, lod, tile_size);
+    else                    outlinePoints(bitmap, lod);
+}
+
+DrImage::DrImage(std::string image_name, DrBitmap &&bitmap, float lod, bool outline)
+    : m_simple_name(std::move(image_name)), m_bitmap(std::move(bitmap)) {
+    initialize(lod, outline);
+}
 
+void DrImage::initialize(float lod, bool outline) {
     if (outline) {
         outlinePoints(lod);
     } else {
-        m_poly_list.push_back(bitmap.polygon().points());
+        m_poly_list.push_back(m_bitmap.polygon().points());
         m_hole_list.push_back({});
+        m_object_seeds.push_back(DrPoint(0, 0));
     }
 }
 
+// First object pixel (non zero) in column order of an object bitmap from Dr::FindObjectsInBitmap(), in image coordinates
+static DrPoint ObjectSeed(const DrBitmap &image, const DrRect &rect) {
+    for (int x = 0; x < image.width; ++x) {
+        for (int y = 0; y < image.height; ++y) {
+            if (image.getPixel(x, y) != Dr::transparent) return DrPoint(rect.x + x, rect.y + y);
+        }
+    }
+    return DrPoint(rect.x, rect.y);
+}
+
 
 
 //####################################################################################
@@ -49,8 +82,10 @@ void DrImage::setSimpleBox() {
     DrPolygonF::ensureWindingOrientation(one_poly, Winding_Orientation::CounterClockwise);
     m_poly_list.clear();
     m_hole_list.clear();
-    m_poly_list.push_back(one_poly);
-    m_hole_list.push_back(hole_list);
+    m_object_seeds.clear();
+    m_poly_list.push_back(std::move(one_poly));
+    m_hole_list.push_back(std::move(hole_list));
+    m_object_seeds.push_back(DrPoint(0, 0));
     m_outline_canceled =  true;
     m_outline_processed = false;
 }
@@ -65,118 +100,335 @@ void DrImage::setSimpleBox() {
 //##        1.000 = Low poly
 //##       10.000 = Really low poly
 //##
+//##    Budget (see DrBudget), if active budget runs out while finding objects image is a simple box, if it runs
+//##    out while tracing objects the rest are boxes of their bounds. Either way outlineCanceled() is true.
+//##
 //####################################################################################        
 void DrImage::outlinePoints(float lod) {
+    if (m_bitmap.data.size() == 0 && m_bitmap.width > 0) { setSimpleBox(); return; }           // No pixels kept
+    outlinePoints(DrBitmapView(m_bitmap), lod);
+}
+
+// Same as outlinePoints(float), outlines 'bitmap' (same size as image) instead of pixels kept by image
+void DrImage::outlinePoints(const DrBitmapView &bitmap, float lod) {
+    DR_TIME_SCOPE("outlinePoints");
     m_poly_list.clear();
     m_hole_list.clear();
+    m_object_seeds.clear();
+
+    // ***** Only search tight bounds of visible pixels, plus a one pixel border so objects keep the transparent edge
+    //       they have in the full image (objects, rects and outlines come out the same as searching whole image)
+    DrRect  bounds = Dr::AlphaBounds(bitmap, c_alpha_tolerance);
+    bounds.adjust(-1, -1, 1, 1);
+    DrBitmapView content = bitmap.region(bounds);
+    DR_COUNT(Pixels_Trimmed, bitmap.width * bitmap.height - content.width * content.height);
 
     // ***** Break pixmap into seperate images for each object in image
+    Dr::BudgetStage(Budget_Stage::Finding_Objects);
     std::vector<DrBitmap>   bitmaps;
     std::vector<DrRect>     rects;
-    bool    cancel = Dr::FindObjectsInBitmap(m_bitmap, bitmaps, rects, c_alpha_tolerance, true);
+    bool    cancel = Dr::FindObjectsInBitmap(content, bitmaps, rects, c_alpha_tolerance, true);
     int     number_of_objects = static_cast<int>(bitmaps.size());
+    int     content_x = Dr::Max(bounds.x, 0);
+    int     content_y = Dr::Max(bounds.y, 0);
+    for (auto &rect : rects) {
+        rect.x += content_x;
+        rect.y += content_y;
+    }
+    DR_COUNT(Objects_Found, number_of_objects);
 
     //std::cout << "Number of objects in image: " << number_of_objects << std::endl;
 
     // ***** If Find Objects In Bitmap never finished, just add simple box shape
     if (cancel) { setSimpleBox(); return; }
+    if (DrBudget *budget = Dr::ActiveBudget()) budget->objects_found += number_of_objects;
 
     // ******************** Go through each image (object) and Polygon for it
+    Dr::BudgetStage(Budget_Stage::Tracing);
+    m_outline_canceled = false;
     for (int image_number = 0; image_number < number_of_objects; image_number++) {
-        // Grab next image, check if its valid
-        DrBitmap &image = bitmaps[image_number];
-        if (image.width < 1 || image.height < 1) continue;
-
-        // Trace edge of image
-        std::vector<DrPointF> one_poly = Dr::TraceImageOutline(image);
-
-        // Add rect offset, and add 1.00 pixels buffer around image
-        double plus_one_pixel_percent_x = 1.0 + (1.00 / m_bitmap.width);
-        double plus_one_pixel_percent_y = 1.0 + (1.00 / m_bitmap.height);
-        for (auto &point : one_poly) {
-            point.x += rects[image_number].left();
-            point.y += rects[image_number].top();
-            point.x = point.x * plus_one_pixel_percent_x;
-            point.y = point.y * plus_one_pixel_percent_y;
-        }
+        DrPoint seed = ObjectSeed(bitmaps[image_number], rects[image_number]);
+        addObjectOutline(bitmaps[image_number], rects[image_number], seed, lod);
+        bitmaps[image_number] = DrBitmap();                             // Release pixels once object is outlined
+    }
 
-        // Remove duplicate first point
-        if (one_poly.size() > 3) one_poly.pop_back();
 
-        // Optimize point list
-        if (one_poly.size() > (c_neighbors * 2)) {
-            one_poly = DrMesh::smoothPoints(one_poly, c_neighbors, 20.0, 1.0);
-            one_poly = PolylineSimplification::RamerDouglasPeucker(one_poly, lod);  
-            //one_poly = DrMesh::insertPoints(one_poly);
+    // ***** Mark this DrImage as having traced the image outline
+    m_outline_processed = true;
+
+
+}   // End outlinePoints()
+
+
+//####################################################################################
+//##    Same as outlinePoints(), without a full size copy of the image. Objects are labeled a tile at a time by
+//##    DrTileComponents, objects whose mask (bounds plus a one pixel border) is no larger than a tile are copied into
+//##    one reused mask and traced whole. Larger objects are traced a tile at a time, contour pieces of each tile are
+//##    joined across seams, and their holes are labeled and traced in tiles of their bounds the same way. Working
+//##    memory is a few tiles plus labels along tile seams, whatever the size of the largest object. Outlines match
+//##    outlinePoints(), as does handling of active budget.
+//####################################################################################
+void DrImage::outlinePointsTiled(const DrBitmapView &bitmap, float lod, int tile_size) {
+    DR_TIME_SCOPE("outlinePointsTiled");
+    m_poly_list.clear();
+    m_hole_list.clear();
+    m_object_seeds.clear();
+
+    Dr::BudgetStage(Budget_Stage::Finding_Objects);
+    DrTileComponents objects(bitmap, c_alpha_tolerance, tile_size);
+    DR_COUNT(Objects_Found, objects.components.size());
+    if (Dr::BudgetExpired()) { setSimpleBox(); return; }
+    if (DrBudget *budget = Dr::ActiveBudget()) budget->objects_found += static_cast<int>(objects.components.size());
+
+    Dr::BudgetStage(Budget_Stage::Tracing);
+    m_outline_canceled = false;
+    DrBitmap image(Bitmap_Format::Grayscale);                           // Reused for every object that fits in a tile
+    for (const auto &object : objects.components) {
+        DrRect rect;
+        if (objects.fitsTile(object)) {
+            Dr::ObjectBitmap(bitmap, object, c_alpha_tolerance, rect, image);
+            addObjectOutline(image, rect, object.seed, lod);
+            continue;
         }
 
-        // If we only have a couple points left, add shape as a box of the original image, otherwise use PolylineSimplification points
-        if (one_poly.size() < 4) {
-            ///points = HullFinder::FindConcaveHull(points, 5.0);
-            one_poly.clear();
-            one_poly.push_back( DrPointF(rects[image_number].topLeft().x,        rects[image_number].topLeft().y) );
-            one_poly.push_back( DrPointF(rects[image_number].topRight().x,       rects[image_number].topRight().y) );
-            one_poly.push_back( DrPointF(rects[image_number].bottomRight().x,    rects[image_number].bottomRight().y) );
-            one_poly.push_back( DrPointF(rects[image_number].bottomLeft().x,     rects[image_number].bottomLeft().y) );
+        // Trace edge of object through tiles, then its holes
+        rect = objects.maskRect(object);
+        std::vector<DrPointF> one_poly;
+        std::vector<std::vector<DrPointF>> hole_list;
+        bool boxed = Dr::BudgetExpired();
+        if (boxed == false) one_poly = objects.traceOutline(object);
+        if (boxed == false && Dr::BudgetExpired()) { boxed = true;  one_poly.clear(); }
+        if (boxed == false) {
+            DrTileComponents holes(objects, object);
+            for (const auto &hole : holes.components) hole_list.push_back(holes.traceOutline(hole));
+        }
+        addTracedObject(one_poly, hole_list, rect, object.seed, lod, boxed);
+    }
+
+    m_outline_processed = true;
+}
+
+
+//####################################################################################
+//##    Incremental outlinePoints(), for editors that change part of an image. Pixels inside 'dirty' are copied from
+//##    'bitmap' (same size as image), then only objects with a pixel in or next to 'dirty' (before or after the edit,
+//##    so objects that merge or split are included) are found again and traced, every other object keeps its outline.
+//##    Objects are identified by seed, the first pixel in column order, which is also the order outlinePoints() finds
+//##    them in, so outlines come out the same as outlinePoints() on the edited image. Work follows size of the edit
+//##    and the objects it touches, not the size of the image.
+//##
+//##    Returns, for each object now in m_poly_list, its index before the update, or -1 if it was (re)traced. Meshes of
+//##    objects with an index can be kept, see DrMesh::reuseObjectMeshes(). Images that keep no pixels, aren't outlined
+//##    yet or changed size are outlined again in full (all -1), as are images with boxes left by a budget that ran out.
+//##    Untiled images keep a copy of the pixels from then on, so later updates are incremental.
+//##    If active budget (see DrBudget) runs out while finding objects image is a simple box (all -1).
+//####################################################################################
+vtr<int> DrImage::updateRegion(const DrBitmapView &bitmap, DrRect dirty, float lod) {
+    DR_TIME_SCOPE("updateRegion");
+    vtr<int> previous;
+    if (bitmap.isValid() == false) return previous;
+
+    // ***** Full outline when there are no outlines (or pixels) to keep
+    if (m_outline_processed == false || m_outline_canceled || m_bitmap.data.size() == 0 || m_object_seeds.size() != m_poly_list.size() ||
+        bitmap.width != m_bitmap.width || bitmap.height != m_bitmap.height) {
+        if (m_tile_size == 0 || m_bitmap.data.size() > 0) {                    // Tiled images only keep pixels if they were asked to
+            m_bitmap = DrBitmap(bitmap);
+        } else {
+            m_bitmap.width =  bitmap.width;
+            m_bitmap.height = bitmap.height;
         }
+        if (m_tile_size > 0) outlinePointsTiled(bitmap, lod, m_tile_size);
+        else                 outlinePoints(bitmap, lod);
+        previous.assign(m_poly_list.size(), -1);
+        return previous;
+    }
 
-        // Check winding
-        DrPolygonF::ensureWindingOrientation(one_poly, Winding_Orientation::CounterClockwise);
+    // ***** Objects touching edit (or pixels next to it, those can join / leave an object) before and after edit
+    if (dirty.x < 0) { dirty.width  += dirty.x;  dirty.x = 0; }
+    if (dirty.y < 0) { dirty.height += dirty.y;  dirty.y = 0; }
+    if (dirty.right()  > m_bitmap.width  - 1) dirty.width =  m_bitmap.width  - dirty.left();
+    if (dirty.bottom() > m_bitmap.height - 1) dirty.height = m_bitmap.height - dirty.top();
+    if (dirty.width <= 0 || dirty.height <= 0) {
+        for (int index = 0; index < static_cast<int>(m_poly_list.size()); ++index) previous.push_back(index);
+        return previous;
+    }
+    DrRect around = dirty;
+    around.adjust(-1, -1, 1, 1);
+    Dr::BudgetStage(Budget_Stage::Finding_Objects);
+    std::vector<DrObjectBounds> before = Dr::FindObjectBoundsTouching(m_bitmap, around, c_alpha_tolerance, m_visited);
+    m_bitmap.paste(bitmap.region(dirty), dirty.x, dirty.y);
+    std::vector<DrObjectBounds> after =  Dr::FindObjectBoundsTouching(m_bitmap, around, c_alpha_tolerance, m_visited);
+    DR_COUNT(Objects_Found, after.size());
+    if (Dr::BudgetExpired()) {
+        setSimpleBox();
+        previous.assign(m_poly_list.size(), -1);
+        return previous;
+    }
+    if (DrBudget *budget = Dr::ActiveBudget()) budget->objects_found += static_cast<int>(after.size());
+    Dr::BudgetStage(Budget_Stage::Tracing);
+
+    // ***** Merge kept objects and retraced objects, both are in seed order
+    auto seed_less = [](const DrPoint &a, const DrPoint &b) { return (a.x < b.x) || (a.x == b.x && a.y < b.y); };
+    vtr<vtr<DrPointF>>          old_polys;      old_polys.swap(m_poly_list);
+    vtr<vtr<vtr<DrPointF>>>     old_holes;      old_holes.swap(m_hole_list);
+    vtr<DrPoint>                old_seeds;      old_seeds.swap(m_object_seeds);
+    DrBitmap image(Bitmap_Format::Grayscale);                           // Reused for every retraced object
+    size_t removed = 0, added = 0;
+    for (size_t index = 0; index <= old_seeds.size(); ++index) {
+        bool last = (index == old_seeds.size());
+        if (last == false) {
+            while (removed < before.size() && seed_less(before[removed].seed, old_seeds[index])) removed++;
+            if (removed < before.size() && before[removed].seed == old_seeds[index]) continue;
+        }
+        while (added < after.size() && (last || seed_less(after[added].seed, old_seeds[index]))) {
+            DrRect   rect;
+            Dr::ObjectBitmap(m_bitmap, after[added], c_alpha_tolerance, rect, image);
+            if (addObjectOutline(image, rect, after[added].seed, lod)) previous.push_back(-1);
+            added++;
+        }
+        if (last) break;
+        m_poly_list.push_back(std::move(old_polys[index]));
+        m_hole_list.push_back(std::move(old_holes[index]));
+        m_object_seeds.push_back(old_seeds[index]);
+        previous.push_back(static_cast<int>(index));
+    }
+    return previous;
+}
 
-        // Add polygon to list of polygons in shape
-        m_poly_list.push_back(one_poly);
 
+//####################################################################################
+//##    Traces outline and holes of one object, 'image' is object pixels from Dr::FindObjectsInBitmap() / Dr::ObjectBitmap(),
+//##    'rect' is where it is in the full image, 'seed' is its first pixel in column order. Returns false if nothing was added.
+//##    'image' is used as scratch while finding holes (background around object is filled)
+//##    Once active budget (see DrBudget) has run out object is added as a box of 'rect' without holes, if it runs out
+//##    while holes are being found object keeps its outline without holes
+//####################################################################################
+bool DrImage::addObjectOutline(DrBitmap &image, DrRect &rect, const DrPoint &seed, float lod) {
+    if (image.width < 1 || image.height < 1) return false;
+
+    // Trace edge of image, add rect offset
+    std::vector<DrPointF> one_poly;
+    bool boxed = Dr::BudgetExpired();
+    if (boxed == false) one_poly = Dr::TraceImageOutline(image);
+    if (boxed == false && Dr::BudgetExpired()) { boxed = true;  one_poly.clear(); }
+    for (auto &point : one_poly) {
+        point.x += rect.left();
+        point.y += rect.top();
+    }
 
-        // ******************** Copy image and finds holes as seperate outlines
-        DrBitmap holes = image.copy();
-        Dr::FillBorder(holes, Dr::white, holes.rect());                     // Ensures only holes are left as black spots
+    // ******************** Finds holes as seperate outlines, fills background in place (image isn't needed after)
+    std::vector<std::vector<DrPointF>> hole_list;
+    if (boxed == false) {
+        Dr::FillBorder(image, Dr::white, image.rect());                 // Ensures only holes are left as black spots
 
         // Breaks holes into seperate images for each Hole
         std::vector<DrBitmap> hole_images;
-        std::vector<DrRect>   hole_rects;        
-        Dr::FindObjectsInBitmap(holes, hole_images, hole_rects, c_alpha_tolerance, false);
+        std::vector<DrRect>   hole_rects;
+        Dr::FindObjectsInBitmap(image, hole_images, hole_rects, c_alpha_tolerance, false);
 
-        // Go through each image (Hole) create list for it
-        std::vector<std::vector<DrPointF>> hole_list;
+        // Go through each image (Hole), trace edge of hole and add in sub image offset to points
         for (int hole_number = 0; hole_number < static_cast<int>(hole_images.size()); hole_number++) {
             DrBitmap &hole = hole_images[hole_number];
             if (hole.width < 1 || hole.height < 1) continue;
-
-            // Trace edge of hole
             std::vector<DrPointF> one_hole = Dr::TraceImageOutline(hole);
-
-            // Add in sub image offset to points and hole rects
             for (auto &point : one_hole) {
-                point.x += rects[image_number].left() + hole_rects[hole_number].left();
-                point.y += rects[image_number].top()  + hole_rects[hole_number].top();
+                point.x += rect.left() + hole_rects[hole_number].left();
+                point.y += rect.top()  + hole_rects[hole_number].top();
             }
+            hole_list.push_back(std::move(one_hole));
+        }
+    }
 
-            // Remove duplicate first point
-            if (one_hole.size() > 3) one_hole.pop_back();
+    addTracedObject(one_poly, hole_list, rect, seed, lod, boxed);
+    return true;
+}
 
-            // Optimize point list
-            if (one_hole.size() > (c_neighbors * 2)) {
-                one_hole = DrMesh::smoothPoints(one_hole, c_neighbors, 30.0, 1.0);
-                one_hole = PolylineSimplification::RamerDouglasPeucker(one_hole, lod);
-                //one_hole = DrMesh::insertPoints(one_hole);
-            }
 
-            if (one_hole.size() > 3) {
-                DrPolygonF::ensureWindingOrientation(one_hole, Winding_Orientation::Clockwise);
-                hole_list.push_back(one_hole);
-            }
-        }
-        m_hole_list.push_back(hole_list);
+//####################################################################################
+//##    Adds one traced object, 'one_poly' and 'hole_list' are points from Dr::TraceImageOutline() (or
+//##    DrTileComponents::traceOutline()) in image coordinates. Points are smoothed and simplified, an outline that
+//##    simplifies to less than four points (or a 'boxed' object) is added as a box of 'rect', holes that do are dropped.
+//##    Holes are dropped too if active budget (see DrBudget) has run out
+//####################################################################################
+void DrImage::addTracedObject(std::vector<DrPointF> &one_poly, std::vector<std::vector<DrPointF>> &hole_list, DrRect &rect,
+                              const DrPoint &seed, float lod, bool boxed) {
+    if (DrBudget *budget = Dr::ActiveBudget()) {
+        if (boxed) budget->objects_boxed++;
+        else       budget->objects_traced++;
+    }
+    if (boxed) m_outline_canceled = true;
+
+    // Add 1.00 pixels buffer around image
+    double plus_one_pixel_percent_x = 1.0 + (1.00 / m_bitmap.width);
+    double plus_one_pixel_percent_y = 1.0 + (1.00 / m_bitmap.height);
+    for (auto &point : one_poly) {
+        point.x = point.x * plus_one_pixel_percent_x;
+        point.y = point.y * plus_one_pixel_percent_y;
+    }
 
-    }   // End for each bitmap
+    // Remove duplicate first point
+    if (one_poly.size() > 3) one_poly.pop_back();
+    DR_COUNT(Contour_Points_Traced, one_poly.size());
 
+    // Optimize point list
+    if (one_poly.size() > (c_neighbors * 2)) {
+        { DR_TIME_SCOPE("smoothPoints");          one_poly = DrMesh::smoothPoints(one_poly, c_neighbors, 20.0, 1.0); }
+        DR_COUNT(Contour_Points_Smoothed, one_poly.size());
+        { DR_TIME_SCOPE("RamerDouglasPeucker");   one_poly = PolylineSimplification::RamerDouglasPeucker(one_poly, lod); }
+        //one_poly = DrMesh::insertPoints(one_poly);
+    } else {
+        DR_COUNT(Contour_Points_Smoothed, one_poly.size());
+    }
+    DR_COUNT(Contour_Points_Simplified, one_poly.size());
+
+    // If we only have a couple points left, add shape as a box of the original image, otherwise use PolylineSimplification points
+    if (one_poly.size() < 4) {
+        ///points = HullFinder::FindConcaveHull(points, 5.0);
+        one_poly.clear();
+        one_poly.push_back( DrPointF(rect.topLeft().x,        rect.topLeft().y) );
+        one_poly.push_back( DrPointF(rect.topRight().x,       rect.topRight().y) );
+        one_poly.push_back( DrPointF(rect.bottomRight().x,    rect.bottomRight().y) );
+        one_poly.push_back( DrPointF(rect.bottomLeft().x,     rect.bottomLeft().y) );
+    }
 
-    // ***** Mark this DrImage as having traced the image outline
-    m_outline_canceled = false;
-    m_outline_processed = true;
+    // Check winding
+    DrPolygonF::ensureWindingOrientation(one_poly, Winding_Orientation::CounterClockwise);
 
+    // Add polygon to list of polygons in shape
+    m_poly_list.push_back(std::move(one_poly));
+    if (boxed) {
+        m_hole_list.push_back({});
+        m_object_seeds.push_back(seed);
+        return;
+    }
 
-}   // End outlinePoints()
+    // Go through each hole, optimize its point list
+    std::vector<std::vector<DrPointF>> holes;
+    for (auto &one_hole : hole_list) {
+        // Remove duplicate first point
+        if (one_hole.size() > 3) one_hole.pop_back();
+        DR_COUNT(Contour_Points_Traced, one_hole.size());
+
+        // Optimize point list
+        if (one_hole.size() > (c_neighbors * 2)) {
+            { DR_TIME_SCOPE("smoothPoints");          one_hole = DrMesh::smoothPoints(one_hole, c_neighbors, 30.0, 1.0); }
+            DR_COUNT(Contour_Points_Smoothed, one_hole.size());
+            { DR_TIME_SCOPE("RamerDouglasPeucker");   one_hole = PolylineSimplification::RamerDouglasPeucker(one_hole, lod); }
+            //one_hole = DrMesh::insertPoints(one_hole);
+        } else {
+            DR_COUNT(Contour_Points_Smoothed, one_hole.size());
+        }
+        DR_COUNT(Contour_Points_Simplified, one_hole.size());
+
+        if (one_hole.size() > 3) {
+            DrPolygonF::ensureWindingOrientation(one_hole, Winding_Orientation::Clockwise);
+            holes.push_back(std::move(one_hole));
+        }
+    }
+    if (Dr::BudgetExpired()) { holes.clear();  m_outline_canceled = true; }
+    m_hole_list.push_back(std::move(holes));
+    m_object_seeds.push_back(seed);
+}
 
 
 
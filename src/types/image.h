@@ -16,7 +16,10 @@
 #include <vector>
 
 #include "bitmap.h"
+#include "bitmap_view.h"
+#include "point.h"
 #include "pointf.h"
+#include "rect.h"
 
 
 // Local Constants
@@ -38,23 +41,37 @@ private:
 public:
     vtr<vtr<DrPointF>>          m_poly_list;                                                // Stores list of image outline points
     vtr<vtr<vtr<DrPointF>>>     m_hole_list;                                                // Stores list of hole  outline points
-    bool                        m_outline_canceled      { false };                          // True when Image Outline has been canceled, when true extrudes in 3D as simple square
+    bool                        m_outline_canceled      { false };                          // True when Image Outline has been canceled (or ran out of budget), some or all objects are simple boxes
     bool                        m_outline_processed     { false };                          // Turns true when autoOutlinePoints() has completed successfully
 
 private:
     // Internal Variables
     std::string                 m_folder_name           { "" };                             // Used for External Images to belong to a category
+    int                         m_tile_size             { 0 };                              // Tile size image was outlined with, 0 if not tiled
+    vtr<DrPoint>                m_object_seeds;                                             // First pixel (column order) of each object in m_poly_list
+    vtr<unsigned char>          m_visited;                                                  // Scratch for updateRegion(), one byte per pixel, kept all zero
+
+    void                initialize(float lod, bool outline);
+    bool                addObjectOutline(DrBitmap &image, DrRect &rect, const DrPoint &seed, float lod);
+    void                addTracedObject(vtr<DrPointF> &one_poly, vtr<vtr<DrPointF>> &hole_list, DrRect &rect, const DrPoint &seed,
+                                        float lod, bool boxed);
 
 
 public:
-    // Constructors
-    DrImage(std::string image_name, DrBitmap &bitmap, float lod = 0.25, bool outline = true);
+    // Constructors, a view is outlined in place (in tiles with a tile_size above 0) and its pixels are only copied into
+    // the image with keep_pixels, for updateRegion(). Otherwise getBitmap() only has a size. A moved in bitmap is kept
+    DrImage(std::string image_name, const DrBitmapView &bitmap, float lod = 0.25, bool outline = true, int tile_size = 0,
+            bool keep_pixels = false);
+    DrImage(std::string image_name, DrBitmap &&bitmap, float lod = 0.25, bool outline = true);
 
     // Settings
     std::string         getName()   { return m_simple_name; }
 
     // Image Helper Functions
     void                outlinePoints(float lod);
+    void                outlinePoints(const DrBitmapView &bitmap, float lod);
+    void                outlinePointsTiled(const DrBitmapView &bitmap, float lod, int tile_size);
+    vtr<int>            updateRegion(const DrBitmapView &bitmap, DrRect dirty, float lod);
     bool                outlineCanceled()                   { return m_outline_canceled; }
     bool                outlineProcessed()                  { return m_outline_processed; }
     void                setSimpleBox();
@@ -11,6 +11,7 @@
 //      https://www.geeksforgeeks.org/how-to-check-if-a-given-point-lies-inside-a-polygon/
 //
 //
+#include <algorithm>
 #include <math.h>
 
 #include "../compare.h"
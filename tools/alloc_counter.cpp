@@ -0,0 +1,32 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+#include <cstdlib>
+#include <new>
+
+#include "alloc_counter.h"
+
+std::atomic<size_t> g_allocations   { 0 };
+std::atomic<size_t> g_allocated     { 0 };
+
+
+//####################################################################################
+//##    Allocation Counting
+//##        Kept in its own translation unit, so callers never see new / delete inlined down to malloc / free
+//####################################################################################
+void* operator new(size_t size) {
+    g_allocations++;
+    g_allocated += size;
+    void *ptr = malloc((size > 0) ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](size_t size)                           { return operator new(size); }
+void  operator delete(void *ptr) noexcept                   { free(ptr); }
+void  operator delete[](void *ptr) noexcept                 { free(ptr); }
@@ -0,0 +1,25 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Allocation counters shared by tools, linking alloc_counter.cpp into a tool replaces global operator new /
+//      delete with counting versions
+//
+#ifndef TOOLS_ALLOC_COUNTER_H
+#define TOOLS_ALLOC_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+
+// Updated by every operator new (containers, mesh optimizer), stb image uses malloc and isn't counted
+extern std::atomic<size_t> g_allocations;                   // Number of allocations
+extern std::atomic<size_t> g_allocated;                     // Bytes allocated
+
+
+#endif // TOOLS_ALLOC_COUNTER_H
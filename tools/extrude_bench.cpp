@@ -0,0 +1,703 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Benchmark of extrusion pipeline stages, timings (min / median / p99), allocations and output sizes of each
+//      stage are written as JSON so runs can be compared
+//
+//  Usage:
+//      extrude_bench [-r repeats] [-o results.json] [-i image ...] [--no-synthetic]
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/3rd_party/polyline_simplification.h"
+#include "../src/3rd_party/stb/stb_image.h"
+#include "../src/compare.h"
+#include "../src/imaging.h"
+#include "../src/mesh.h"
+#include "../src/types/bitmap.h"
+#include "../src/types/bitmap_view.h"
+#include "../src/types/color.h"
+#include "../src/types/image.h"
+#include "../src/types/rect.h"
+#include "alloc_counter.h"
+
+#if !defined(EXTRUDE_ASSET_DIR)
+    #define EXTRUDE_ASSET_DIR "assets"
+#endif
+
+// Local Constants
+const int   c_default_repeats =     15;             // Runs of each stage, p99 is nearest rank so it is the slowest run below 100 runs
+const int   c_quality_count =       9;              // Quality levels, same as quality keys 1 - 9 of example
+const int   c_smooth_neighbors =    5;              // Same smoothing DrImage::outlinePoints() uses
+const int   c_tile_size =           512;            // Tile size of tiled stages, same as extrude_cli default
+const float c_outline_details[c_quality_count] = { 19.2f, 9.6f, 4.8f, 2.4f, 1.2f, 0.6f, 0.3f, 0.15f, 0.075f };   // RDP epsilon per quality
+
+const int    c_scaling_repeats =    7;              // Runs of each stage per size in scaling mode, fastest is used (least disturbed)
+const double c_scaling_budget_ms =  5000.0;         // Repeats stop once runs add up to this, larger sizes are skipped once one run does
+const double c_scaling_floor_ms =   0.05;           // Timings below this are timer noise and left out of the fit
+const double c_superlinear_slope =  1.25;           // Fitted log-log slope above this is flagged (n log n fits to about 1.1), when
+const int    c_superlinear_pairs =  2;              //      slopes between this many of the largest neighbouring sizes are above it too
+
+
+//####################################################################################
+//##    Results
+//############################
+struct StageResult {
+    std::string                                     name;
+    double                                          min_ms          { 0.0 };
+    double                                          median_ms       { 0.0 };
+    double                                          p99_ms          { 0.0 };
+    size_t                                          allocations     { 0 };          // Per run
+    size_t                                          allocated_bytes { 0 };          // Per run
+    std::vector<std::pair<std::string, size_t>>     outputs;                        // Output sizes, i.e. { "triangles", 1200 }
+};
+
+struct QualityResult {
+    int                         quality         { 0 };
+    float                       outline_detail  { 0.f };
+    std::vector<StageResult>    stages;
+};
+
+struct ImageResult {
+    std::string                 name;
+    int                         width           { 0 };
+    int                         height          { 0 };
+    std::vector<StageResult>    stages;                                             // Stages that don't depend on quality
+    std::vector<QualityResult>  qualities;
+};
+
+
+//####################################################################################
+//##    Timing
+//##        Runs 'stage' repeats times, allocations are counted over the last run (stages are deterministic)
+//####################################################################################
+static StageResult timeStage(const std::string &name, int repeats, const std::function<void()> &stage) {
+    StageResult result;
+    result.name = name;
+    std::vector<double> times;
+    for (int r = 0; r < repeats; r++) {
+        size_t allocations = g_allocations;
+        size_t allocated =   g_allocated;
+        auto start = std::chrono::steady_clock::now();
+        stage();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        result.allocations =     g_allocations - allocations;
+        result.allocated_bytes = g_allocated - allocated;
+    }
+    std::sort(times.begin(), times.end());
+    size_t p99 = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(times.size()))) - 1;
+    result.min_ms =     times.front();
+    result.median_ms =  (times.size() % 2 == 1) ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) * 0.5;
+    result.p99_ms =     times[Dr::Min(p99, times.size() - 1)];
+    return result;
+}
+
+
+//####################################################################################
+//##    Inputs
+//####################################################################################
+// Copies bitmap into power of 2 square, same as example
+static bool loadImage(const std::string &path, DrBitmap &bitmap) {
+    int width, height, channels;
+    stbi_uc *pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (pixels == nullptr) return false;
+    bitmap = DrBitmap(DrBitmapView(pixels, width, height));
+    stbi_image_free(pixels);
+    return true;
+}
+
+// Deterministic synthetic image, grid of wobbly discs, every other one with a hole
+static DrBitmap syntheticImage(int size, int cells) {
+    DrBitmap bitmap(size, size);
+    unsigned int seed = 12345;
+    auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return static_cast<float>(seed >> 8) / 16777216.f; };
+
+    float cell = static_cast<float>(size) / static_cast<float>(cells);
+    for (int cy = 0; cy < cells; cy++) {
+        for (int cx = 0; cx < cells; cx++) {
+            float center_x = (cx + 0.5f) * cell, center_y = (cy + 0.5f) * cell;
+            float radius =   cell * (0.25f + 0.15f * random());
+            float wobble =   radius * 0.2f * random();
+            float lobes =    static_cast<float>(3 + static_cast<int>(random() * 5.f));
+            bool  hole =     ((cx + cy) % 2 == 0);
+            for (int y = static_cast<int>(cy * cell); y < static_cast<int>((cy + 1) * cell); y++) {
+                for (int x = static_cast<int>(cx * cell); x < static_cast<int>((cx + 1) * cell); x++) {
+                    float dx = x - center_x, dy = y - center_y;
+                    float distance = std::sqrt(dx*dx + dy*dy);
+                    float edge = radius + wobble * std::sin(lobes * std::atan2(dy, dx));
+                    if (distance < edge && (hole == false || distance > edge * 0.4f)) bitmap.setPixel(x, y, Dr::white);
+                }
+            }
+        }
+    }
+    return bitmap;
+}
+
+
+//####################################################################################
+//##    Runs all stages for one image
+//####################################################################################
+static ImageResult benchImage(const std::string &name, DrBitmap &bitmap, int repeats) {
+    ImageResult image_result;
+    image_result.name =     name;
+    image_result.width =    bitmap.width;
+    image_result.height =   bitmap.height;
+    printf("%s (%dx%d)\n", name.c_str(), bitmap.width, bitmap.height);
+
+    // ***** Stages that don't depend on quality
+    DrBitmap black_and_white;
+    StageResult stage = timeStage("BlackAndWhiteFromAlpha", repeats, [&]() {
+        black_and_white = Dr::BlackAndWhiteFromAlpha(bitmap, c_alpha_tolerance, false);
+    });
+    stage.outputs.push_back({ "pixels", static_cast<size_t>(black_and_white.width * black_and_white.height) });
+    image_result.stages.push_back(stage);
+
+    std::vector<DrBitmap> objects;
+    std::vector<DrRect>   rects;
+    stage = timeStage("FindObjectsInBitmap", repeats, [&]() {
+        objects.clear();
+        rects.clear();
+        Dr::FindObjectsInBitmap(bitmap, objects, rects, c_alpha_tolerance, true);
+    });
+    stage.outputs.push_back({ "objects", objects.size() });
+    image_result.stages.push_back(stage);
+
+    std::vector<std::vector<DrPointF>> outlines;
+    stage = timeStage("TraceImageOutline", repeats, [&]() {
+        outlines.clear();
+        for (const auto &object : objects) {
+            if (object.width > 0 && object.height > 0) outlines.push_back(Dr::TraceImageOutline(object));
+        }
+    });
+    size_t outline_points = 0;
+    for (const auto &outline : outlines) outline_points += outline.size();
+    stage.outputs.push_back({ "points", outline_points });
+    image_result.stages.push_back(stage);
+
+    std::vector<std::vector<DrPointF>> smoothed;
+    stage = timeStage("smoothPoints", repeats, [&]() {
+        smoothed.clear();
+        for (const auto &outline : outlines) {
+            smoothed.push_back((outline.size() > c_smooth_neighbors * 2) ? DrMesh::smoothPoints(outline, c_smooth_neighbors, 20.0, 1.0) : outline);
+        }
+    });
+    size_t smoothed_points = 0;
+    for (const auto &outline : smoothed) smoothed_points += outline.size();
+    stage.outputs.push_back({ "points", smoothed_points });
+    image_result.stages.push_back(stage);
+
+    // ***** Stages at each quality
+    float image_size = static_cast<float>(Dr::Max(bitmap.width, bitmap.height));
+    for (int q = 0; q < c_quality_count; q++) {
+        QualityResult quality_result;
+        quality_result.quality =        q + 1;
+        quality_result.outline_detail = c_outline_details[q];
+
+        std::vector<std::vector<DrPointF>> simplified;
+        stage = timeStage("RamerDouglasPeucker", repeats, [&]() {
+            simplified.clear();
+            for (const auto &outline : smoothed) simplified.push_back(PolylineSimplification::RamerDouglasPeucker(outline, c_outline_details[q]));
+        });
+        size_t simplified_points = 0;
+        for (const auto &outline : simplified) simplified_points += outline.size();
+        stage.outputs.push_back({ "points", simplified_points });
+        quality_result.stages.push_back(stage);
+
+        // Outlines and holes as the example gets them
+        DrImage image("bench", bitmap, c_outline_details[q]);
+        double alpha_tolerance = (image.m_outline_processed) ? c_alpha_tolerance : 0.0;
+
+        const std::pair<Trianglulation, const char*> modes[] = {
+            { Trianglulation::Ear_Clipping,     "triangulateFace/Ear_Clipping" },
+            { Trianglulation::Triangulate_Opt,  "triangulateFace/Triangulate_Opt" },
+            { Trianglulation::Monotone,         "triangulateFace/Monotone" },
+        };
+        std::vector<DrMesh> faces;
+        for (const auto &mode : modes) {
+            stage = timeStage(mode.second, repeats, [&]() {
+                faces.assign(image.m_poly_list.size(), DrMesh());
+                for (size_t p = 0; p < image.m_poly_list.size(); p++) {
+                    faces[p].triangulateFace(image.m_poly_list[p], image.m_hole_list[p], image.getBitmap(), mode.first, alpha_tolerance, image_size);
+                }
+            });
+            size_t triangles = 0;
+            for (const auto &face : faces) triangles += face.vertices.size() / 3;
+            stage.outputs.push_back({ "triangles", triangles });
+            quality_result.stages.push_back(stage);
+        }
+
+        // Walls are added to Triangulate_Opt faces, same as extrudeObjectFromPolygon()
+        faces.assign(image.m_poly_list.size(), DrMesh());
+        for (size_t p = 0; p < image.m_poly_list.size(); p++) {
+            faces[p].triangulateFace(image.m_poly_list[p], image.m_hole_list[p], image.getBitmap(), Trianglulation::Triangulate_Opt, alpha_tolerance, image_size);
+        }
+        std::vector<float> depths, offsets;
+        DrMesh::profileSlices(Side_Profile::Flat, 0.f, c_extrude_depth * image_size, 1.f, depths, offsets);
+
+        std::vector<DrMesh> meshes;
+        stage = timeStage("extrudeFacePolygon", repeats, [&]() {
+            meshes = faces;
+            for (size_t p = 0; p < meshes.size(); p++) {
+                meshes[p].extrudeFacePolygon(image.m_poly_list[p], image.getBitmap().width, image.getBitmap().height, depths, offsets, false);
+                for (const auto &hole : image.m_hole_list[p]) {
+                    meshes[p].extrudeFacePolygon(hole, image.getBitmap().width, image.getBitmap().height, depths, offsets, false);
+                }
+            }
+        });
+        size_t triangles = 0;
+        for (const auto &mesh : meshes) triangles += mesh.vertices.size() / 3;
+        stage.outputs.push_back({ "triangles", triangles });
+        quality_result.stages.push_back(stage);
+
+        std::vector<DrMesh> optimized;
+        stage = timeStage("optimizeMesh", repeats, [&]() {
+            optimized = meshes;
+            for (auto &mesh : optimized) mesh.optimizeMesh();
+        });
+        size_t vertices = 0, indices = 0;
+        for (const auto &mesh : optimized) { vertices += mesh.vertices.size(); indices += mesh.indices.size(); }
+        stage.outputs.push_back({ "vertices", vertices });
+        stage.outputs.push_back({ "triangles", indices / 3 });
+        stage.outputs.push_back({ "bytes", vertices * sizeof(Vertex) + indices * sizeof(unsigned int) });
+        quality_result.stages.push_back(stage);
+
+        image_result.qualities.push_back(quality_result);
+    }
+    return image_result;
+}
+
+
+//####################################################################################
+//##    Scaling
+//##        Runs stages over stress bitmaps of growing size, fits log(time) against log(input size) per stage.
+//##        Slope is about 1 for linear stages, 2 for quadratic and 3 for cubic. A linear stage can jump between two
+//##        sizes once its working set falls out of a cache level, so a stage is only flagged when slopes between the
+//##        largest neighbouring sizes are high as well, not just the fit over all of them. Slope a plain linear pass
+//##        over the bitmap (c_reference_stage) shows above 1 is what caches add, it is taken off every stage.
+//############################
+const char  *c_reference_stage =    "linear reference";
+const int    c_reference_passes =   16;             // Passes per run, so even the smallest size is above c_scaling_floor_ms
+
+struct ScalingPoint {
+    int                         size            { 0 };                              // Bitmap width / height
+    size_t                      n               { 0 };                              // Input size of stage (pixels, points, triangles, ...)
+    double                      min_ms          { 0.0 };
+};
+
+struct ScalingStage {
+    std::string                 name;
+    std::string                 units;                                              // What n counts
+    std::vector<ScalingPoint>   points;
+    double                      slope           { 0.0 };
+    double                      pair_slope      { 0.0 };                            // Lowest slope between c_superlinear_pairs largest neighbouring sizes
+    double                      cache_slope     { 0.0 };                            // Taken off slopes, c_reference_stage slope above 1
+    bool                        fitted          { false };                          // Needs at least three points above c_scaling_floor_ms
+    bool                        super_linear    { false };
+    bool                        over_budget     { false };
+};
+
+struct ScalingResult {
+    std::string                 pattern;
+    std::vector<ScalingStage>   stages;
+};
+
+// Least squares slope of log(min_ms) over log(n), and lowest slope between largest neighbouring points, both less cache_slope
+static void fitSlope(ScalingStage &stage, double cache_slope) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    double last_x = 0.0, last_y = 0.0;
+    std::vector<double> pair_slopes;
+    int count = 0;
+    for (const auto &point : stage.points) {
+        if (point.n < 2 || point.min_ms < c_scaling_floor_ms) continue;
+        double x = std::log(static_cast<double>(point.n)), y = std::log(point.min_ms);
+        sx += x;    sy += y;    sxx += x*x;     sxy += x*y;
+        if (count > 0 && x > last_x) pair_slopes.push_back((y - last_y) / (x - last_x));
+        last_x = x;     last_y = y;
+        count++;
+    }
+    double denominator = count * sxx - sx * sx;
+    if (count < 3 || static_cast<int>(pair_slopes.size()) < c_superlinear_pairs || denominator <= 0.0) return;
+    stage.cache_slope =     cache_slope;
+    stage.slope =           (count * sxy - sx * sy) / denominator - cache_slope;
+    stage.pair_slope =      *std::min_element(pair_slopes.end() - c_superlinear_pairs, pair_slopes.end()) - cache_slope;
+    stage.fitted =          true;
+    stage.super_linear =    (stage.slope > c_superlinear_slope && stage.pair_slope > c_superlinear_slope);
+}
+
+class ScalingRun
+{
+private:
+    std::vector<ScalingStage>   m_stages;
+
+public:
+    // Times stage at this size unless it went over budget at a smaller size, returns false if skipped.
+    // Setup (copies of inputs the stage changes) runs before each repeat and isn't timed
+    bool run(const std::string &name, const std::string &units, int size, size_t n, const std::function<void()> &stage) {
+        return run(name, units, size, n, nullptr, stage);
+    }
+    bool run(const std::string &name, const std::string &units, int size, size_t n, const std::function<void()> &setup,
+             const std::function<void()> &stage) {
+        ScalingStage *found = nullptr;
+        for (auto &existing : m_stages) if (existing.name == name) found = &existing;
+        if (found == nullptr) {
+            m_stages.push_back(ScalingStage());
+            found = &m_stages.back();
+            found->name =   name;
+            found->units =  units;
+        }
+        if (found->over_budget) return false;
+
+        std::vector<double> times;
+        double total_ms = 0.0;
+        for (int r = 0; r < c_scaling_repeats && total_ms < c_scaling_budget_ms; r++) {
+            if (setup) setup();
+            auto start = std::chrono::steady_clock::now();
+            stage();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            total_ms += times.back();
+        }
+        std::sort(times.begin(), times.end());
+        ScalingPoint point;
+        point.size =        size;
+        point.n =           n;
+        point.min_ms =      times.front();
+        found->points.push_back(point);
+        found->over_budget = (times.front() > c_scaling_budget_ms);
+        return true;
+    }
+
+    bool overBudget(const std::string &name) const {
+        for (const auto &stage : m_stages) if (stage.name == name) return stage.over_budget;
+        return false;
+    }
+
+    std::vector<ScalingStage> finish() {
+        double cache_slope = 0.0;
+        for (auto &stage : m_stages) {
+            if (stage.name != c_reference_stage) continue;
+            fitSlope(stage, 0.0);
+            if (stage.fitted) cache_slope = Dr::Max(stage.slope - 1.0, 0.0);
+        }
+        for (auto &stage : m_stages) if (stage.name != c_reference_stage) fitSlope(stage, cache_slope);
+        return m_stages;
+    }
+};
+
+static size_t countPoints(const std::vector<std::vector<DrPointF>> &outlines) {
+    size_t points = 0;
+    for (const auto &outline : outlines) points += outline.size();
+    return points;
+}
+
+static ScalingResult scalePattern(Stress_Pattern pattern, const std::string &name, const std::vector<int> &sizes) {
+    ScalingResult result;
+    result.pattern = name;
+    ScalingRun scaling;
+    printf("%s", name.c_str());
+
+    for (int size : sizes) {
+        printf(" %d", size);
+        fflush(stdout);
+        DrBitmap bitmap = Dr::GenerateStressBitmap(pattern, size);
+        size_t pixels = static_cast<size_t>(size) * static_cast<size_t>(size);
+
+        // ***** Reference, alpha of every pixel read into a one byte mask like the lighter image stages do
+        std::vector<unsigned char> mask(pixels);
+        scaling.run(c_reference_stage, "pixels", size, pixels, [&]() {
+            for (int pass = 0; pass < c_reference_passes; pass++) {
+                for (size_t p = 0; p < pixels; p++) mask[p] = (bitmap.data[p * 4 + 3] > pass) ? 255 : 0;
+            }
+        });
+
+        // ***** Image stages
+        DrBitmap black_and_white;
+        scaling.run("BlackAndWhiteFromAlpha", "pixels", size, pixels, [&]() {
+            black_and_white = Dr::BlackAndWhiteFromAlpha(bitmap, c_alpha_tolerance, false);
+        });
+        DrBitmap border;
+        scaling.run("FillBorder", "pixels", size, pixels, [&]() {
+            border = black_and_white;
+        }, [&]() {
+            Dr::FillBorder(border, Dr::white, border.rect());
+        });
+
+        scaling.run("FindObjectBoundsTiled", "pixels", size, pixels, [&]() {
+            Dr::FindObjectBoundsTiled(bitmap, c_alpha_tolerance, c_tile_size);
+        });
+
+        std::vector<DrBitmap> objects;
+        std::vector<DrRect>   rects;
+        if (scaling.run("FindObjectsInBitmap", "pixels", size, pixels, [&]() {
+            objects.clear();
+            rects.clear();
+            Dr::FindObjectsInBitmap(bitmap, objects, rects, c_alpha_tolerance, true);
+        }) == false) break;
+
+        std::vector<std::vector<DrPointF>> outlines;
+        scaling.run("TraceImageOutline", "pixels", size, pixels, [&]() {
+            outlines.clear();
+            for (const auto &object : objects) {
+                if (object.width > 0 && object.height > 0) outlines.push_back(Dr::TraceImageOutline(object));
+            }
+        });
+
+        std::vector<std::vector<DrPointF>> smoothed;
+        scaling.run("smoothPoints", "points", size, countPoints(outlines), [&]() {
+            smoothed.clear();
+            for (const auto &outline : outlines) {
+                smoothed.push_back((outline.size() > c_smooth_neighbors * 2) ? DrMesh::smoothPoints(outline, c_smooth_neighbors, 20.0, 1.0) : outline);
+            }
+        });
+        scaling.run("RamerDouglasPeucker", "points", size, countPoints(smoothed), [&]() {
+            for (const auto &outline : smoothed) PolylineSimplification::RamerDouglasPeucker(outline, c_outline_details[c_quality_count - 1]);
+        });
+
+        // ***** Whole outline (includes holes), polygons are used by the mesh stages
+        std::unique_ptr<DrImage> image;
+        if (scaling.run("DrImage::outlinePoints", "pixels", size, pixels, [&]() {
+            image.reset(new DrImage(name, bitmap, c_outline_details[c_quality_count - 1]));
+        }) == false) break;
+        size_t polygon_points = countPoints(image->m_poly_list);
+        for (const auto &holes : image->m_hole_list) polygon_points += countPoints(holes);
+        double alpha_tolerance = (image->m_outline_processed) ? c_alpha_tolerance : 0.0;
+        float  image_size = static_cast<float>(size);
+
+        // ***** Mesh stages
+        const std::pair<Trianglulation, const char*> modes[] = {
+            { Trianglulation::Ear_Clipping,     "triangulateFace/Ear_Clipping" },
+            { Trianglulation::Triangulate_Opt,  "triangulateFace/Triangulate_Opt" },
+            { Trianglulation::Monotone,         "triangulateFace/Monotone" },
+        };
+        DrMesh face_mesh;
+        for (const auto &mode : modes) {
+            DrMesh faces;
+            bool ran = scaling.run(mode.second, "points", size, polygon_points, [&]() {
+                faces = DrMesh();
+                for (size_t p = 0; p < image->m_poly_list.size(); p++) {
+                    faces.triangulateFace(image->m_poly_list[p], image->m_hole_list[p], image->getBitmap(), mode.first, alpha_tolerance, image_size);
+                }
+            });
+            if (ran && faces.vertices.size() > face_mesh.vertices.size()) face_mesh = faces;
+        }
+
+        std::vector<float> depths, offsets;
+        DrMesh::profileSlices(Side_Profile::Flat, 0.f, c_extrude_depth * image_size, 1.f, depths, offsets);
+        DrMesh mesh;
+        scaling.run("extrudeFacePolygon", "points", size, polygon_points, [&]() {
+            mesh = face_mesh;
+        }, [&]() {
+            for (size_t p = 0; p < image->m_poly_list.size(); p++) {
+                mesh.extrudeFacePolygon(image->m_poly_list[p], size, size, depths, offsets, false);
+                for (const auto &hole : image->m_hole_list[p]) mesh.extrudeFacePolygon(hole, size, size, depths, offsets, false);
+            }
+        });
+        if (mesh.vertices.size() < 3) continue;
+
+        DrMesh optimized;
+        scaling.run("optimizeMesh", "triangles", size, mesh.vertices.size() / 3, [&]() {
+            optimized = mesh;
+        }, [&]() {
+            optimized.optimizeMesh();
+        });
+        DrMesh smoothed_mesh;
+        scaling.run("smoothMesh", "vertices", size, optimized.vertices.size(), [&]() {
+            smoothed_mesh = optimized;
+        }, [&]() {
+            smoothed_mesh.smoothMesh();
+        });
+    }
+    printf("\n");
+    result.stages = scaling.finish();
+    return result;
+}
+
+static void printScaling(const std::vector<ScalingResult> &results) {
+    for (const auto &result : results) {
+        printf("\n%s\n", result.pattern.c_str());
+        for (const auto &stage : result.stages) {
+            printf("    %-34s", stage.name.c_str());
+            if (stage.fitted) printf(" slope %5.2f (largest pairs >= %5.2f) %-12s", stage.slope, stage.pair_slope, stage.super_linear ? "SUPER-LINEAR" : "");
+            else              printf(" slope   n/a                         %-12s", "");
+            for (const auto &point : stage.points) printf("  %zu %s %.2f ms", point.n, stage.units.c_str(), point.min_ms);
+            if (stage.over_budget) printf("  (over budget)");
+            printf("\n");
+        }
+    }
+}
+
+static bool writeScalingJson(const std::string &path, const std::vector<ScalingResult> &results) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    fprintf(file, "{\n  \"benchmark\": \"extrude_bench\",\n  \"version\": 2,\n  \"mode\": \"scaling\",\n  \"repeats\": %d,\n"
+                  "  \"superlinear_slope\": %.2f,\n  \"superlinear_pairs\": %d,\n  \"patterns\": [\n", c_scaling_repeats, c_superlinear_slope, c_superlinear_pairs);
+    for (size_t r = 0; r < results.size(); r++) {
+        const ScalingResult &result = results[r];
+        fprintf(file, "    {\n      \"pattern\": \"%s\",\n      \"stages\": [\n", result.pattern.c_str());
+        for (size_t s = 0; s < result.stages.size(); s++) {
+            const ScalingStage &stage = result.stages[s];
+            fprintf(file, "        { \"name\": \"%s\", \"units\": \"%s\", ", stage.name.c_str(), stage.units.c_str());
+            if (stage.fitted) fprintf(file, "\"slope\": %.4f, \"pair_slope\": %.4f, ", stage.slope, stage.pair_slope);
+            else              fprintf(file, "\"slope\": null, \"pair_slope\": null, ");
+            fprintf(file, "\"cache_slope\": %.4f, ", stage.cache_slope);
+            fprintf(file, "\"super_linear\": %s, \"over_budget\": %s, \"points\": [",
+                    stage.super_linear ? "true" : "false", stage.over_budget ? "true" : "false");
+            for (size_t p = 0; p < stage.points.size(); p++) {
+                const ScalingPoint &point = stage.points[p];
+                fprintf(file, "%s { \"size\": %d, \"n\": %zu, \"min_ms\": %.4f }", (p > 0) ? "," : "", point.size, point.n, point.min_ms);
+            }
+            fprintf(file, " ] }%s\n", (s + 1 < result.stages.size()) ? "," : "");
+        }
+        fprintf(file, "      ]\n    }%s\n", (r + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return (fclose(file) == 0);
+}
+
+
+//####################################################################################
+//##    Output
+//####################################################################################
+static void printStage(const StageResult &stage) {
+    printf("    %-34s min %9.3f  median %9.3f  p99 %9.3f ms  %8zu allocs %11zu bytes", stage.name.c_str(),
+           stage.min_ms, stage.median_ms, stage.p99_ms, stage.allocations, stage.allocated_bytes);
+    for (const auto &output : stage.outputs) printf("  %zu %s", output.second, output.first.c_str());
+    printf("\n");
+}
+
+static void writeStagesJson(FILE *file, const std::vector<StageResult> &stages, const char *indent) {
+    fprintf(file, "[\n");
+    for (size_t s = 0; s < stages.size(); s++) {
+        const StageResult &stage = stages[s];
+        fprintf(file, "%s  { \"name\": \"%s\", \"min_ms\": %.4f, \"median_ms\": %.4f, \"p99_ms\": %.4f, \"allocations\": %zu, \"allocated_bytes\": %zu, \"outputs\": {",
+                indent, stage.name.c_str(), stage.min_ms, stage.median_ms, stage.p99_ms, stage.allocations, stage.allocated_bytes);
+        for (size_t o = 0; o < stage.outputs.size(); o++) {
+            fprintf(file, "%s \"%s\": %zu", (o > 0) ? "," : "", stage.outputs[o].first.c_str(), stage.outputs[o].second);
+        }
+        fprintf(file, " } }%s\n", (s + 1 < stages.size()) ? "," : "");
+    }
+    fprintf(file, "%s]", indent);
+}
+
+static bool writeJson(const std::string &path, const std::vector<ImageResult> &results, int repeats) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    fprintf(file, "{\n  \"benchmark\": \"extrude_bench\",\n  \"version\": 1,\n  \"repeats\": %d,\n  \"images\": [\n", repeats);
+    for (size_t i = 0; i < results.size(); i++) {
+        const ImageResult &image = results[i];
+        fprintf(file, "    {\n      \"name\": \"%s\", \"width\": %d, \"height\": %d,\n      \"stages\": ", image.name.c_str(), image.width, image.height);
+        writeStagesJson(file, image.stages, "      ");
+        fprintf(file, ",\n      \"qualities\": [\n");
+        for (size_t q = 0; q < image.qualities.size(); q++) {
+            const QualityResult &quality = image.qualities[q];
+            fprintf(file, "        { \"quality\": %d, \"outline_detail\": %.3f, \"stages\": ", quality.quality, static_cast<double>(quality.outline_detail));
+            writeStagesJson(file, quality.stages, "          ");
+            fprintf(file, " }%s\n", (q + 1 < image.qualities.size()) ? "," : "");
+        }
+        fprintf(file, "      ]\n    }%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return (fclose(file) == 0);
+}
+
+
+//####################################################################################
+//##    Main
+//####################################################################################
+int main(int argc, char *argv[]) {
+    int         repeats =   c_default_repeats;
+    std::string output =    "extrude_bench.json";
+    bool        synthetic = true;
+    bool        scaling =   false;
+    std::vector<std::string> images;
+    std::vector<int>         sizes { 64, 128, 256, 512, 1024 };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if      (arg == "-r" && i + 1 < argc)   { repeats = Dr::Max(atoi(argv[++i]), 1); }
+        else if (arg == "-o" && i + 1 < argc)   { output =  argv[++i]; }
+        else if (arg == "-i" && i + 1 < argc)   { images.push_back(argv[++i]); }
+        else if (arg == "--no-synthetic")       { synthetic = false; }
+        else if (arg == "--scaling")            { scaling = true; }
+        else if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            for (const char *text = argv[++i]; *text != '\0'; ) {
+                char *end;
+                long size = strtol(text, &end, 10);
+                if (end == text) break;
+                if (size >= 8) sizes.push_back(static_cast<int>(size));
+                text = (*end == ',') ? end + 1 : end;
+            }
+        } else {
+            printf("Usage: extrude_bench [-r repeats] [-o results.json] [-i image ...] [--no-synthetic]\n"
+                   "       extrude_bench --scaling [--sizes 64,128,256,512,1024] [-o results.json]\n"
+                   "Defaults to assets/shapes.png, assets/craft.png and synthetic images, %d repeats\n"
+                   "Scaling mode times stages over growing stress bitmaps and flags stages with log-log slope above %.2f\n",
+                   c_default_repeats, c_superlinear_slope);
+            return (arg == "-h" || arg == "--help") ? 0 : 2;
+        }
+    }
+
+    // ***** Scaling mode
+    if (scaling) {
+        const std::pair<Stress_Pattern, const char*> patterns[] = {
+            { Stress_Pattern::Specks,       "Specks" },
+            { Stress_Pattern::Blob,         "Blob" },
+            { Stress_Pattern::Rings,        "Rings" },
+            { Stress_Pattern::Coastline,    "Coastline" },
+            { Stress_Pattern::Checkerboard, "Checkerboard" },
+            { Stress_Pattern::Noise,        "Noise" },
+        };
+        std::vector<ScalingResult> results;
+        for (const auto &pattern : patterns) results.push_back(scalePattern(pattern.first, pattern.second, sizes));
+        printScaling(results);
+        if (writeScalingJson(output, results) == false) { fprintf(stderr, "Could not write %s\n", output.c_str()); return 1; }
+        printf("\nResults written to %s\n", output.c_str());
+        return 0;
+    }
+    if (images.size() == 0) {
+        images.push_back(std::string(EXTRUDE_ASSET_DIR) + "/shapes.png");
+        images.push_back(std::string(EXTRUDE_ASSET_DIR) + "/craft.png");
+    }
+
+    std::vector<ImageResult> results;
+    for (const auto &path : images) {
+        DrBitmap bitmap;
+        if (loadImage(path, bitmap) == false) { fprintf(stderr, "Could not load %s\n", path.c_str()); return 1; }
+        results.push_back(benchImage(path.substr(path.find_last_of("/\\") + 1), bitmap, repeats));
+    }
+    if (synthetic) {
+        const std::pair<int, int> sizes[] = { { 256, 4 }, { 1024, 8 } };            // Image size, discs per row
+        for (const auto &size : sizes) {
+            DrBitmap bitmap = syntheticImage(size.first, size.second);
+            results.push_back(benchImage("synthetic_" + std::to_string(size.first), bitmap, repeats));
+        }
+    }
+
+    for (const auto &image : results) {
+        printf("\n%s\n", image.name.c_str());
+        for (const auto &stage : image.stages) printStage(stage);
+        for (const auto &quality : image.qualities) {
+            printf("  quality %d (outline detail %.3f)\n", quality.quality, static_cast<double>(quality.outline_detail));
+            for (const auto &stage : quality.stages) printStage(stage);
+        }
+    }
+
+    if (writeJson(output, results, repeats) == false) { fprintf(stderr, "Could not write %s\n", output.c_str()); return 1; }
+    printf("\nResults written to %s\n", output.c_str());
+    return 0;
+}
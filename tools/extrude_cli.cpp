@@ -0,0 +1,617 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Headless batch extrusion, images are decoded, outlined and extruded in a three stage pipeline and
+//      written as mesh files (.extm), one file per level of detail
+//
+//  Usage:
+//      extrude_cli [options] <image | directory | pattern> ...
+//
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+#endif
+
+#include "../src/budget.h"
+#include "../src/compare.h"
+#include "../src/extrude_cache.h"
+#include "../src/instrument.h"
+#include "../src/mesh.h"
+#include "../src/mesh_adjacency.h"
+#include "../src/types/bitmap.h"
+#include "../src/types/bitmap_view.h"
+#include "../src/types/color.h"
+#include "../src/types/image.h"
+
+// Local Constants
+const float c_outline_detail =      0.075f;         // Ramer-Douglas-Peucker epsilon used to outline image, same as example
+const int   c_extrude_quality =     8;              // Quality used to extrude meshes, highest quality
+const int   c_level_count =         9;              // Number of levels in level of detail chains
+const float c_profile_size =        0.02f;          // Outward size of bevel / round side profiles, relative to image size
+const int   c_queue_per_worker =    2;              // Items allowed to wait in front of each stage, per worker, bounds memory use
+const int   c_tile_threshold =      2048;           // Images wider / taller than this are outlined in tiles by default
+const int   c_tile_size =           512;            // Default tile size, in pixels
+const int   c_cache_megabytes =     512;            // Default size limit of cache directory
+
+const char *c_image_extensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd" };
+
+
+//####################################################################################
+//##    Options
+//############################
+struct Options {
+    std::vector<std::string>    inputs;
+    std::string                 output_dir      { "" };                     // Empty writes next to each image
+    int                         jobs            { 1 };                      // Workers per stage
+    int                         quality         { c_extrude_quality };
+    float                       depth           { 1.f };                    // Depth, relative to image size
+    int                         levels          { c_level_count };
+    float                       triangle_ratio  { 0.5f };
+    float                       target_error    { 0.05f };
+    bool                        allow_sloppy    { false };                  // Sloppy simplifier when levels stall, ignores creases
+    float                       outline_detail  { c_outline_detail };
+    Side_Profile                profile         { Side_Profile::Flat };
+    bool                        smooth_normals  { false };
+    bool                        quiet           { false };
+    std::string                 trace_path      { "" };                     // Chrome trace of all stages, needs EXTRUDE_INSTRUMENT
+    int                         tile_size       { -1 };                     // 0 never tiles, -1 tiles images over c_tile_threshold
+    std::string                 cache_dir       { "" };                     // Empty doesn't cache
+    int                         cache_mb        { c_cache_megabytes };
+    double                      budget_ms       { 0.0 };                    // Time cap per image (outline + mesh), 0 for none
+};
+
+//####################################################################################
+//##    Job, one image moving through the pipeline
+//############################
+struct Job {
+    size_t                      number          { 0 };                      // Position in file list
+    std::string                 path            { "" };
+    std::string                 error           { "" };                     // Set when a stage fails, later stages pass job through
+
+    int                         width           { 0 };
+    int                         height          { 0 };
+    std::unique_ptr<DrBitmap>   bitmap          { };
+    std::unique_ptr<DrImage>    image           { };
+    uint64_t                    cache_key       { 0 };
+    bool                        cached          { false };                  // Found in cache, outline / mesh stages only write files
+    DrCacheEntry                entry           { };                        // Outlines and mesh file data per level
+    std::unique_ptr<DrBudget>   budget          { };                        // Started with outline stage when options.budget_ms > 0
+
+    size_t                      objects         { 0 };
+    size_t                      level_count     { 0 };
+    size_t                      vertices        { 0 };                      // Level 0 totals
+    size_t                      triangles       { 0 };
+    size_t                      bytes           { 0 };                      // Total size of written files
+    size_t                      open_objects    { 0 };                      // Level 0 meshes with boundary edges (not watertight)
+    size_t                      non_manifold    { 0 };                      // Level 0 meshes with non-manifold edges / vertices
+
+    double                      decode_ms       { 0.0 };
+    double                      outline_ms      { 0.0 };
+    double                      mesh_ms         { 0.0 };
+    double                      write_ms        { 0.0 };
+};
+typedef std::unique_ptr<Job> JobPtr;
+
+
+//####################################################################################
+//##    BoundedQueue
+//##        Blocking queue between two pipeline stages, push() waits while the queue is full so a fast stage
+//##        can't run ahead of a slow one. pop() returns false once the queue is closed and empty.
+//############################
+template <class T>
+class BoundedQueue
+{
+private:
+    std::deque<T>               m_items;
+    size_t                      m_capacity;
+    size_t                      m_producers;                                // Queue closes when last producer calls producerDone()
+    std::mutex                  m_mutex;
+    std::condition_variable     m_not_empty;
+    std::condition_variable     m_not_full;
+
+public:
+    BoundedQueue(size_t capacity, size_t producers) : m_capacity(Dr::Max(capacity, static_cast<size_t>(1))), m_producers(producers) { }
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this] { return m_items.size() < m_capacity; });
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+    }
+
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return m_items.size() > 0 || m_producers == 0; });
+        if (m_items.size() == 0) return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    void producerDone() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_producers > 0) m_producers--;
+        if (m_producers == 0) m_not_empty.notify_all();
+    }
+};
+
+
+//####################################################################################
+//##    Helpers
+//####################################################################################
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string lowerCase(std::string text) {
+    for (auto &c : text) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+static bool isImageFile(const std::string &path) {
+    std::string lower = lowerCase(path);
+    for (const char *extension : c_image_extensions) {
+        size_t length = strlen(extension);
+        if (lower.size() > length && lower.compare(lower.size() - length, length, extension) == 0) return true;
+    }
+    return false;
+}
+
+// Simple wildcard match, '*' matches any run of characters, '?' matches one character
+static bool wildcardMatch(const char *pattern, const char *text) {
+    if (*pattern == '\0') return (*text == '\0');
+    if (*pattern == '*')  return wildcardMatch(pattern + 1, text) || (*text != '\0' && wildcardMatch(pattern, text + 1));
+    if (*text == '\0')    return false;
+    return (*pattern == '?' || *pattern == *text) && wildcardMatch(pattern + 1, text + 1);
+}
+
+static std::string fileName(const std::string &path) {
+    size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+static std::string directoryName(const std::string &path) {
+    size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? std::string(".") : path.substr(0, slash);
+}
+
+static std::string joinPath(const std::string &directory, const std::string &name) {
+    if (directory.size() == 0 || directory == ".") return name;
+    char last = directory[directory.size() - 1];
+    return (last == '/' || last == '\\') ? (directory + name) : (directory + "/" + name);
+}
+
+static bool isDirectory(const std::string &path) {
+#if defined(_WIN32)
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    return (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) && S_ISDIR(info.st_mode);
+#endif
+}
+
+// Names of files in directory (not recursive), sorted
+static std::vector<std::string> listDirectory(const std::string &directory) {
+    std::vector<std::string> names;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA found;
+    HANDLE handle = FindFirstFileA(joinPath(directory, "*").c_str(), &found);
+    if (handle == INVALID_HANDLE_VALUE) return names;
+    do {
+        if ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) names.push_back(found.cFileName);
+    } while (FindNextFileA(handle, &found));
+    FindClose(handle);
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) return names;
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == ".." || isDirectory(joinPath(directory, name))) continue;
+        names.push_back(name);
+    }
+    closedir(dir);
+#endif
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Expands directories and wildcard patterns (in file name part only) into list of image files
+static std::vector<std::string> expandInputs(const std::vector<std::string> &inputs) {
+    std::vector<std::string> files;
+    for (const auto &input : inputs) {
+        if (isDirectory(input)) {
+            for (const auto &name : listDirectory(input)) {
+                if (isImageFile(name)) files.push_back(joinPath(input, name));
+            }
+        } else if (input.find_first_of("*?") != std::string::npos) {
+            std::string directory = directoryName(input);
+            std::string pattern =   fileName(input);
+            size_t matched = 0;
+            for (const auto &name : listDirectory(directory)) {
+                if (wildcardMatch(pattern.c_str(), name.c_str())) { files.push_back(joinPath(directory, name)); matched++; }
+            }
+            if (matched == 0) fprintf(stderr, "No files match '%s'\n", input.c_str());
+        } else {
+            files.push_back(input);
+        }
+    }
+    return files;
+}
+
+// Output path for level of detail 'level' of image 'path', level 0 is "name.extm", others "name.lodN.extm"
+static std::string outputPath(const Options &options, const std::string &path, size_t level) {
+    std::string name = fileName(path);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos) name = name.substr(0, dot);
+    if (level > 0) name += ".lod" + std::to_string(level);
+    name += ".extm";
+    return joinPath((options.output_dir.size() > 0) ? options.output_dir : directoryName(path), name);
+}
+
+
+//####################################################################################
+//##    Pipeline Stages
+//####################################################################################
+// Loads image at its native size, same as example. Meshes don't use color, so only the alpha plane is decoded / kept
+static void decodeImage(Job &job) {
+    job.bitmap.reset(new DrBitmap());
+    job.bitmap->loadAlphaFromFile(job.path);
+    if (job.bitmap->width <= 0 || job.bitmap->height <= 0) {
+        job.bitmap.reset();
+        job.error = "could not decode image";
+        return;
+    }
+    job.width =  job.bitmap->width;
+    job.height = job.bitmap->height;
+}
+
+// Name of stage a budget ran out in
+static const char* stageName(Budget_Stage stage) {
+    switch (stage) {
+        case Budget_Stage::None:                return "none";
+        case Budget_Stage::Finding_Objects:     return "finding objects";
+        case Budget_Stage::Tracing:             return "tracing";
+        case Budget_Stage::Triangulating:       return "triangulating";
+    }
+    return "unknown";
+}
+
+// True when budget of job ran out and outlines / meshes hold fallbacks (boxes, monotone triangulation)
+static bool ranOutOfBudget(const Job &job) {
+    return job.budget && job.budget->expired_in != Budget_Stage::None;
+}
+
+// Every option that changes output files
+static DrExtrudeSettings extrudeSettings(const Options &options) {
+    DrExtrudeSettings settings;
+    settings.outline_detail =   options.outline_detail;
+    settings.quality =          options.quality;
+    settings.depth =            options.depth;
+    settings.profile =          options.profile;
+    settings.profile_size =     c_profile_size;
+    settings.smooth_normals =   options.smooth_normals;
+    settings.levels =           options.levels;
+    settings.triangle_ratio =   options.triangle_ratio;
+    settings.target_error =     options.target_error;
+    settings.allow_sloppy =     options.allow_sloppy;
+    return settings;
+}
+
+// On a hit the decoded pixels are dropped, later stages only write the cached mesh files
+static void findInCache(Job &job, const Options &options, DrExtrudeCache &cache) {
+    job.cache_key = DrExtrudeCache::key(DrBitmapView(*job.bitmap), extrudeSettings(options));
+    if (cache.load(job.cache_key, job.entry) == false) return;
+    job.cached = true;
+    job.bitmap.reset();
+}
+
+// Outlined straight from decoded pixels, large images in tiles (see DrImage::outlinePointsTiled()). Image keeps no
+// copy of the pixels, so they are freed before extrusion
+static void outlineImage(Job &job, const Options &options) {
+    int tile_size = options.tile_size;
+    if (tile_size < 0) tile_size = (Dr::Max(job.width, job.height) > c_tile_threshold) ? c_tile_size : 0;
+    job.image.reset(new DrImage(fileName(job.path), DrBitmapView(*job.bitmap), options.outline_detail, true, tile_size));
+    job.bitmap.reset();
+}
+
+// Side walls are nudged 1 / image size off caps, weld has to cover that on small images
+static float weldTolerance(const Job &job) {
+    return Dr::Max(c_adjacency_weld_tolerance, 1.5f / static_cast<float>(Dr::Max(Dr::Min(job.width, job.height), 1)));
+}
+
+// Extrudes every object, builds level of detail chains and encodes one mesh file per level.
+// Objects with shorter chains repeat their last level, so every file has the same objects.
+// Level 0 meshes are checked for watertightness (see DrMeshAdjacency) and counted in job.
+static void extrudeImage(Job &job, const Options &options) {
+    const DrBitmap &bitmap = job.image->getBitmap();
+    float image_size = static_cast<float>(Dr::Max(bitmap.width, bitmap.height));
+    DrMeshAdjacency adjacency;
+
+    std::vector<std::vector<DrMeshLevel>> chains;
+    for (int object = 0; object < static_cast<int>(job.image->m_poly_list.size()); object++) {
+        DrMesh mesh;
+        mesh.extrudeObjectFromPolygon(job.image.get(), object, options.quality, image_size * options.depth,
+                                      options.profile, image_size * c_profile_size);
+        if (options.smooth_normals) mesh.generateNormals();
+        if (mesh.indices.size() == 0) continue;
+        adjacency.build(mesh, weldTolerance(job));
+        if (adjacency.isClosed() == false)   job.open_objects++;
+        if (adjacency.isManifold() == false) job.non_manifold++;
+        chains.push_back(mesh.buildLevelsOfDetail(options.levels, options.triangle_ratio, options.target_error,
+                                                         options.allow_sloppy));
+        job.vertices +=  chains.back()[0].mesh.vertices.size();
+        job.triangles += chains.back()[0].triangleCount();
+        job.level_count = Dr::Max(job.level_count, chains.back().size());
+    }
+    job.entry.poly_list = std::move(job.image->m_poly_list);
+    job.entry.hole_list = std::move(job.image->m_hole_list);
+    job.image.reset();
+    job.objects = chains.size();
+    if (chains.size() == 0) { job.error = "no objects found"; return; }
+
+    for (size_t level = 0; level < job.level_count; level++) {
+        std::vector<DrMesh> meshes;
+        for (const auto &chain : chains) {
+            meshes.push_back(chain[Dr::Min(level, chain.size() - 1)].mesh);
+        }
+        job.entry.level_files.push_back(std::vector<unsigned char>());
+        DrMesh::encodeMeshes(meshes, job.entry.level_files.back());
+    }
+}
+
+static void writeMeshFiles(Job &job, const Options &options) {
+    job.level_count = job.entry.level_files.size();
+    for (size_t level = 0; level < job.entry.level_files.size(); level++) {
+        const std::vector<unsigned char> &file_data = job.entry.level_files[level];
+        std::string path = outputPath(options, job.path, level);
+        FILE *file = fopen(path.c_str(), "wb");
+        bool written = (file != nullptr) && (fwrite(file_data.data(), 1, file_data.size(), file) == file_data.size());
+        if (file) written = (fclose(file) == 0) && written;
+        if (written == false) { job.error = "could not write " + path; return; }
+        job.bytes += file_data.size();
+    }
+}
+
+
+//####################################################################################
+//##    Runs Pipeline
+//##        Decode -> Outline -> Mesh, each stage has options.jobs workers connected by bounded queues.
+//##        With a budget (-b), outline and mesh stages of each image share one DrBudget, counted from start of
+//##        outlining (so time waiting for a mesh worker counts too), images that run out are written with fallback
+//##        outlines / triangulation and are not cached. Returns number of files that failed.
+//####################################################################################
+static size_t runPipeline(const std::vector<std::string> &files, const Options &options) {
+    std::unique_ptr<DrExtrudeCache> cache;
+    if (options.cache_dir.size() > 0) cache.reset(new DrExtrudeCache(options.cache_dir, static_cast<uint64_t>(options.cache_mb) << 20));
+    size_t workers = static_cast<size_t>(options.jobs);
+    BoundedQueue<JobPtr> outline_queue(workers * c_queue_per_worker, workers);
+    BoundedQueue<JobPtr> mesh_queue(   workers * c_queue_per_worker, workers);
+    std::atomic<size_t>  next_file { 0 };
+    std::atomic<size_t>  failed    { 0 };
+    std::mutex           print_mutex;
+
+    auto decodeWorker = [&]() {
+        for (size_t f = next_file++; f < files.size(); f = next_file++) {
+            JobPtr job(new Job());
+            job->number = f;
+            job->path =   files[f];
+            auto start = std::chrono::steady_clock::now();
+            decodeImage(*job);
+            if (cache && job->error.size() == 0) findInCache(*job, options, *cache);
+            job->decode_ms = elapsedMs(start);
+            outline_queue.push(std::move(job));
+        }
+        outline_queue.producerDone();
+    };
+
+    auto outlineWorker = [&]() {
+        JobPtr job;
+        while (outline_queue.pop(job)) {
+            auto start = std::chrono::steady_clock::now();
+            if (options.budget_ms > 0.0) job->budget.reset(new DrBudget(options.budget_ms));
+            DrBudgetScope budget_scope(job->budget.get());
+            if (job->error.size() == 0 && job->cached == false) outlineImage(*job, options);
+            job->outline_ms = elapsedMs(start);
+            mesh_queue.push(std::move(job));
+        }
+        mesh_queue.producerDone();
+    };
+
+    auto meshWorker = [&]() {
+        JobPtr job;
+        while (mesh_queue.pop(job)) {
+            auto start = std::chrono::steady_clock::now();
+            {
+                DrBudgetScope budget_scope(job->budget.get());
+                if (job->error.size() == 0 && job->cached == false) extrudeImage(*job, options);
+            }
+            job->mesh_ms = elapsedMs(start);
+            start = std::chrono::steady_clock::now();
+            if (job->error.size() == 0) writeMeshFiles(*job, options);
+            if (job->error.size() == 0 && job->cached == false && cache && ranOutOfBudget(*job) == false) cache->store(job->cache_key, job->entry);
+            job->write_ms = elapsedMs(start);
+
+            std::lock_guard<std::mutex> lock(print_mutex);
+            if (job->error.size() > 0) {
+                failed++;
+                fprintf(stderr, "[%zu/%zu] %s: %s\n", job->number + 1, files.size(), job->path.c_str(), job->error.c_str());
+            } else if (options.quiet == false && job->cached) {
+                printf("[%zu/%zu] %s  %dx%d  cached  %zu levels  %zu bytes  decode %.1f ms  write %.1f ms\n",
+                       job->number + 1, files.size(), job->path.c_str(), job->width, job->height, job->level_count, job->bytes,
+                       job->decode_ms, job->write_ms);
+                fflush(stdout);
+            } else if (options.quiet == false) {
+                printf("[%zu/%zu] %s  %dx%d  %zu objects  %zu levels  %zu vertices  %zu triangles  %zu bytes  "
+                       "decode %.1f ms  outline %.1f ms  mesh %.1f ms  write %.1f ms\n",
+                       job->number + 1, files.size(), job->path.c_str(), job->width, job->height, job->objects, job->level_count,
+                       job->vertices, job->triangles, job->bytes, job->decode_ms, job->outline_ms, job->mesh_ms, job->write_ms);
+                if (job->open_objects > 0 || job->non_manifold > 0) {
+                    printf("    %zu of %zu objects not watertight, %zu non-manifold\n", job->open_objects, job->objects, job->non_manifold);
+                }
+                if (ranOutOfBudget(*job)) {
+                    const DrBudget &budget = *job->budget;
+                    printf("    budget of %.1f ms ran out while %s: %d of %d objects traced, %d boxed, %d of %d faces triangulated, "
+                           "%d monotone\n", options.budget_ms, stageName(budget.expired_in), budget.objects_traced, budget.objects_found,
+                           budget.objects_boxed, budget.faces_triangulated, budget.faces_triangulated + budget.faces_fallback,
+                           budget.faces_fallback);
+                }
+                fflush(stdout);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers; w++) threads.push_back(std::thread(decodeWorker));
+    for (size_t w = 0; w < workers; w++) threads.push_back(std::thread(outlineWorker));
+    for (size_t w = 0; w < workers; w++) threads.push_back(std::thread(meshWorker));
+    for (auto &thread : threads) thread.join();
+    return failed;
+}
+
+
+//####################################################################################
+//##    Command Line
+//####################################################################################
+static void printUsage() {
+    printf("Usage: extrude_cli [options] <image | directory | pattern> ...\n"
+           "\n"
+           "Extrudes images into mesh files (.extm). Level 0 is written as name.extm, further levels of detail as\n"
+           "name.lodN.extm. Directories are searched for images (not recursive), patterns may use * and ? in the file name.\n"
+           "\n"
+           "Options:\n"
+           "  -o <dir>       Output directory (default: next to each image)\n"
+           "  -j <n>         Workers per pipeline stage (decode, outline, mesh), default 1\n"
+           "  -q <n>         Extrusion quality, default %d\n"
+           "  -d <depth>     Depth relative to image size, default 1.0\n"
+           "  -l <n>         Levels of detail to write, default %d\n"
+           "  -r <ratio>     Triangle ratio between levels of detail, default 0.5\n"
+           "  -e <error>     Target simplification error, relative to mesh extents, default 0.05\n"
+           "  -t <detail>    Outline detail (Ramer-Douglas-Peucker epsilon), default %.3f\n"
+           "  -p <profile>   Side profile: flat, bevel or round, default flat\n"
+           "  -g <size>      Outline in tiles of size pixels, 0 never tiles, default %d for images over %d pixels\n"
+           "  -b <ms>        Time budget per image for outline and mesh stages, parts not done in time fall back to\n"
+           "                 boxes / simpler triangulation (not cached), default none\n"
+           "  -n             Smooth vertex normals\n"
+           "  -a             Allow sloppy simplification once levels stall (more reduction, collapses across creases / rims)\n"
+           "  -s             Silent, only print errors\n"
+           "  -c <dir>       Cache outlines / meshes in directory, unchanged images and settings skip extrusion\n"
+           "  -C <mb>        Cache size limit in megabytes, least recently used entries are removed, default %d\n"
+           "  -T <file>      Write stage timings / counters as Chrome trace JSON (build with EXTRUDE_INSTRUMENT)\n"
+           "  -h             Show this help\n",
+           c_extrude_quality, c_level_count, static_cast<double>(c_outline_detail), c_tile_size, c_tile_threshold, c_cache_megabytes);
+}
+
+// Returns false if command line can't be used
+static bool parseArguments(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg.size() < 2 || arg[0] != '-') { options.inputs.push_back(arg); continue; }
+
+        if      (arg == "-h" || arg == "--help")   { printUsage(); exit(0); }
+        else if (arg == "-n")                       { options.smooth_normals = true; }
+        else if (arg == "-a")                       { options.allow_sloppy =   true; }
+        else if (arg == "-s")                       { options.quiet = true; }
+        else if (has_value == false)                { fprintf(stderr, "Missing value for %s\n", arg.c_str()); return false; }
+        else if (arg == "-o")                       { options.output_dir =      argv[++i]; }
+        else if (arg == "-j")                       { options.jobs =            atoi(argv[++i]); }
+        else if (arg == "-q")                       { options.quality =         atoi(argv[++i]); }
+        else if (arg == "-d")                       { options.depth =           static_cast<float>(atof(argv[++i])); }
+        else if (arg == "-l")                       { options.levels =          atoi(argv[++i]); }
+        else if (arg == "-r")                       { options.triangle_ratio =  static_cast<float>(atof(argv[++i])); }
+        else if (arg == "-e")                       { options.target_error =    static_cast<float>(atof(argv[++i])); }
+        else if (arg == "-t")                       { options.outline_detail =  static_cast<float>(atof(argv[++i])); }
+        else if (arg == "-T")                       { options.trace_path =      argv[++i]; }
+        else if (arg == "-g")                       { options.tile_size =       atoi(argv[++i]); }
+        else if (arg == "-c")                       { options.cache_dir =       argv[++i]; }
+        else if (arg == "-C")                       { options.cache_mb =        atoi(argv[++i]); }
+        else if (arg == "-b")                       { options.budget_ms =       atof(argv[++i]); }
+        else if (arg == "-p") {
+            std::string profile = lowerCase(argv[++i]);
+            if      (profile == "flat")     options.profile = Side_Profile::Flat;
+            else if (profile == "bevel")    options.profile = Side_Profile::Bevel;
+            else if (profile == "round")    options.profile = Side_Profile::Round;
+            else { fprintf(stderr, "Unknown profile '%s'\n", profile.c_str()); return false; }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.inputs.size() == 0)                                 { fprintf(stderr, "No input images\n");                     return false; }
+    if (options.jobs < 1)                                           { fprintf(stderr, "-j must be at least 1\n");               return false; }
+    if (options.quality < 1)                                        { fprintf(stderr, "-q must be at least 1\n");               return false; }
+    if (options.levels < 1)                                         { fprintf(stderr, "-l must be at least 1\n");               return false; }
+    if (options.tile_size < -1)                                     { fprintf(stderr, "-g must be 0 or more\n");                return false; }
+    if (options.depth <= 0.f)                                       { fprintf(stderr, "-d must be greater than 0\n");           return false; }
+    if (options.triangle_ratio <= 0.f || options.triangle_ratio >= 1.f) { fprintf(stderr, "-r must be between 0 and 1\n");     return false; }
+    if (options.cache_mb < 1)                                       { fprintf(stderr, "-C must be at least 1\n");               return false; }
+    if (options.budget_ms < 0.0)                                    { fprintf(stderr, "-b must be 0 or more\n");                return false; }
+    if (options.cache_dir.size() > 0 && isDirectory(options.cache_dir) == false) {
+        fprintf(stderr, "Cache directory '%s' does not exist\n", options.cache_dir.c_str());
+        return false;
+    }
+    if (options.output_dir.size() > 0 && isDirectory(options.output_dir) == false) {
+        fprintf(stderr, "Output directory '%s' does not exist\n", options.output_dir.c_str());
+        return false;
+    }
+    if (options.trace_path.size() > 0 && c_instrument_enabled == false) {
+        fprintf(stderr, "-T needs a build with EXTRUDE_INSTRUMENT defined\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (parseArguments(argc, argv, options) == false) {
+        fprintf(stderr, "Use -h for help\n");
+        return 2;
+    }
+
+    std::vector<std::string> files = expandInputs(options.inputs);
+    if (files.size() == 0) {
+        fprintf(stderr, "No images found\n");
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Dr::InstrumentReset(options.trace_path.size() > 0);
+    size_t failed = runPipeline(files, options);
+    double total_ms = elapsedMs(start);
+
+    if (options.quiet == false) {
+        printf("%zu files, %zu failed, %d workers per stage, %.1f ms\n", files.size(), failed, options.jobs, total_ms);
+    }
+    if (options.trace_path.size() > 0 && Dr::WriteTraceEvents(options.trace_path) == false) {
+        fprintf(stderr, "Could not write %s\n", options.trace_path.c_str());
+        return 1;
+    }
+    return (failed > 0) ? 1 : 0;
+}
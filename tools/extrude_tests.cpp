@@ -0,0 +1,697 @@
+//
+// Description:     3D Extrusion
+// Author:          Stephens Nunnally and Scidian Software
+// License:         Distributed under the MIT License
+// Source(s):       https://github.com/stevinz/extrude
+//
+// Copyright (c) 2021 Stephens Nunnally and Scidian Software
+//
+//
+//  File:
+//      Correctness checks of buffer moves, tiled outlining, region updates, budgets, mesh adjacency, meshlets, mesh packing, mesh files and the extrude cache, registered with CTest
+//
+//  Usage:
+//      extrude_tests [moves | tiling | updates | budgets | adjacency | meshlets | pack | meshfile | cache]      (runs every check when no name is given)
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #include <sys/utime.h>
+#else
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+#include "../src/budget.h"
+#include "../src/compare.h"
+#include "../src/extrude_cache.h"
+#include "../src/imaging.h"
+#include "../src/mesh.h"
+#include "../src/mesh_adjacency.h"
+#include "../src/types/bitmap.h"
+#include "../src/types/color.h"
+#include "../src/types/image.h"
+#include "../src/types/rect.h"
+#include "alloc_counter.h"
+
+
+//####################################################################################
+//##    Move Checks
+//##        Moving bitmaps, images and meshes must hand buffers over without allocating, checked with the counters of alloc_counter.h
+//####################################################################################
+static size_t countAllocated(const std::function<void()> &step) {
+    size_t allocated = g_allocated;
+    step();
+    return g_allocated - allocated;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkMoves() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, size_t allocated, size_t limit) {
+        if (allocated <= limit) return;
+        printf("Move check failed: %s allocated %zu bytes (limit %zu)\n", name, allocated, limit);
+        failed++;
+    };
+
+    DrBitmap source = Dr::GenerateStressBitmap(Stress_Pattern::Blob, 128);
+    size_t   pixel_bytes = source.data.size();
+
+    DrBitmap moved;
+    expect("DrBitmap move constructor", countAllocated([&]() { DrBitmap bitmap(std::move(source)); moved = std::move(bitmap); }), 0);
+    expect("DrImage from moved DrBitmap", countAllocated([&]() { DrImage image("moved", std::move(moved), 1.f, false); }), pixel_bytes / 4);
+    DrBitmap viewed = Dr::GenerateStressBitmap(Stress_Pattern::Blob, 128);
+    expect("DrImage from DrBitmapView",   countAllocated([&]() { DrImage image("viewed", DrBitmapView(viewed), 1.f, false); }), pixel_bytes / 4);
+
+    DrImage image("outlined", Dr::GenerateStressBitmap(Stress_Pattern::Rings, 128), 1.f);
+    expect("DrImage move", countAllocated([&]() { DrImage other(std::move(image)); image = std::move(other); }), 0);
+
+    std::vector<DrBitmap> bitmaps;
+    for (int i = 0; i < 8; i++) {
+        DrBitmap bitmap(64, 64);
+        expect("std::vector<DrBitmap> growth", countAllocated([&]() { bitmaps.push_back(std::move(bitmap)); }), sizeof(DrBitmap) * 16);
+    }
+
+    DrMesh mesh;
+    for (const auto &polygon : image.m_poly_list) mesh.extrudeFacePolygon(polygon, 128, 128, { 1.f, -1.f }, { 0.f, 0.f });
+    expect("DrMesh move", countAllocated([&]() { DrMesh other(std::move(mesh)); mesh = std::move(other); }), 0);
+    std::vector<DrMeshLevel> levels;
+    expect("buildLevelsOfDetail level 0", countAllocated([&]() { levels = mesh.buildLevelsOfDetail(1); }),
+           mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int) + sizeof(DrMeshLevel) * 2);
+    return failed;
+}
+
+
+//####################################################################################
+//##    Tiling Checks
+//##        Tiled outlines (DrImage::outlinePointsTiled()) must match whole image outlines, including tiles smaller
+//##        than objects and objects touching image edges
+//####################################################################################
+static bool samePoints(const std::vector<DrPointF> &points1, const std::vector<DrPointF> &points2) {
+    if (points1.size() != points2.size()) return false;
+    for (size_t p = 0; p < points1.size(); p++) {
+        if (points1[p].x != points2[p].x || points1[p].y != points2[p].y) return false;
+    }
+    return true;
+}
+
+static bool sameOutlines(const DrImage &image1, const DrImage &image2) {
+    if (image1.m_poly_list.size() != image2.m_poly_list.size()) return false;
+    for (size_t i = 0; i < image1.m_poly_list.size(); i++) {
+        if (samePoints(image1.m_poly_list[i], image2.m_poly_list[i]) == false) return false;
+        if (image1.m_hole_list[i].size() != image2.m_hole_list[i].size()) return false;
+        for (size_t h = 0; h < image1.m_hole_list[i].size(); h++) {
+            if (samePoints(image1.m_hole_list[i][h], image2.m_hole_list[i][h]) == false) return false;
+        }
+    }
+    return true;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkTiling() {
+    int failed = 0;
+    const Stress_Pattern patterns[] = { Stress_Pattern::Specks, Stress_Pattern::Blob, Stress_Pattern::Rings,
+                                        Stress_Pattern::Coastline, Stress_Pattern::Checkerboard, Stress_Pattern::Noise };
+    for (auto pattern : patterns) {
+        DrBitmap bitmap = Dr::GenerateStressBitmap(pattern, 61);
+        for (int y = 0; y < bitmap.height; y++) bitmap.setPixel(bitmap.width - 1, y, Dr::red);      // Object along edges
+        DrImage whole("whole", bitmap, 0.25f);
+        for (int tile_size : { 1, 7, 32 }) {
+            DrImage tiled("tiled", bitmap, 0.25f, true, tile_size);
+            if (sameOutlines(whole, tiled)) continue;
+            printf("Tiling check failed: pattern %d, tile size %d\n", static_cast<int>(pattern), tile_size);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+
+//####################################################################################
+//##    Update Checks
+//##        After random paint / erase strokes, DrImage::updateRegion() outlines must match outlining edited image
+//##        from scratch, and meshes kept by DrMesh::reuseObjectMeshes() must match rebuilt ones
+//####################################################################################
+static bool sameMeshes(const DrMesh &mesh1, const DrMesh &mesh2) {
+    if (mesh1.indices != mesh2.indices || mesh1.vertices.size() != mesh2.vertices.size()) return false;
+    for (size_t v = 0; v < mesh1.vertices.size(); v++) {
+        if (Dr::IsCloseTo(mesh1.vertices[v].px, mesh2.vertices[v].px, 0.0001f) == false) return false;
+        if (Dr::IsCloseTo(mesh1.vertices[v].py, mesh2.vertices[v].py, 0.0001f) == false) return false;
+        if (Dr::IsCloseTo(mesh1.vertices[v].pz, mesh2.vertices[v].pz, 0.0001f) == false) return false;
+    }
+    return true;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkUpdates() {
+    int failed = 0;
+    unsigned int random = 12345;
+    auto next = [&random](int range) { random = random * 1103515245u + 12345u; return static_cast<int>((random >> 16) % range); };
+    const Stress_Pattern patterns[] = { Stress_Pattern::Specks, Stress_Pattern::Blob, Stress_Pattern::Rings,
+                                        Stress_Pattern::Coastline, Stress_Pattern::Checkerboard, Stress_Pattern::Noise };
+    for (auto pattern : patterns) {
+        DrBitmap bitmap = Dr::GenerateStressBitmap(pattern, 61);
+        DrImage  image("updated", bitmap, 0.25f, true, 0, true);
+        std::vector<DrMesh> meshes(image.m_poly_list.size());
+        for (int object = 0; object < static_cast<int>(meshes.size()); object++) meshes[object].extrudeObjectFromPolygon(&image, object, 1, 8.f);
+
+        for (int stroke = 0; stroke < 40; stroke++) {
+            DrRect dirty(next(66) - 3, next(66) - 3, next(12) + 1, next(12) + 1);                   // Some strokes hang over edges
+            int    kind = next(4);                                                                  // Erase, paint, noise, fill whole image
+            if (kind == 3 && next(4) == 0) dirty = bitmap.rect();
+            for (int x = dirty.left(); x <= dirty.right(); x++) {
+                for (int y = dirty.top(); y <= dirty.bottom(); y++) {
+                    if (x < 0 || y < 0 || x >= bitmap.width || y >= bitmap.height) continue;
+                    bool opaque = (kind == 1 || kind == 3) || (kind == 2 && next(2) == 0);
+                    bitmap.setPixel(x, y, opaque ? Dr::red : Dr::transparent);
+                }
+            }
+            std::vector<int> previous = image.updateRegion(bitmap, dirty, 0.25f);
+            for (int object : DrMesh::reuseObjectMeshes(previous, meshes)) meshes[object].extrudeObjectFromPolygon(&image, object, 1, 8.f);
+
+            DrImage full("full", bitmap, 0.25f);
+            bool    same = sameOutlines(image, full) && previous.size() == full.m_poly_list.size();
+            for (int object = 0; same && object < static_cast<int>(meshes.size()); object++) {
+                DrMesh mesh;
+                mesh.extrudeObjectFromPolygon(&full, object, 1, 8.f);
+                same = sameMeshes(meshes[object], mesh);
+            }
+            if (same) continue;
+            printf("Update check failed: pattern %d, stroke %d\n", static_cast<int>(pattern), stroke);
+            failed++;
+            break;
+        }
+    }
+    return failed;
+}
+
+
+//####################################################################################
+//##    Budget Checks
+//##        Out of budget outlining must give a simple box (and updateRegion() must recover once budget is lifted),
+//##        out of budget triangulation must still give a mesh, and a budget that never runs out must change nothing
+//####################################################################################
+// Returns number of failed checks, each failure is printed
+static int checkBudgets() {
+    int failed = 0;
+    const Stress_Pattern patterns[] = { Stress_Pattern::Specks, Stress_Pattern::Blob, Stress_Pattern::Rings,
+                                        Stress_Pattern::Coastline, Stress_Pattern::Checkerboard, Stress_Pattern::Noise };
+    for (auto pattern : patterns) {
+        DrBitmap bitmap = Dr::GenerateStressBitmap(pattern, 61);
+        DrImage  whole("whole", bitmap, 0.25f);
+
+        // Budget that never runs out
+        DrBudget unlimited;
+        {
+            DrBudgetScope scope(&unlimited);
+            DrImage image("unlimited", bitmap, 0.25f);
+            if (sameOutlines(whole, image) == false || image.outlineCanceled() || unlimited.expired_in != Budget_Stage::None ||
+                unlimited.objects_traced != static_cast<int>(whole.m_poly_list.size())) {
+                printf("Budget check failed: pattern %d, unlimited budget changed outlines\n", static_cast<int>(pattern));
+                failed++;
+            }
+        }
+
+        // Cancelled before outlining, whole and tiled
+        for (int tile_size : { 0, 7 }) {
+            DrBudget cancelled;
+            cancelled.cancel();
+            DrBudgetScope scope(&cancelled);
+            DrImage image("cancelled", bitmap, 0.25f, true, tile_size);
+            if (image.outlineCanceled() == false || image.m_poly_list.size() != 1 || cancelled.expired_in != Budget_Stage::Finding_Objects) {
+                printf("Budget check failed: pattern %d, tile size %d, cancelled outline isn't a box\n", static_cast<int>(pattern), tile_size);
+                failed++;
+            }
+        }
+
+        // Cancelled update, then update without budget has to outline in full again
+        DrImage updated("updated", bitmap, 0.25f, true, 0, true);
+        std::vector<int> previous;
+        {
+            DrBudget cancelled;
+            cancelled.cancel();
+            DrBudgetScope scope(&cancelled);
+            previous = updated.updateRegion(bitmap, DrRect(20, 20, 8, 8), 0.25f);
+        }
+        bool boxed = updated.outlineCanceled() && previous.size() == 1 && previous[0] == -1;
+        updated.updateRegion(bitmap, DrRect(20, 20, 8, 8), 0.25f);
+        if (boxed == false || sameOutlines(whole, updated) == false) {
+            printf("Budget check failed: pattern %d, cancelled update didn't recover\n", static_cast<int>(pattern));
+            failed++;
+        }
+
+        // Cancelled triangulation falls back to monotone, every object still gets a mesh
+        DrBudget cancelled;
+        cancelled.cancel();
+        DrBudgetScope scope(&cancelled);
+        int empty = 0;
+        for (int object = 0; object < static_cast<int>(whole.m_poly_list.size()); object++) {
+            DrMesh mesh;
+            mesh.extrudeObjectFromPolygon(&whole, object, 1, 8.f);
+            if (mesh.indices.size() == 0) empty++;
+        }
+        if (empty > 0 || cancelled.faces_fallback != static_cast<int>(whole.m_poly_list.size()) || cancelled.faces_triangulated != 0) {
+            printf("Budget check failed: pattern %d, %d of %zu cancelled meshes empty\n", static_cast<int>(pattern), empty, whole.m_poly_list.size());
+            failed++;
+        }
+    }
+    return failed;
+}
+
+
+//####################################################################################
+//##    Adjacency Checks
+//##        DrMeshAdjacency counts of small meshes with known topology (closed, open, non-manifold edge / vertex,
+//##        flipped winding, uv seams), and extruded objects must come out watertight
+//####################################################################################
+static DrMesh makeMesh(const std::vector<DrVec3> &positions, const std::vector<unsigned int> &indices) {
+    DrMesh mesh;
+    for (const auto &position : positions) {
+        mesh.vertices.push_back(Vertex::createVertex(position, DrVec3(0.f, 0.f, 1.f), DrVec3(0.f, 0.f, 0.f), DrVec3(0.f, 0.f, 0.f)));
+    }
+    mesh.indices = indices;
+    return mesh;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkAdjacency() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, bool passed) {
+        if (passed) return;
+        printf("Adjacency check failed: %s\n", name);
+        failed++;
+    };
+
+    // Tetrahedron, closed
+    std::vector<DrVec3> corners = { DrVec3(0.f, 0.f, 0.f), DrVec3(1.f, 0.f, 0.f), DrVec3(0.f, 1.f, 0.f), DrVec3(0.f, 0.f, 1.f) };
+    std::vector<unsigned int> faces = { 0, 2, 1,   0, 1, 3,   0, 3, 2,   1, 2, 3 };
+    DrMeshAdjacency tetrahedron(makeMesh(corners, faces));
+    bool twins_match = true;
+    for (unsigned int h = 0; h < tetrahedron.halfEdgeCount(); h++) {
+        unsigned int twin = tetrahedron.twin(h);
+        if (twin == c_no_half_edge || tetrahedron.twin(twin) != h || tetrahedron.origin(twin) != tetrahedron.target(h)) twins_match = false;
+    }
+    expect("tetrahedron is closed",  tetrahedron.isClosed() && tetrahedron.edgeCount() == 6 && tetrahedron.vertexCount() == 4);
+    expect("tetrahedron twins",      twins_match);
+    expect("tetrahedron vertex fan", tetrahedron.outgoingCount(0) == 3 && tetrahedron.rotate(tetrahedron.rotate(tetrahedron.rotate(tetrahedron.outgoing(0, 0)))) == tetrahedron.outgoing(0, 0));
+
+    // Tetrahedron with split vertices per face (like uv seams), closed once welded
+    std::vector<DrVec3> split;
+    std::vector<unsigned int> split_faces;
+    for (auto corner : faces) { split_faces.push_back(static_cast<unsigned int>(split.size())); split.push_back(corners[corner]); }
+    DrMesh split_mesh = makeMesh(split, split_faces);
+    expect("split tetrahedron welds closed",  DrMeshAdjacency(split_mesh).isClosed());
+    expect("split tetrahedron without weld",  DrMeshAdjacency(split_mesh, 0.f).boundaryEdgeCount() == 12);
+
+    // Quad, manifold with boundary
+    std::vector<DrVec3> square = { DrVec3(0.f, 0.f, 0.f), DrVec3(1.f, 0.f, 0.f), DrVec3(1.f, 1.f, 0.f), DrVec3(0.f, 1.f, 0.f), DrVec3(0.5f, 0.5f, 1.f) };
+    DrMeshAdjacency quad(makeMesh(square, { 0, 1, 2,   0, 2, 3 }));
+    expect("quad is open manifold",  quad.isManifold() && quad.isClosed() == false && quad.boundaryEdgeCount() == 4 && quad.edgeCount() == 5);
+    expect("quad neighbors",         quad.neighbor(0, 2) == 1 && quad.neighbor(1, 0) == 0 && quad.neighbor(0, 0) == c_no_half_edge);
+
+    // Three triangles on one edge, non-manifold edge
+    DrMeshAdjacency fin(makeMesh(square, { 0, 1, 2,   1, 0, 3,   0, 1, 4 }));
+    expect("fin has non-manifold edge", fin.isManifold() == false && fin.nonManifoldEdgeCount() == 1);
+
+    // Two triangles touching at a corner, non-manifold vertex
+    std::vector<DrVec3> bowtie_points = { DrVec3(0.f, 0.f, 0.f), DrVec3(1.f, 0.f, 0.f), DrVec3(1.f, 1.f, 0.f), DrVec3(-1.f, 0.f, 0.f), DrVec3(-1.f, -1.f, 0.f) };
+    DrMeshAdjacency bowtie(makeMesh(bowtie_points, { 0, 1, 2,   0, 3, 4 }));
+    expect("bowtie has non-manifold vertex", bowtie.isManifold() == false && bowtie.nonManifoldVertexCount() == 1 && bowtie.nonManifoldEdgeCount() == 0);
+
+    // Quad with second triangle flipped
+    DrMeshAdjacency flipped(makeMesh(square, { 0, 1, 2,   0, 3, 2 }));
+    expect("flipped quad is inconsistent", flipped.isManifold() == false && flipped.inconsistentEdgeCount() == 1);
+
+    // Degenerate triangle
+    DrMeshAdjacency degenerate(makeMesh(square, { 0, 1, 2,   0, 2, 2 }));
+    expect("degenerate triangle", degenerate.isManifold() == false && degenerate.degenerateTriangleCount() == 1);
+
+    // Extruded objects, walls are nudged 1 / image size off caps so weld has to cover that
+    const Side_Profile profiles[] = { Side_Profile::Flat, Side_Profile::Bevel, Side_Profile::Round };
+    for (auto pattern : { Stress_Pattern::Blob, Stress_Pattern::Coastline }) {
+        DrImage image("extruded", Dr::GenerateStressBitmap(pattern, 128), 0.25f);
+        for (auto profile : profiles) {
+            DrMesh mesh;
+            mesh.extrudeObjectFromPolygon(&image, 0, 8, 16.f, profile, 2.f);
+            DrMeshAdjacency adjacency(mesh, 1.5f / 128.f);
+            if (adjacency.isClosed()) continue;
+            printf("Adjacency check failed: pattern %d, profile %d extrusion isn't closed\n", static_cast<int>(pattern), static_cast<int>(profile));
+            failed++;
+        }
+    }
+    return failed;
+}
+
+
+//####################################################################################
+//##    Pack Checks
+//##        Without long indices a mesh past 16 bit range is split into batches, rebuilt triangles must match the source
+//####################################################################################
+// Flat grid of size x size vertices, two triangles per cell
+static DrMesh makeGrid(unsigned int size) {
+    std::vector<DrVec3> points;
+    std::vector<unsigned int> faces;
+    for (unsigned int y = 0; y < size; y++) {
+        for (unsigned int x = 0; x < size; x++) points.push_back(DrVec3(static_cast<float>(x), static_cast<float>(y), 0.f));
+    }
+    for (unsigned int y = 0; y < size - 1; y++) {
+        for (unsigned int x = 0; x < size - 1; x++) {
+            unsigned int corner = y * size + x;
+            faces.insert(faces.end(), { corner, corner + 1, corner + size + 1,   corner, corner + size + 1, corner + size });
+        }
+    }
+    return makeMesh(points, faces);
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkPack() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, bool passed) {
+        if (passed) return;
+        printf("Pack check failed: %s\n", name);
+        failed++;
+    };
+
+    std::vector<DrMesh> meshes = { makeGrid(16), makeGrid(301), makeGrid(8) };
+    expect("grid needs 32 bit indices", meshes[1].vertices.size() > 65535);
+    DrMeshPack pack;
+    pack.pack(meshes, false);
+    expect("no 32 bit indices", pack.long_indices.empty());
+
+    // Triangles of batches in order, as positions
+    std::vector<DrVec3> packed;
+    bool batches_fit = true;
+    for (const auto &batch : pack.batches) {
+        if (batch.long_indices || batch.vertex_count >= 65536 || batch.base_vertex + batch.vertex_count > pack.vertices.size()) batches_fit = false;
+        for (unsigned int i = batch.first_index; i < batch.first_index + batch.index_count && i < pack.short_indices.size(); i++) {
+            unsigned int index = pack.short_indices[i];
+            if (index >= batch.vertex_count) { batches_fit = false; continue; }
+            const Vertex &vertex = pack.vertices[batch.base_vertex + index];
+            packed.push_back(DrVec3(vertex.px, vertex.py, vertex.pz));
+        }
+    }
+    expect("batches stay in 16 bit range", batches_fit && pack.batches.size() > 2);
+
+    std::vector<DrVec3> source;
+    for (const auto &mesh : meshes) {
+        for (auto index : mesh.indices) source.push_back(DrVec3(mesh.vertices[index].px, mesh.vertices[index].py, mesh.vertices[index].pz));
+    }
+    bool triangles_match = (packed.size() == source.size());
+    for (size_t i = 0; triangles_match && i < source.size(); i++) {
+        triangles_match = (packed[i].x == source[i].x && packed[i].y == source[i].y && packed[i].z == source[i].z);
+    }
+    expect("triangles match source", triangles_match);
+    return failed;
+}
+
+
+//####################################################################################
+//##    Mesh File Checks
+//##        Encoded meshes decode to the same triangles (index codec may rotate each one), damaged data never
+//##        decodes to out of range indices and leaves no partial meshes behind
+//####################################################################################
+static bool sameVertex(const Vertex &a, const Vertex &b) {
+    return memcmp(&a, &b, sizeof(Vertex)) == 0;
+}
+
+// True when triangles match in order, each allowed to start at any of its corners
+static bool sameTriangles(const DrMesh &source, const DrMesh &decoded) {
+    if (source.indices.size() != decoded.indices.size() || source.vertices.size() != decoded.vertices.size()) return false;
+    for (size_t t = 0; t < source.indices.size(); t += 3) {
+        bool rotation_found = false;
+        for (size_t rotate = 0; rotate < 3 && rotation_found == false; rotate++) {
+            rotation_found = true;
+            for (size_t corner = 0; corner < 3; corner++) {
+                const Vertex &a = source.vertices[source.indices[t + corner]];
+                const Vertex &b = decoded.vertices[decoded.indices[t + (corner + rotate) % 3]];
+                rotation_found = rotation_found && sameVertex(a, b);
+            }
+        }
+        if (rotation_found == false) return false;
+    }
+    return true;
+}
+
+// Decodes into a list already holding one mesh, true when a failed decode left it alone and a successful one is in range
+static bool decodesSafely(const std::vector<unsigned char> &file_data, size_t file_size, bool &decoded) {
+    std::vector<DrMesh> meshes(1);
+    decoded = DrMesh::decodeMeshes(file_data.data(), file_size, meshes);
+    if (decoded == false) return (meshes.size() == 1);
+    for (size_t m = 1; m < meshes.size(); m++) {
+        for (auto index : meshes[m].indices) {
+            if (index >= meshes[m].vertices.size()) return false;
+        }
+    }
+    return true;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkMeshFile() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, bool passed) {
+        if (passed) return;
+        printf("Mesh file check failed: %s\n", name);
+        failed++;
+    };
+
+    // Small meshes keep the flips below cheap, third mesh is left empty
+    DrImage image("mesh_file", Dr::GenerateStressBitmap(Stress_Pattern::Blob, 32), 0.25f);
+    std::vector<DrMesh> meshes(3);
+    meshes[0].extrudeObjectFromPolygon(&image, 0, 2, 8.f, Side_Profile::Bevel, 2.f);
+    meshes[1] = makeGrid(6);
+    std::vector<unsigned char> file_data;
+    DrMesh::encodeMeshes(meshes, file_data);
+
+    // ***** Round trip
+    std::vector<DrMesh> decoded;
+    expect("decodes",                   DrMesh::decodeMeshes(file_data.data(), file_data.size(), decoded) && decoded.size() == meshes.size());
+    bool triangles_match = (decoded.size() == meshes.size());
+    for (size_t m = 0; triangles_match && m < meshes.size(); m++) triangles_match = sameTriangles(meshes[m], decoded[m]);
+    expect("triangles match",           triangles_match);
+
+    // ***** Truncated, only trailing alignment padding (up to 3 bytes) may be cut
+    bool truncated_safe = true;
+    for (size_t size = 0; size < file_data.size(); size++) {
+        bool truncated_decoded;
+        if (decodesSafely(file_data, size, truncated_decoded) == false || (truncated_decoded && size + 3 < file_data.size())) truncated_safe = false;
+    }
+    expect("truncated data",            truncated_safe);
+
+    // ***** One bit flipped in every byte (bit cycles with position), header / table flips mostly fail, stream flips
+    //       may decode to other but valid meshes
+    bool flipped_safe = true;
+    std::vector<unsigned char> flipped = file_data;
+    for (size_t byte = 0; byte < flipped.size(); byte++) {
+        bool flipped_decoded;
+        unsigned char bit = static_cast<unsigned char>(1 << (byte % 8));
+        flipped[byte] ^= bit;
+        if (decodesSafely(flipped, flipped.size(), flipped_decoded) == false) flipped_safe = false;
+        flipped[byte] ^= bit;
+    }
+    expect("bit flipped data",          flipped_safe);
+    return failed;
+}
+
+
+//####################################################################################
+//##    Cache Checks
+//##        Entries round trip through a temporary directory, damaged files are misses, eviction removes least recently used
+//####################################################################################
+static std::string makeTempDirectory() {
+#if defined(_WIN32)
+    char *name = _tempnam(nullptr, "extc");
+    std::string directory = (name != nullptr) ? name : "";
+    free(name);
+    if (directory.size() == 0 || _mkdir(directory.c_str()) != 0) return "";
+    return directory;
+#else
+    char name[] = "/tmp/extrude_tests_XXXXXX";
+    return (mkdtemp(name) != nullptr) ? name : "";
+#endif
+}
+
+static void setFileTime(const std::string &path, time_t time) {
+#if defined(_WIN32)
+    struct _utimbuf times { time, time };
+    _utime(path.c_str(), &times);
+#else
+    struct utimbuf times { time, time };
+    utime(path.c_str(), &times);
+#endif
+}
+
+static bool fileExists(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) return false;
+    fclose(file);
+    return true;
+}
+
+static bool writeFile(const std::string &path, const std::vector<unsigned char> &data) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool written = (fwrite(data.data(), 1, data.size(), file) == data.size());
+    return (fclose(file) == 0) && written;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkCache() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, bool passed) {
+        if (passed) return;
+        printf("Cache check failed: %s\n", name);
+        failed++;
+    };
+
+    std::string directory = makeTempDirectory();
+    if (directory.size() == 0) { printf("Cache check failed: no temporary directory\n"); return 1; }
+
+    // Entry with an outline, a hole and one level of mesh file data
+    DrCacheEntry entry;
+    entry.poly_list = { { DrPointF(0, 0), DrPointF(10, 0), DrPointF(10, 10), DrPointF(0, 10) } };
+    entry.hole_list = { { { DrPointF(2, 2), DrPointF(2, 4), DrPointF(4, 4) } } };
+    entry.level_files.resize(1);
+    DrMesh::encodeMeshes({ makeGrid(4) }, entry.level_files[0]);
+    auto matches = [&entry](const DrCacheEntry &loaded) {
+        return loaded.poly_list == entry.poly_list && loaded.hole_list == entry.hole_list && loaded.level_files == entry.level_files;
+    };
+
+    // ***** Round trip
+    DrExtrudeCache cache(directory, 64 << 20);
+    DrCacheEntry loaded;
+    expect("missing entry is a miss",   cache.load(1, loaded) == false);
+    expect("store",                     cache.store(1, entry));
+    expect("round trip",                cache.load(1, loaded) && matches(loaded));
+    expect("other key is a miss",       cache.load(2, loaded) == false);
+
+    // ***** Damaged files
+    std::vector<unsigned char> file_data;
+    DrExtrudeCache::encodeEntry(3, entry, file_data);
+    std::vector<unsigned char> flipped = file_data;
+    flipped[flipped.size() / 2] ^= 0x10;
+    expect("bit flip is a miss",        writeFile(cache.path(3), flipped) && cache.load(3, loaded) == false);
+    std::vector<unsigned char> truncated(file_data.begin(), file_data.end() - 5);
+    expect("truncated is a miss",       writeFile(cache.path(3), truncated) && cache.load(3, loaded) == false);
+    expect("empty is a miss",           writeFile(cache.path(3), { }) && cache.load(3, loaded) == false);
+
+    // Object / level counts (after magic, version, key, payload size and hash) aren't hashed, huge ones must fail before allocating
+    const size_t object_count_at = 32, level_count_at = 36;
+    for (size_t at : { object_count_at, level_count_at }) {
+        std::vector<unsigned char> forged = file_data;
+        uint32_t count = 0xffffffff;
+        memcpy(&forged[at], &count, sizeof(count));
+        size_t allocated = g_allocated;
+        bool decoded = DrExtrudeCache::decodeEntry(3, forged.data(), forged.size(), loaded);
+        expect("forged header count is a miss", decoded == false && (g_allocated - allocated) < (1 << 20));
+    }
+    remove(cache.path(3).c_str());
+
+    // ***** Least recently used eviction, entries 4, 5, 6 stored oldest first, then 4 is loaded
+    time_t now = time(nullptr);
+    for (uint64_t key = 4; key <= 6; key++) {
+        cache.store(key, entry);
+        setFileTime(cache.path(key), now - 1000 + static_cast<time_t>(key) * 100);
+    }
+    remove(cache.path(1).c_str());
+    cache.load(4, loaded);
+    DrExtrudeCache small_cache(directory, file_data.size() * 2);
+    small_cache.evict();
+    expect("least recently used evicted", fileExists(cache.path(4)) && fileExists(cache.path(5)) == false && fileExists(cache.path(6)));
+
+    // ***** Clean up, evicting to zero removes every entry
+    DrExtrudeCache(directory, 0).evict();
+#if defined(_WIN32)
+    _rmdir(directory.c_str());
+#else
+    rmdir(directory.c_str());
+#endif
+    return failed;
+}
+
+
+//####################################################################################
+//##    Meshlet Checks
+//##        Meshlets index into vertices, anything that rebuilds indices / vertices has to drop them
+//####################################################################################
+// True when every index visible from a few sides is a valid vertex index
+static bool visibleInRange(const DrMesh &mesh) {
+    std::vector<unsigned int> visible;
+    for (auto camera : { DrVec3(0.f, 0.f, 100.f), DrVec3(0.f, 0.f, -100.f), DrVec3(100.f, 0.f, 0.f) }) {
+        mesh.visibleIndices(camera, visible);
+    }
+    for (auto index : visible) {
+        if (index >= mesh.vertices.size()) return false;
+    }
+    return true;
+}
+
+// Returns number of failed checks, each failure is printed
+static int checkMeshlets() {
+    int failed = 0;
+    auto expect = [&failed](const char *name, bool passed) {
+        if (passed) return;
+        printf("Meshlet check failed: %s\n", name);
+        failed++;
+    };
+
+    DrImage image("meshlets", Dr::GenerateStressBitmap(Stress_Pattern::Blob, 128), 0.25f);
+    DrMesh mesh;
+    mesh.extrudeObjectFromPolygon(&image, 0, 8, 16.f, Side_Profile::Round, 2.f);
+    mesh.buildMeshlets();
+    expect("meshlets built",                mesh.meshlets.size() > 0 && visibleInRange(mesh));
+
+    mesh.generateNormals();
+    expect("generateNormals drops meshlets", mesh.meshlets.empty() && mesh.meshlet_vertices.empty() && mesh.meshlet_triangles.empty());
+    expect("visible after generateNormals",  visibleInRange(mesh));
+
+    mesh.buildMeshlets();
+    mesh.optimizeMesh();
+    expect("optimizeMesh drops meshlets",    mesh.meshlets.empty() && visibleInRange(mesh));
+
+    mesh.buildMeshlets();
+    mesh.smoothMesh();
+    expect("smoothMesh drops meshlets",      mesh.meshlets.empty() && visibleInRange(mesh));
+
+    mesh.buildMeshlets();
+    expect("meshlets rebuilt",               mesh.meshlets.size() > 0 && visibleInRange(mesh));
+    return failed;
+}
+
+
+//####################################################################################
+//##    Main
+//####################################################################################
+struct Check {
+    const char     *name;
+    int           (*run)();
+};
+
+int main(int argc, char **argv) {
+    const Check checks[] = { { "moves", checkMoves }, { "tiling", checkTiling }, { "updates", checkUpdates }, { "budgets", checkBudgets },
+                             { "adjacency", checkAdjacency }, { "meshlets", checkMeshlets },
+                             { "pack", checkPack }, { "meshfile", checkMeshFile },
+                             { "cache", checkCache } };
+
+    int  failed = 0;
+    bool found =  false;
+    for (const auto &check : checks) {
+        if (argc > 1 && strcmp(argv[1], check.name) != 0) continue;
+        found = true;
+        int check_failed = check.run();
+        printf("%-10s %s\n", check.name, (check_failed == 0) ? "passed" : "FAILED");
+        failed += check_failed;
+    }
+    if (found == false) {
+        printf("Unknown check: %s\n", argv[1]);
+        return 1;
+    }
+    return (failed > 0) ? 1 : 0;
+}